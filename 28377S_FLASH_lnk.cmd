@@ -0,0 +1,114 @@
+/*###########################################################################
+ FILE:   28377S_FLASH_lnk.cmd
+ TITLE:  Linker command file of the Flash build configuration
+############################################################################
+ Boots from flash bank 0 (boot mode "flash", codestart at BEGIN) without a
+ debugger. Code and constants stay in flash and run with the wait states,
+ prefetch and cache that InitFlash_Bank0 sets. The per-tick code (ramfuncs:
+ the control ISRs, SetPWMA/SetPWMB, the control laws, their Calc* helpers
+ and filters, and InitFlash) and IQmath are loaded in flash, and InitSysCtrl
+ copies them to RAMLS0-RAMLS3 before InitFlash_Bank0 runs, so the control
+ tick runs from zero wait state RAM as in the RAM build. The CLA build
+ copies Cla1Prog, .const_cla and CLA1mathTables in InitCla.
+ Used with F2837xS_Headers_nonBIOS.cmd; the project compiles with -D_FLASH.
+###########################################################################*/
+
+CLA_SCRATCHPAD_SIZE = 0x100;
+--undef_sym=__cla_scratchpad_end
+--undef_sym=__cla_scratchpad_start
+
+MEMORY
+{
+PAGE 0 :  /* Program Memory */
+   BEGIN           : origin = 0x080000, length = 0x000002
+   RAMM0           : origin = 0x000122, length = 0x0002DE
+   RAMLS0_3        : origin = 0x008000, length = 0x002000	/* ramfuncs, run */
+   RAMLS5          : origin = 0x00A800, length = 0x000800	/* Cla1Prog, run */
+   RESET           : origin = 0x3FFFC0, length = 0x000002
+   IQTABLES        : origin = 0x3FE000, length = 0x000B50	/* IQmath tables in boot ROM */
+   IQTABLES2       : origin = 0x3FEB50, length = 0x00008C
+   IQTABLES3       : origin = 0x3FEBDC, length = 0x0000AA
+
+   FLASHA          : origin = 0x080002, length = 0x001FFE	/* codestart */
+   FLASHB          : origin = 0x082000, length = 0x002000	/* Constants and initialisers */
+   FLASHC          : origin = 0x084000, length = 0x002000	/* ramfuncs, load */
+   FLASHD          : origin = 0x086000, length = 0x002000	/* CLA, load */
+   FLASHE          : origin = 0x088000, length = 0x008000	/* .text */
+   FLASHF          : origin = 0x090000, length = 0x008000
+   FLASHG          : origin = 0x098000, length = 0x008000
+   FLASHH          : origin = 0x0A0000, length = 0x008000
+   FLASHI          : origin = 0x0A8000, length = 0x008000
+   FLASHJ          : origin = 0x0B0000, length = 0x008000
+   FLASHK          : origin = 0x0B8000, length = 0x002000
+   FLASHL          : origin = 0x0BA000, length = 0x002000
+   FLASHM          : origin = 0x0BC000, length = 0x002000
+   FLASHN          : origin = 0x0BE000, length = 0x002000
+
+PAGE 1 :  /* Data Memory */
+   BOOT_RSVD       : origin = 0x000002, length = 0x000120	/* Boot ROM stack */
+   RAMM1           : origin = 0x000400, length = 0x000400
+   RAMD0_1         : origin = 0x00B000, length = 0x001000
+   RAMLS4          : origin = 0x00A000, length = 0x000800	/* CLA data */
+   RAMGS0_14       : origin = 0x00C000, length = 0x00F000	/* SVArray */
+   RAMGS15         : origin = 0x01B000, length = 0x001000
+   CLA1_MSGRAMLOW  : origin = 0x001480, length = 0x000080
+   CLA1_MSGRAMHIGH : origin = 0x001500, length = 0x000080
+}
+
+SECTIONS
+{
+   codestart        : > BEGIN,     PAGE = 0, ALIGN(4)
+   .text            : >> FLASHE | FLASHF | FLASHG, PAGE = 0, ALIGN(8)
+   .cinit           : > FLASHB,    PAGE = 0, ALIGN(8)
+   .pinit           : > FLASHB,    PAGE = 0, ALIGN(8)
+   .switch          : > FLASHB,    PAGE = 0, ALIGN(8)
+   .econst          : > FLASHB,    PAGE = 0, ALIGN(8)
+   .reset           : > RESET,     PAGE = 0, TYPE = DSECT	/* not used */
+
+   .stack           : > RAMM1,     PAGE = 1
+   .esysmem         : > RAMM1,     PAGE = 1
+   .ebss            : > RAMGS15,   PAGE = 1
+   IsrState         : > RAMGS15,   PAGE = 1, ALIGN(64)
+   AdcDma           : > RAMGS15,   PAGE = 1	/* DMA buffer: GS RAM, the DMA has no LS RAM access */
+   SVArray          : > RAMGS0_14, PAGE = 1
+   TrigTables       : > RAMD0_1,   PAGE = 1
+
+   ramfuncs         : { *(ramfuncs) *(IQmath) }
+                      LOAD = FLASHC,
+                      RUN = RAMLS0_3,
+                      LOAD_START(_RamfuncsLoadStart),
+                      LOAD_SIZE(_RamfuncsLoadSize),
+                      LOAD_END(_RamfuncsLoadEnd),
+                      RUN_START(_RamfuncsRunStart),
+                      RUN_SIZE(_RamfuncsRunSize),
+                      RUN_END(_RamfuncsRunEnd),
+                      PAGE = 0, ALIGN(8)
+
+   IQmathTables     : > IQTABLES,  PAGE = 0, TYPE = NOLOAD
+
+   /* CLA build */
+   Cla1Prog         : LOAD = FLASHD,
+                      RUN = RAMLS5,
+                      LOAD_START(_Cla1funcsLoadStart),
+                      LOAD_SIZE(_Cla1funcsLoadSize),
+                      RUN_START(_Cla1funcsRunStart),
+                      PAGE = 0, ALIGN(8)
+   .const_cla       : LOAD = FLASHD, PAGE = 0,
+                      RUN = RAMLS4, PAGE = 1,
+                      LOAD_START(_Cla1ConstLoadStart),
+                      LOAD_SIZE(_Cla1ConstLoadSize),
+                      RUN_START(_Cla1ConstRunStart),
+                      ALIGN(8)
+   CLA1mathTables   : LOAD = FLASHD, PAGE = 0,
+                      RUN = RAMLS4, PAGE = 1,
+                      LOAD_START(_CLA1mathTablesLoadStart),
+                      LOAD_SIZE(_CLA1mathTablesLoadSize),
+                      RUN_START(_CLA1mathTablesRunStart),
+                      ALIGN(8)
+   .bss_cla         : > RAMLS4,    PAGE = 1
+   CLAscratch       : { *.obj(CLAscratch)
+                        . += CLA_SCRATCHPAD_SIZE;
+                        *.obj(CLAscratch_end) } > RAMLS4, PAGE = 1
+   Cla1ToCpuMsgRAM  : > CLA1_MSGRAMLOW,  PAGE = 1
+   CpuToCla1MsgRAM  : > CLA1_MSGRAMHIGH, PAGE = 1
+}
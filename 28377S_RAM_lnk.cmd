@@ -0,0 +1,62 @@
+/*###########################################################################
+ FILE:   28377S_RAM_lnk.cmd
+ TITLE:  Linker command file of the Debug (RAM) build configuration
+############################################################################
+ Loads and runs everything from RAM through the debugger (boot mode "RAM",
+ codestart at BEGIN); nothing is copied at boot. Same memory map as the
+ RAM link the project used from controlSUITE: code in RAMM0, RAMLS0-2 and
+ RAMD0, data in RAMM1 and RAMLS5, the logs in RAMGS0-15. IQmath runs from
+ RAMLS3 with its tables in boot ROM, as in 28377S_FLASH_lnk.cmd.
+ The firmware's own sections go to the free part of RAMGS0-15: the DMA
+ can only reach GS RAM (AdcDma), IsrState needs a 64-word boundary, and
+ TrigTables does not fit in RAMD1 as it does in RAMD0_1 in the Flash build.
+ Used with F2837xS_Headers_nonBIOS.cmd.
+###########################################################################*/
+
+MEMORY
+{
+PAGE 0 :  /* Program Memory */
+   BEGIN           : origin = 0x000000, length = 0x000002
+   RAMM0           : origin = 0x000122, length = 0x0002DE
+   RAMLS0          : origin = 0x008000, length = 0x000800
+   RAMLS1_LS2      : origin = 0x008800, length = 0x001000
+   RAMLS3          : origin = 0x009800, length = 0x000800	/* IQmath */
+   RAMLS4          : origin = 0x00A000, length = 0x000800
+   RAMD0           : origin = 0x00B000, length = 0x000800
+   RESET           : origin = 0x3FFFC0, length = 0x000002
+   IQTABLES        : origin = 0x3FE000, length = 0x000B50	/* IQmath tables in boot ROM */
+   IQTABLES2       : origin = 0x3FEB50, length = 0x00008C
+   IQTABLES3       : origin = 0x3FEBDC, length = 0x0000AA
+
+PAGE 1 :  /* Data Memory */
+   BOOT_RSVD       : origin = 0x000002, length = 0x000120	/* Boot ROM stack */
+   RAMM1           : origin = 0x000400, length = 0x000400
+   RAMLS5          : origin = 0x00A800, length = 0x000800
+   RAMD1           : origin = 0x00B800, length = 0x000800
+   RAMGS0_GS15     : origin = 0x00C000, length = 0x010000	/* SVArray, DMA buffers */
+   CPU2TOCPU1RAM   : origin = 0x03F800, length = 0x000400
+   CPU1TOCPU2RAM   : origin = 0x03FC00, length = 0x000400
+}
+
+SECTIONS
+{
+   codestart        : > BEGIN,     PAGE = 0
+   ramfuncs         : > RAMM0,     PAGE = 0
+   .text            : >> RAMM0 | RAMLS0 | RAMLS1_LS2 | RAMD0, PAGE = 0
+   .cinit           : > RAMM0,     PAGE = 0
+   .pinit           : > RAMM0,     PAGE = 0
+   .switch          : > RAMM0,     PAGE = 0
+   .reset           : > RESET,     PAGE = 0, TYPE = DSECT	/* not used */
+
+   .stack           : > RAMM1,     PAGE = 1
+   .ebss            : > RAMLS5,    PAGE = 1
+   .econst          : > RAMLS5,    PAGE = 1
+   .esysmem         : > RAMLS5,    PAGE = 1
+   IsrState         : > RAMGS0_GS15, PAGE = 1, ALIGN(64)
+   SVArray          : > RAMGS0_GS15, PAGE = 1
+   TrigTables       : > RAMGS0_GS15, PAGE = 1	/* 2904 words, more than RAMD1 */
+   AdcDma           : > RAMGS0_GS15, PAGE = 1	/* DMA buffer: GS RAM, the DMA has no LS RAM access */
+
+   IQmath           : > RAMLS3,    PAGE = 0
+   IQmathTables     : > IQTABLES,  PAGE = 0, TYPE = NOLOAD
+}
@@ -0,0 +1,19 @@
+//###########################################################################
+// FILE:   CLAmath.h (host mock)
+// TITLE:  Host replacement for the CLA math library header
+//###########################################################################
+// The CLA tasks only take CLAsin/CLAcos, angle in radians. The target
+// library interpolates a table in CLA data RAM and is good to a few float
+// LSB; the host rounds the double sin/cos, as TrigSin/TrigCos do with
+// TRIG_RTS, so that the CLA and float laws agree to the bit.
+//###########################################################################
+
+#ifndef CLAMATH_H
+#define CLAMATH_H
+
+#include <math.h>
+
+#define CLAsin(A) ((float)sin(A))
+#define CLAcos(A) ((float)cos(A))
+
+#endif  // end of CLAMATH_H definition
@@ -0,0 +1,183 @@
+//###########################################################################
+// FILE:   F2837xS_Examples.h (host mock)
+// TITLE:  Host replacement for the F2837xS examples include files
+//###########################################################################
+// Constants and prototypes of the support library calls made by the
+// firmware. F2837xS_CpuTimers.c and F2837xS_PieCtrl.c are compiled as they
+// are; the calls that only configure clocks, pins, trims or the vector table
+// are recorded by hal_regs.c instead.
+//###########################################################################
+
+#ifndef F2837xS_EXAMPLES_H
+#define F2837xS_EXAMPLES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//---------------------------------------------------------------------------
+// CPU Timers (F2837xS_CpuTimers.h)
+//
+struct CPUTIMER_VARS {
+    volatile struct  CPUTIMER_REGS  *RegsAddr;
+    Uint32    InterruptCount;
+    float   CPUFreqInMHz;
+    float   PeriodInUSec;
+};
+
+void InitCpuTimers(void);
+void ConfigCpuTimer(struct CPUTIMER_VARS *Timer, float Freq, float Period);
+
+extern struct CPUTIMER_VARS CpuTimer0;
+extern struct CPUTIMER_VARS CpuTimer1;
+extern struct CPUTIMER_VARS CpuTimer2;
+
+#define StartCpuTimer0()   CpuTimer0Regs.TCR.bit.TSS = 0
+#define StopCpuTimer0()   CpuTimer0Regs.TCR.bit.TSS = 1
+#define ReloadCpuTimer0() CpuTimer0Regs.TCR.bit.TRB = 1
+#define ReadCpuTimer0Counter() CpuTimer0Regs.TIM.all
+#define ReadCpuTimer0Period() CpuTimer0Regs.PRD.all
+#define StartCpuTimer1()   CpuTimer1Regs.TCR.bit.TSS = 0
+#define StopCpuTimer1()   CpuTimer1Regs.TCR.bit.TSS = 1
+#define ReloadCpuTimer1() CpuTimer1Regs.TCR.bit.TRB = 1
+#define ReadCpuTimer1Counter() CpuTimer1Regs.TIM.all
+#define ReadCpuTimer1Period() CpuTimer1Regs.PRD.all
+#define StartCpuTimer2()   CpuTimer2Regs.TCR.bit.TSS = 0
+#define StopCpuTimer2()   CpuTimer2Regs.TCR.bit.TSS = 1
+#define ReloadCpuTimer2() CpuTimer2Regs.TCR.bit.TRB = 1
+#define ReadCpuTimer2Counter() CpuTimer2Regs.TIM.all
+#define ReadCpuTimer2Period() CpuTimer2Regs.PRD.all
+
+//---------------------------------------------------------------------------
+// ePWM (F2837xS_EPwm_defines.h)
+//
+// TBCTL (Time-Base Control)
+#define TB_COUNT_UP     0x0
+#define TB_COUNT_DOWN   0x1
+#define TB_COUNT_UPDOWN 0x2
+#define TB_FREEZE       0x3
+#define TB_DISABLE      0x0
+#define TB_ENABLE       0x1
+#define TB_SHADOW       0x0
+#define TB_IMMEDIATE    0x1
+#define TB_SYNC_IN      0x0
+#define TB_CTR_ZERO     0x1
+#define TB_CTR_CMPB     0x2
+#define TB_SYNC_DISABLE 0x3
+#define TB_DIV1         0x0
+#define TB_DIV2         0x1
+#define TB_DIV4         0x2
+// CMPCTL (Compare Control)
+#define CC_CTR_ZERO     0x0
+#define CC_CTR_PRD      0x1
+#define CC_CTR_ZERO_PRD 0x2
+#define CC_LD_DISABLE   0x3
+#define CC_SHADOW       0x0
+#define CC_IMMEDIATE    0x1
+// AQCTLA and AQCTLB (Action Qualifier Control)
+#define AQ_NO_ACTION    0x0
+#define AQ_CLEAR        0x1
+#define AQ_SET          0x2
+#define AQ_TOGGLE       0x3
+// DBCTL (Dead-Band Control)
+#define DB_DISABLE      0x0
+#define DBB_ENABLE      0x1
+#define DBA_ENABLE      0x2
+#define DB_FULL_ENABLE  0x3
+#define DB_ACTV_HI      0x0
+#define DB_ACTV_LOC     0x1
+#define DB_ACTV_HIC     0x2
+#define DB_ACTV_LO      0x3
+#define DBA_ALL         0x0
+#define DBB_RED_DBA_FED 0x1
+#define DBA_RED_DBB_FED 0x2
+#define DBB_ALL         0x3
+// ETSEL (Event Trigger Select)
+#define ET_DCAEVT1SOC   0x0
+#define ET_CTR_ZERO     0x1
+#define ET_CTR_PRD      0x2
+#define ET_CTR_PRDZERO  0x3
+#define ET_CTRU_CMPA    0x4
+#define ET_CTRD_CMPA    0x5
+#define ET_CTRU_CMPB    0x6
+#define ET_CTRD_CMPB    0x7
+// ETPS (Event Trigger Pre-scale)
+#define ET_DISABLE      0x0
+#define ET_1ST          0x1
+#define ET_2ND          0x2
+#define ET_3RD          0x3
+
+//---------------------------------------------------------------------------
+// ADC (F2837xS_Adc_defines.h)
+//
+#define ADC_ADCA 0
+#define ADC_ADCB 1
+#define ADC_ADCC 2
+#define ADC_ADCD 3
+#define ADC_RESOLUTION_12BIT 0
+#define ADC_RESOLUTION_16BIT 1
+#define ADC_SIGNALMODE_SINGLE 0
+#define ADC_SIGNALMODE_DIFFERENTIAL 1
+
+void AdcSetMode(Uint16 adc, Uint16 resolution, Uint16 signalmode);
+
+//---------------------------------------------------------------------------
+// GPIO (F2837xS_Gpio_defines.h)
+//
+#define GPIO_OUTPUT         1
+#define GPIO_INPUT          0
+#define GPIO_MUX_CPU1       0x0
+#define GPIO_MUX_CPU1CLA    0x1
+#define GPIO_PUSHPULL       0
+#define GPIO_PULLUP         (1 << 0)
+#define GPIO_INVERT         (1 << 1)
+#define GPIO_OPENDRAIN      (1 << 2)
+#define GPIO_SYNC           (0x0 << 4)
+#define GPIO_QUAL3          (0x1 << 4)
+#define GPIO_QUAL6          (0x2 << 4)
+#define GPIO_ASYNC          (0x3 << 4)
+
+#define HAL_GPIO_PINS 169
+extern Uint16 HalPinMux[HAL_GPIO_PINS];            // Last GPIO_SetupPinMux peripheral
+extern Uint16 HalPinOutput[HAL_GPIO_PINS];         // Last GPIO_SetupPinOptions direction
+
+void InitGpio(void);
+void GPIO_SetupPinMux(Uint16 pin, Uint16 cpu, Uint16 peripheral);
+void GPIO_SetupPinOptions(Uint16 pin, Uint16 output, Uint16 flags);
+
+//---------------------------------------------------------------------------
+// CLA (F2837xS_Cla_defines.h)
+//
+#define CLA_TRIG_NOPERPH    0
+#define CLA_TRIG_ADCAINT1   1
+
+extern volatile Uint16 HalClaForced;               // Bit Task-1 set by each forced task
+extern void (*HalClaHook)(Uint16 Task);            // Runs a forced task, e.g. Cla1Task8 of the firmware
+void HalClaForce(Uint16 Task);
+
+#define Cla1ForceTask1andWait() HalClaForce(1)
+#define Cla1ForceTask8andWait() HalClaForce(8)
+
+//---------------------------------------------------------------------------
+// DMA (F2837xS_Dma_defines.h)
+//
+#define DMA_NOPERIPH        0
+#define DMA_ADCAINT1        1
+#define DMA_ADCBINT1        6
+
+//---------------------------------------------------------------------------
+// System control, PIE and delays
+//
+void InitSysCtrl(void);
+void InitPieCtrl(void);
+void EnableInterrupts(void);
+void InitPieVectTable(void);
+
+extern volatile Uint32 HalDelayUs;                 // Total DELAY_US time requested
+#define DELAY_US(A)  (HalDelayUs += (Uint32)(A))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end of F2837xS_EXAMPLES_H definition
@@ -0,0 +1,1070 @@
+//###########################################################################
+// FILE:   F2837xS_device.h (host mock)
+// TITLE:  Host replacement for the F2837xS device and peripheral headers
+//###########################################################################
+// Declares the registers that pm_stepper_motor_controller.c and the
+// F2837xS_*.c files compiled on the host touch, with the field names,
+// widths and order of the TI bit-field headers, so the firmware sources
+// build unmodified with gcc/clang. Registers are plain RAM (hal_regs.c);
+// nothing happens when they are written unless a test or the peripheral
+// emulator looks at them.
+//
+// Host differences that matter for results:
+//  - long is 64 bits on LP64 hosts, so QPOSCNT is declared as a signed
+//    32-bit count. -QPOSCNT then gives the same value CalcPosition() gets
+//    on the C28x, where the unsigned negation is converted to a 32-bit long.
+//  - The 32-bit DMA address registers hold the low half of a host byte
+//    address, so a firmware pointer cast to Uint32 fits them; a step of one
+//    word moves them by sizeof(Uint16).
+//  - <stdlib.h> is included so abs() is the integer abs() of the rts
+//    library, as on the target.
+//###########################################################################
+
+#ifndef F2837xS_DEVICE_H
+#define F2837xS_DEVICE_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define   TARGET   1
+#define   CPU1     1
+
+//---------------------------------------------------------------------------
+// Common CPU Definitions:
+//
+typedef int16_t             int16;
+typedef int32_t             int32;
+typedef int64_t             int64;
+typedef uint16_t            Uint16;
+typedef uint32_t            Uint32;
+typedef uint64_t            Uint64;
+typedef float               float32;
+typedef long double         float64;
+
+#define __interrupt
+
+// CPU control instructions are recorded so tests can check them
+extern volatile Uint16 IER;
+extern volatile Uint16 IFR;
+extern volatile Uint16 HalIntm;             // INTM, 1 = interrupts disabled
+extern volatile Uint16 HalEallow;           // EALLOW protection lifted
+extern volatile Uint32 HalEstopCount;       // ESTOP0 executed
+extern void (*HalIdleHook)(void);           // Called on every NOP, e.g. from the idle loop of main()
+void HalAsm(const char *Instruction);
+
+#define asm(x)  HalAsm(x)
+#define EINT    (HalIntm = 0)
+#define DINT    (HalIntm = 1)
+#define ERTM    ((void)0)
+#define DRTM    ((void)0)
+#define EALLOW  (HalEallow = 1)
+#define EDIS    (HalEallow = 0)
+#define ESTOP0  HalAsm(" ESTOP0")
+
+#define M_INT1  0x0001
+#define M_INT2  0x0002
+#define M_INT3  0x0004
+#define M_INT4  0x0008
+#define M_INT5  0x0010
+#define M_INT6  0x0020
+#define M_INT7  0x0040
+#define M_INT8  0x0080
+#define M_INT9  0x0100
+#define M_INT10 0x0200
+#define M_INT11 0x0400
+#define M_INT12 0x0800
+#define M_INT13 0x1000
+#define M_INT14 0x2000
+#define M_DLOG  0x4000
+#define M_RTOS  0x8000
+
+#define PIEACK_GROUP1   0x0001
+#define PIEACK_GROUP2   0x0002
+#define PIEACK_GROUP3   0x0004
+#define PIEACK_GROUP4   0x0008
+#define PIEACK_GROUP5   0x0010
+#define PIEACK_GROUP6   0x0020
+#define PIEACK_GROUP7   0x0040
+#define PIEACK_GROUP8   0x0080
+#define PIEACK_GROUP9   0x0100
+#define PIEACK_GROUP10  0x0200
+#define PIEACK_GROUP11  0x0400
+#define PIEACK_GROUP12  0x0800
+
+//---------------------------------------------------------------------------
+// CPU Timer Registers (F2837xS_cputimer.h)
+//
+struct TIM_BITS {                           // bits description
+    Uint16 LSW:16;                          // 15:0 CPU-Timer Counter Registers
+    Uint16 MSW:16;                          // 31:16 CPU-Timer Counter Registers High
+};
+union TIM_REG {
+    Uint32  all;
+    struct  TIM_BITS  bit;
+};
+struct PRD_BITS {                           // bits description
+    Uint16 LSW:16;                          // 15:0 CPU-Timer Period Registers
+    Uint16 MSW:16;                          // 31:16 CPU-Timer Period Registers High
+};
+union PRD_REG {
+    Uint32  all;
+    struct  PRD_BITS  bit;
+};
+struct TCR_BITS {                           // bits description
+    Uint16 rsvd1:4;                         // 3:0 Reserved
+    Uint16 TSS:1;                           // 4 CPU-Timer stop status bit.
+    Uint16 TRB:1;                           // 5 Timer reload
+    Uint16 rsvd2:4;                         // 9:6 Reserved
+    Uint16 SOFT:1;                          // 10 Emulation modes
+    Uint16 FREE:1;                          // 11 Emulation modes
+    Uint16 rsvd3:2;                         // 13:12 Reserved
+    Uint16 TIE:1;                           // 14 CPU-Timer Interrupt Enable.
+    Uint16 TIF:1;                           // 15 CPU-Timer Interrupt Flag.
+};
+union TCR_REG {
+    Uint16  all;
+    struct  TCR_BITS  bit;
+};
+struct TPR_BITS {                           // bits description
+    Uint16 TDDR:8;                          // 7:0 CPU-Timer Divide-Down.
+    Uint16 PSC:8;                           // 15:8 CPU-Timer Prescale Counter.
+};
+union TPR_REG {
+    Uint16  all;
+    struct  TPR_BITS  bit;
+};
+struct TPRH_BITS {                          // bits description
+    Uint16 TDDRH:8;                         // 7:0 CPU-Timer Divide-Down.
+    Uint16 PSCH:8;                          // 15:8 CPU-Timer Prescale Counter.
+};
+union TPRH_REG {
+    Uint16  all;
+    struct  TPRH_BITS  bit;
+};
+struct CPUTIMER_REGS {
+    union   TIM_REG                          TIM;                          // CPU-Timer, Counter Register
+    union   PRD_REG                          PRD;                          // CPU-Timer, Period Register
+    union   TCR_REG                          TCR;                          // CPU-Timer, Control Register
+    Uint16                                   rsvd1;                        // Reserved
+    union   TPR_REG                          TPR;                          // CPU-Timer, Prescale Register
+    union   TPRH_REG                         TPRH;                         // CPU-Timer, Prescale Register High
+};
+
+//---------------------------------------------------------------------------
+// ePWM Registers (F2837xS_epwm.h, registers used by this project)
+//
+struct TBCTL_BITS {                         // bits description
+    Uint16 CTRMODE:2;                       // 1:0 Counter Mode
+    Uint16 PHSEN:1;                         // 2 Phase Load Enable
+    Uint16 PRDLD:1;                         // 3 Active Period Load
+    Uint16 SYNCOSEL:2;                      // 5:4 Sync Output Select
+    Uint16 SWFSYNC:1;                       // 6 Software Force Sync Pulse
+    Uint16 HSPCLKDIV:3;                     // 9:7 High Speed TBCLK Pre-scaler
+    Uint16 CLKDIV:3;                        // 12:10 Time Base Clock Pre-scaler
+    Uint16 PHSDIR:1;                        // 13 Phase Direction Bit
+    Uint16 FREE_SOFT:2;                     // 15:14 Emulation Mode Bits
+};
+union TBCTL_REG {
+    Uint16  all;
+    struct  TBCTL_BITS  bit;
+};
+struct TBSTS_BITS {                         // bits description
+    Uint16 CTRDIR:1;                        // 0 Time Base Counter Direction Status
+    Uint16 SYNCI:1;                         // 1 External Input Sync Status
+    Uint16 CTRMAX:1;                        // 2 Counter Max Latched Status
+    Uint16 rsvd1:13;                        // 15:3 Reserved
+};
+union TBSTS_REG {
+    Uint16  all;
+    struct  TBSTS_BITS  bit;
+};
+struct TBPHS_BITS {                         // bits description
+    Uint16 TBPHSHR:16;                      // 15:0 Extension Register for HRPWM Phase (8-bits)
+    Uint16 TBPHS:16;                        // 31:16 Phase Offset Register
+};
+union TBPHS_REG {
+    Uint32  all;
+    struct  TBPHS_BITS  bit;
+};
+struct CMPCTL_BITS {                        // bits description
+    Uint16 LOADAMODE:2;                     // 1:0 Active Compare A Load
+    Uint16 LOADBMODE:2;                     // 3:2 Active Compare B Load
+    Uint16 SHDWAMODE:1;                     // 4 Compare A Register Block Operating Mode
+    Uint16 rsvd1:1;                         // 5 Reserved
+    Uint16 SHDWBMODE:1;                     // 6 Compare B Register Block Operating Mode
+    Uint16 rsvd2:1;                         // 7 Reserved
+    Uint16 SHDWAFULL:1;                     // 8 Compare A Shadow Register Full Status
+    Uint16 SHDWBFULL:1;                     // 9 Compare B Shadow Register Full Status
+    Uint16 LOADASYNC:2;                     // 11:10 Active Compare A Load on SYNC
+    Uint16 LOADBSYNC:2;                     // 13:12 Active Compare B Load on SYNC
+    Uint16 rsvd3:2;                         // 15:14 Reserved
+};
+union CMPCTL_REG {
+    Uint16  all;
+    struct  CMPCTL_BITS  bit;
+};
+struct DBCTL_BITS {                         // bits description
+    Uint16 OUT_MODE:2;                      // 1:0 Dead Band Output Mode Control
+    Uint16 POLSEL:2;                        // 3:2 Polarity Select Control
+    Uint16 IN_MODE:2;                       // 5:4 Dead Band Input Select Mode Control
+    Uint16 LOADREDMODE:2;                   // 7:6 DBRED Load
+    Uint16 LOADFEDMODE:2;                   // 9:8 DBFED Load
+    Uint16 SHDWDBREDMODE:1;                 // 10 DBRED Block Operating Mode
+    Uint16 SHDWDBFEDMODE:1;                 // 11 DBFED Block Operating Mode
+    Uint16 OUTSWAP:2;                       // 13:12 Dead Band Output Swap Control
+    Uint16 DEDB_MODE:1;                     // 14 Dead Band Dual-Edge B Mode Control
+    Uint16 HALFCYCLE:1;                     // 15 Half Cycle Clocking Enable
+};
+union DBCTL_REG {
+    Uint16  all;
+    struct  DBCTL_BITS  bit;
+};
+struct AQCTLA_BITS {                        // bits description
+    Uint16 ZRO:2;                           // 1:0 Action Counter = Zero
+    Uint16 PRD:2;                           // 3:2 Action Counter = Period
+    Uint16 CAU:2;                           // 5:4 Action Counter = Compare A Up
+    Uint16 CAD:2;                           // 7:6 Action Counter = Compare A Down
+    Uint16 CBU:2;                           // 9:8 Action Counter = Compare B Up
+    Uint16 CBD:2;                           // 11:10 Action Counter = Compare B Down
+    Uint16 rsvd1:4;                         // 15:12 Reserved
+};
+union AQCTLA_REG {
+    Uint16  all;
+    struct  AQCTLA_BITS  bit;
+};
+struct DBRED_BITS {                         // bits description
+    Uint16 DBRED:14;                        // 13:0 Rising edge delay value
+    Uint16 rsvd1:2;                         // 15:14 Reserved
+};
+union DBRED_REG {
+    Uint16  all;
+    struct  DBRED_BITS  bit;
+};
+struct DBFED_BITS {                         // bits description
+    Uint16 DBFED:14;                        // 13:0 Falling edge delay value
+    Uint16 rsvd1:2;                         // 15:14 Reserved
+};
+union DBFED_REG {
+    Uint16  all;
+    struct  DBFED_BITS  bit;
+};
+struct CMPA_BITS {                          // bits description
+    Uint16 CMPAHR:16;                       // 15:0 Compare A HRPWM Extension Register
+    Uint16 CMPA:16;                         // 31:16 Compare A Register
+};
+union CMPA_REG {
+    Uint32  all;
+    struct  CMPA_BITS  bit;
+};
+struct CMPB_BITS {                          // bits description
+    Uint16 CMPBHR:16;                       // 15:0 Compare B High Resolution Bits
+    Uint16 CMPB:16;                         // 31:16 Compare B Register
+};
+union CMPB_REG {
+    Uint32  all;
+    struct  CMPB_BITS  bit;
+};
+struct ETSEL_BITS {                         // bits description
+    Uint16 INTSEL:3;                        // 2:0 EPWMxINTn Select
+    Uint16 INTEN:1;                         // 3 EPWMxINTn Enable
+    Uint16 SOCASELCMP:1;                    // 4 EPWMxSOCA Compare Select
+    Uint16 SOCBSELCMP:1;                    // 5 EPWMxSOCB Compare Select
+    Uint16 INTSELCMP:1;                     // 6 EPWMxINT Compare Select
+    Uint16 rsvd1:1;                         // 7 Reserved
+    Uint16 SOCASEL:3;                       // 10:8 Start of Conversion A Select
+    Uint16 SOCAEN:1;                        // 11 Start of Conversion A Enable
+    Uint16 SOCBSEL:3;                       // 14:12 Start of Conversion B Select
+    Uint16 SOCBEN:1;                        // 15 Start of Conversion B Enable
+};
+union ETSEL_REG {
+    Uint16  all;
+    struct  ETSEL_BITS  bit;
+};
+struct ETPS_BITS {                          // bits description
+    Uint16 INTPRD:2;                        // 1:0 EPWMxINTn Period Select
+    Uint16 INTCNT:2;                        // 3:2 EPWMxINTn Counter Register
+    Uint16 INTPSSEL:1;                      // 4 EPWMxINTn Pre-Scale Selection Bits
+    Uint16 SOCPSSEL:1;                      // 5 EPWMxSOC A/B  Pre-Scale Selection Bits
+    Uint16 rsvd1:2;                         // 7:6 Reserved
+    Uint16 SOCAPRD:2;                       // 9:8 EPWMxSOCA Period Select
+    Uint16 SOCACNT:2;                       // 11:10 EPWMxSOCA Counter Register
+    Uint16 SOCBPRD:2;                       // 13:12 EPWMxSOCB Period Select
+    Uint16 SOCBCNT:2;                       // 15:14 EPWMxSOCB Counter
+};
+union ETPS_REG {
+    Uint16  all;
+    struct  ETPS_BITS  bit;
+};
+struct ETFLG_BITS {                         // bits description
+    Uint16 INT:1;                           // 0 EPWMxINTn Flag
+    Uint16 rsvd1:1;                         // 1 Reserved
+    Uint16 SOCA:1;                          // 2 EPWMxSOCA Flag
+    Uint16 SOCB:1;                          // 3 EPWMxSOCB Flag
+    Uint16 rsvd2:12;                        // 15:4 Reserved
+};
+union ETFLG_REG {
+    Uint16  all;
+    struct  ETFLG_BITS  bit;
+};
+struct EPWM_REGS {
+    union   TBCTL_REG                        TBCTL;                        // Time Base Control Register
+    Uint16                                   rsvd1;                        // Reserved
+    union   TBSTS_REG                        TBSTS;                        // Time Base Status Register
+    Uint16                                   rsvd2;                        // Reserved
+    union   TBPHS_REG                        TBPHS;                        // Time Base Phase High
+    Uint16                                   TBCTR;                        // Time Base Counter Register
+    Uint16                                   TBPRD;                        // Time Base Period Register
+    union   CMPCTL_REG                       CMPCTL;                       // Counter Compare Control Register
+    union   DBCTL_REG                        DBCTL;                        // Dead-Band Generator Control Register
+    union   AQCTLA_REG                       AQCTLA;                       // Action Qualifier Control Register For Output A
+    union   DBRED_REG                        DBRED;                        // Dead-Band Generator Rising Edge Delay Count Register
+    union   DBFED_REG                        DBFED;                        // Dead-Band Generator Falling Edge Delay Count Register
+    union   CMPA_REG                         CMPA;                         // Counter Compare A Register
+    union   CMPB_REG                         CMPB;                         // Compare B Register
+    union   ETSEL_REG                        ETSEL;                        // Event Trigger Selection Register
+    union   ETPS_REG                         ETPS;                         // Event Trigger Pre-Scale Register
+    union   ETFLG_REG                        ETFLG;                        // Event Trigger Flag Register
+    union   ETFLG_REG                        ETCLR;                        // Event Trigger Clear Register
+    union   ETFLG_REG                        ETFRC;                        // Event Trigger Force Register
+};
+
+//---------------------------------------------------------------------------
+// eQEP Registers (F2837xS_eqep.h)
+//
+struct QDECCTL_BITS {                       // bits description
+    Uint16 rsvd1:5;                         // 4:0 Reserved
+    Uint16 QSP:1;                           // 5 QEPS input polarity
+    Uint16 QIP:1;                           // 6 QEPI input polarity
+    Uint16 QBP:1;                           // 7 QEPB input polarity
+    Uint16 QAP:1;                           // 8 QEPA input polarity
+    Uint16 IGATE:1;                         // 9 Index pulse gating option
+    Uint16 SWAP:1;                          // 10 CLK/DIR Signal Source for Position Counter
+    Uint16 XCR:1;                           // 11 External Clock Rate
+    Uint16 SPSEL:1;                         // 12 Sync output pin selection
+    Uint16 SOEN:1;                          // 13 Sync output-enable
+    Uint16 QSRC:2;                          // 15:14 Position-counter source selection
+};
+union QDECCTL_REG {
+    Uint16  all;
+    struct  QDECCTL_BITS  bit;
+};
+struct QEPCTL_BITS {                        // bits description
+    Uint16 WDE:1;                           // 0 QEP watchdog enable
+    Uint16 UTE:1;                           // 1 QEP unit timer enable
+    Uint16 QCLM:1;                          // 2 QEP capture latch mode
+    Uint16 QPEN:1;                          // 3 Quadrature postotion counter enable
+    Uint16 IEL:2;                           // 5:4 Index event latch
+    Uint16 SEL:1;                           // 6 Strobe event latch
+    Uint16 SWI:1;                           // 7 Software init position counter
+    Uint16 IEI:2;                           // 9:8 Index event init of position count
+    Uint16 SEI:2;                           // 11:10 Strobe event init
+    Uint16 PCRM:2;                          // 13:12 Postion counter reset
+    Uint16 FREE_SOFT:2;                     // 15:14 Emulation mode
+};
+union QEPCTL_REG {
+    Uint16  all;
+    struct  QEPCTL_BITS  bit;
+};
+struct QCAPCTL_BITS {                       // bits description
+    Uint16 UPPS:4;                          // 3:0 Unit position event prescaler
+    Uint16 CCPS:3;                          // 6:4 eQEP capture timer clock prescaler
+    Uint16 rsvd1:8;                         // 14:7 Reserved
+    Uint16 CEN:1;                           // 15 Enable eQEP capture
+};
+union QCAPCTL_REG {
+    Uint16  all;
+    struct  QCAPCTL_BITS  bit;
+};
+struct QEPSTS_BITS {                        // bits description
+    Uint16 PCEF:1;                          // 0 Position counter error flag.
+    Uint16 FIMF:1;                          // 1 First index marker flag
+    Uint16 CDEF:1;                          // 2 Capture direction error flag
+    Uint16 COEF:1;                          // 3 Capture overflow error flag
+    Uint16 QDLF:1;                          // 4 eQEP direction latch flag
+    Uint16 QDF:1;                           // 5 Quadrature direction flag
+    Uint16 FIDF:1;                          // 6 The first index marker
+    Uint16 UPEVNT:1;                        // 7 Unit position event flag
+    Uint16 rsvd1:8;                         // 15:8 Reserved
+};
+union QEPSTS_REG {
+    Uint16  all;
+    struct  QEPSTS_BITS  bit;
+};
+struct EQEP_REGS {
+    int32                                    QPOSCNT;                      // Position Counter (see note at the top)
+    Uint32                                   QPOSINIT;                     // Position Counter Init
+    Uint32                                   QPOSMAX;                      // Maximum Position Count
+    Uint32                                   QPOSCMP;                      // Position Compare
+    Uint32                                   QPOSILAT;                     // Index Position Latch
+    Uint32                                   QPOSSLAT;                     // Strobe Position Latch
+    Uint32                                   QPOSLAT;                      // Position Latch
+    Uint32                                   QUTMR;                        // QEP Unit Timer
+    Uint32                                   QUPRD;                        // QEP Unit Period
+    Uint16                                   QWDTMR;                       // QEP Watchdog Timer
+    Uint16                                   QWDPRD;                       // QEP Watchdog Period
+    union   QDECCTL_REG                      QDECCTL;                      // Quadrature Decoder Control
+    union   QEPCTL_REG                       QEPCTL;                       // QEP Control
+    union   QCAPCTL_REG                      QCAPCTL;                      // Qaudrature Capture Control
+    Uint16                                   QPOSCTL;                      // Position Compare Control
+    Uint16                                   QEINT;                        // QEP Interrupt Control
+    Uint16                                   QFLG;                         // QEP Interrupt Flag
+    Uint16                                   QCLR;                         // QEP Interrupt Clear
+    Uint16                                   QFRC;                         // QEP Interrupt Force
+    union   QEPSTS_REG                       QEPSTS;                       // QEP Status
+    Uint16                                   QCTMR;                        // QEP Capture Timer
+    Uint16                                   QCPRD;                        // QEP Capture Period
+    Uint16                                   QCTMRLAT;                     // QEP Capture Latch
+    Uint16                                   QCPRDLAT;                     // QEP Capture Period Latch
+};
+
+//---------------------------------------------------------------------------
+// ADC Registers (F2837xS_adc.h)
+//
+struct ADCCTL1_BITS {                       // bits description
+    Uint16 rsvd1:2;                         // 1:0 Reserved
+    Uint16 INTPULSEPOS:1;                   // 2 ADC Interrupt Pulse Position
+    Uint16 rsvd2:4;                         // 6:3 Reserved
+    Uint16 ADCPWDNZ:1;                      // 7 ADC Power Down
+    Uint16 ADCBSYCHN:4;                     // 11:8 ADC Busy Channel
+    Uint16 rsvd3:1;                         // 12 Reserved
+    Uint16 ADCBSY:1;                        // 13 ADC Busy
+    Uint16 rsvd4:2;                         // 15:14 Reserved
+};
+union ADCCTL1_REG {
+    Uint16  all;
+    struct  ADCCTL1_BITS  bit;
+};
+struct ADCCTL2_BITS {                       // bits description
+    Uint16 PRESCALE:4;                      // 3:0 ADC Clock Prescaler
+    Uint16 rsvd1:2;                         // 5:4 Reserved
+    Uint16 RESOLUTION:1;                    // 6 SOC Conversion Resolution
+    Uint16 SIGNALMODE:1;                    // 7 SOC Signaling Mode
+    Uint16 rsvd2:8;                         // 15:8 Reserved
+};
+union ADCCTL2_REG {
+    Uint16  all;
+    struct  ADCCTL2_BITS  bit;
+};
+struct ADCBURSTCTL_BITS {                   // bits description
+    Uint16 BURSTTRIGSEL:6;                  // 5:0 SOC Burst Trigger Source Select
+    Uint16 rsvd1:2;                         // 7:6 Reserved
+    Uint16 BURSTSIZE:4;                     // 11:8 SOC Burst Size Select
+    Uint16 rsvd2:3;                         // 14:12 Reserved
+    Uint16 BURSTEN:1;                       // 15 SOC Burst Mode Enable
+};
+union ADCBURSTCTL_REG {
+    Uint16  all;
+    struct  ADCBURSTCTL_BITS  bit;
+};
+struct ADCINTFLG_BITS {                     // bits description
+    Uint16 ADCINT1:1;                       // 0 ADC Interrupt 1 Flag
+    Uint16 ADCINT2:1;                       // 1 ADC Interrupt 2 Flag
+    Uint16 ADCINT3:1;                       // 2 ADC Interrupt 3 Flag
+    Uint16 ADCINT4:1;                       // 3 ADC Interrupt 4 Flag
+    Uint16 rsvd1:12;                        // 15:4 Reserved
+};
+union ADCINTFLG_REG {
+    Uint16  all;
+    struct  ADCINTFLG_BITS  bit;
+};
+struct ADCINTSEL1N2_BITS {                  // bits description
+    Uint16 INT1SEL:4;                       // 3:0 ADCINT1 EOC Source Select
+    Uint16 rsvd1:1;                         // 4 Reserved
+    Uint16 INT1E:1;                         // 5 ADCINT1 Interrupt Enable
+    Uint16 INT1CONT:1;                      // 6 ADCINT1 Continue to Interrupt Mode
+    Uint16 rsvd2:1;                         // 7 Reserved
+    Uint16 INT2SEL:4;                       // 11:8 ADCINT2 EOC Source Select
+    Uint16 rsvd3:1;                         // 12 Reserved
+    Uint16 INT2E:1;                         // 13 ADCINT2 Interrupt Enable
+    Uint16 INT2CONT:1;                      // 14 ADCINT2 Continue to Interrupt Mode
+    Uint16 rsvd4:1;                         // 15 Reserved
+};
+union ADCINTSEL1N2_REG {
+    Uint16  all;
+    struct  ADCINTSEL1N2_BITS  bit;
+};
+struct ADCSOCFLG1_BITS {                    // bits description
+    Uint16 SOC0:1;                          // 0 SOC0 Start of Conversion Flag
+    Uint16 SOC1:1;                          // 1 SOC1 Start of Conversion Flag
+    Uint16 SOC2:1;                          // 2 SOC2 Start of Conversion Flag
+    Uint16 SOC3:1;                          // 3 SOC3 Start of Conversion Flag
+    Uint16 SOC4:1;                          // 4 SOC4 Start of Conversion Flag
+    Uint16 SOC5:1;                          // 5 SOC5 Start of Conversion Flag
+    Uint16 SOC6:1;                          // 6 SOC6 Start of Conversion Flag
+    Uint16 SOC7:1;                          // 7 SOC7 Start of Conversion Flag
+    Uint16 SOC8:1;                          // 8 SOC8 Start of Conversion Flag
+    Uint16 SOC9:1;                          // 9 SOC9 Start of Conversion Flag
+    Uint16 SOC10:1;                         // 10 SOC10 Start of Conversion Flag
+    Uint16 SOC11:1;                         // 11 SOC11 Start of Conversion Flag
+    Uint16 SOC12:1;                         // 12 SOC12 Start of Conversion Flag
+    Uint16 SOC13:1;                         // 13 SOC13 Start of Conversion Flag
+    Uint16 SOC14:1;                         // 14 SOC14 Start of Conversion Flag
+    Uint16 SOC15:1;                         // 15 SOC15 Start of Conversion Flag
+};
+union ADCSOCFLG1_REG {
+    Uint16  all;
+    struct  ADCSOCFLG1_BITS  bit;
+};
+struct ADCSOCxCTL_BITS {                    // bits description
+    Uint16 ACQPS:9;                         // 8:0 SOCx Acquisition Prescale
+    Uint16 rsvd1:6;                         // 14:9 Reserved
+    Uint32 CHSEL:4;                         // 18:15 SOCx Channel Select
+    Uint16 rsvd2:1;                         // 19 Reserved
+    Uint16 TRIGSEL:5;                       // 24:20 SOCx Trigger Source Select
+    Uint16 rsvd3:7;                         // 31:25 Reserved
+};
+union ADCSOCxCTL_REG {
+    Uint32  all;
+    struct  ADCSOCxCTL_BITS  bit;
+};
+struct ADCOFFTRIM_BITS {                    // bits description
+    Uint16 OFFTRIM:8;                       // 7:0 ADC Offset Trim
+    Uint16 rsvd1:8;                         // 15:8 Reserved
+};
+union ADCOFFTRIM_REG {
+    Uint16  all;
+    struct  ADCOFFTRIM_BITS  bit;
+};
+struct ADC_REGS {
+    union   ADCCTL1_REG                      ADCCTL1;                      // ADC Control 1 Register
+    union   ADCCTL2_REG                      ADCCTL2;                      // ADC Control 2 Register
+    union   ADCBURSTCTL_REG                  ADCBURSTCTL;                  // ADC Burst Control Register
+    union   ADCINTFLG_REG                    ADCINTFLG;                    // ADC Interrupt Flag Register
+    union   ADCINTFLG_REG                    ADCINTFLGCLR;                 // ADC Interrupt Flag Clear Register
+    union   ADCINTFLG_REG                    ADCINTOVF;                    // ADC Interrupt Overflow Register
+    union   ADCINTFLG_REG                    ADCINTOVFCLR;                 // ADC Interrupt Overflow Clear Register
+    union   ADCINTSEL1N2_REG                 ADCINTSEL1N2;                 // ADC Interrupt 1 and 2 Selection Register
+    union   ADCINTSEL1N2_REG                 ADCINTSEL3N4;                 // ADC Interrupt 3 and 4 Selection Register
+    Uint16                                   ADCSOCPRICTL;                 // ADC SOC Priority Control Register
+    Uint32                                   ADCINTSOCSEL;                 // ADC Interrupt SOC Selection 1 and 2 Registers
+    union   ADCSOCFLG1_REG                   ADCSOCFLG1;                   // ADC SOC Flag 1 Register
+    union   ADCSOCFLG1_REG                   ADCSOCFRC1;                   // ADC SOC Force 1 Register
+    union   ADCSOCFLG1_REG                   ADCSOCOVF1;                   // ADC SOC Overflow 1 Register
+    union   ADCSOCFLG1_REG                   ADCSOCOVFCLR1;                // ADC SOC Overflow Clear 1 Register
+    union   ADCSOCxCTL_REG                   ADCSOC0CTL;                   // ADC SOC0 Control Register
+    union   ADCSOCxCTL_REG                   ADCSOC1CTL;                   // ADC SOC1 Control Register
+    union   ADCSOCxCTL_REG                   ADCSOC2CTL;                   // ADC SOC2 Control Register
+    union   ADCSOCxCTL_REG                   ADCSOC3CTL;                   // ADC SOC3 Control Register
+    union   ADCSOCxCTL_REG                   ADCSOC4CTL;                   // ADC SOC4 Control Register
+    union   ADCSOCxCTL_REG                   ADCSOC5CTL;                   // ADC SOC5 Control Register
+    union   ADCSOCxCTL_REG                   ADCSOC6CTL;                   // ADC SOC6 Control Register
+    union   ADCSOCxCTL_REG                   ADCSOC7CTL;                   // ADC SOC7 Control Register
+    union   ADCSOCxCTL_REG                   ADCSOC8CTL;                   // ADC SOC8 Control Register
+    union   ADCSOCxCTL_REG                   ADCSOC9CTL;                   // ADC SOC9 Control Register
+    union   ADCSOCxCTL_REG                   ADCSOC10CTL;                  // ADC SOC10 Control Register
+    union   ADCSOCxCTL_REG                   ADCSOC11CTL;                  // ADC SOC11 Control Register
+    union   ADCSOCxCTL_REG                   ADCSOC12CTL;                  // ADC SOC12 Control Register
+    union   ADCSOCxCTL_REG                   ADCSOC13CTL;                  // ADC SOC13 Control Register
+    union   ADCSOCxCTL_REG                   ADCSOC14CTL;                  // ADC SOC14 Control Register
+    union   ADCSOCxCTL_REG                   ADCSOC15CTL;                  // ADC SOC15 Control Register
+    union   ADCOFFTRIM_REG                   ADCOFFTRIM;                   // ADC Offset Trim Register
+    Uint32                                   ADCINLTRIM1;                  // ADC Linearity Trim 1 Register
+    Uint32                                   ADCINLTRIM2;                  // ADC Linearity Trim 2 Register
+    Uint32                                   ADCINLTRIM3;                  // ADC Linearity Trim 3 Register
+    Uint32                                   ADCINLTRIM4;                  // ADC Linearity Trim 4 Register
+    Uint32                                   ADCINLTRIM5;                  // ADC Linearity Trim 5 Register
+    Uint32                                   ADCINLTRIM6;                  // ADC Linearity Trim 6 Register
+};
+struct ADC_RESULT_REGS {
+    Uint16                                   ADCRESULT0;                   // ADC Result 0 Register
+    Uint16                                   ADCRESULT1;                   // ADC Result 1 Register
+    Uint16                                   ADCRESULT2;                   // ADC Result 2 Register
+    Uint16                                   ADCRESULT3;                   // ADC Result 3 Register
+    Uint16                                   ADCRESULT4;                   // ADC Result 4 Register
+    Uint16                                   ADCRESULT5;                   // ADC Result 5 Register
+    Uint16                                   ADCRESULT6;                   // ADC Result 6 Register
+    Uint16                                   ADCRESULT7;                   // ADC Result 7 Register
+    Uint16                                   ADCRESULT8;                   // ADC Result 8 Register
+    Uint16                                   ADCRESULT9;                   // ADC Result 9 Register
+    Uint16                                   ADCRESULT10;                  // ADC Result 10 Register
+    Uint16                                   ADCRESULT11;                  // ADC Result 11 Register
+    Uint16                                   ADCRESULT12;                  // ADC Result 12 Register
+    Uint16                                   ADCRESULT13;                  // ADC Result 13 Register
+    Uint16                                   ADCRESULT14;                  // ADC Result 14 Register
+    Uint16                                   ADCRESULT15;                  // ADC Result 15 Register
+};
+
+//---------------------------------------------------------------------------
+// GPIO Data Registers (F2837xS_gpio.h, ports A and B)
+//
+struct GPADAT_BITS {                        // bits description
+    Uint16 GPIO0:1;                         // 0 Data Register for this pin
+    Uint16 GPIO1:1;                         // 1 Data Register for this pin
+    Uint16 GPIO2:1;                         // 2 Data Register for this pin
+    Uint16 GPIO3:1;                         // 3 Data Register for this pin
+    Uint16 GPIO4:1;                         // 4 Data Register for this pin
+    Uint16 GPIO5:1;                         // 5 Data Register for this pin
+    Uint16 GPIO6:1;                         // 6 Data Register for this pin
+    Uint16 GPIO7:1;                         // 7 Data Register for this pin
+    Uint16 GPIO8:1;                         // 8 Data Register for this pin
+    Uint16 GPIO9:1;                         // 9 Data Register for this pin
+    Uint16 GPIO10:1;                        // 10 Data Register for this pin
+    Uint16 GPIO11:1;                        // 11 Data Register for this pin
+    Uint16 GPIO12:1;                        // 12 Data Register for this pin
+    Uint16 GPIO13:1;                        // 13 Data Register for this pin
+    Uint16 GPIO14:1;                        // 14 Data Register for this pin
+    Uint16 GPIO15:1;                        // 15 Data Register for this pin
+    Uint16 GPIO16:1;                        // 16 Data Register for this pin
+    Uint16 GPIO17:1;                        // 17 Data Register for this pin
+    Uint16 GPIO18:1;                        // 18 Data Register for this pin
+    Uint16 GPIO19:1;                        // 19 Data Register for this pin
+    Uint16 GPIO20:1;                        // 20 Data Register for this pin
+    Uint16 GPIO21:1;                        // 21 Data Register for this pin
+    Uint16 GPIO22:1;                        // 22 Data Register for this pin
+    Uint16 GPIO23:1;                        // 23 Data Register for this pin
+    Uint16 GPIO24:1;                        // 24 Data Register for this pin
+    Uint16 GPIO25:1;                        // 25 Data Register for this pin
+    Uint16 GPIO26:1;                        // 26 Data Register for this pin
+    Uint16 GPIO27:1;                        // 27 Data Register for this pin
+    Uint16 GPIO28:1;                        // 28 Data Register for this pin
+    Uint16 GPIO29:1;                        // 29 Data Register for this pin
+    Uint16 GPIO30:1;                        // 30 Data Register for this pin
+    Uint16 GPIO31:1;                        // 31 Data Register for this pin
+};
+union GPADAT_REG {
+    Uint32  all;
+    struct  GPADAT_BITS  bit;
+};
+struct GPIO_DATA_REGS {
+    union   GPADAT_REG                       GPADAT;                       // GPIO A Data Register (GPIO0 to 31)
+    union   GPADAT_REG                       GPASET;                       // GPIO A Data Set Register (GPIO0 to 31)
+    union   GPADAT_REG                       GPACLEAR;                     // GPIO A Data Clear Register (GPIO0 to 31)
+    union   GPADAT_REG                       GPATOGGLE;                    // GPIO A Data Toggle Register (GPIO0 to 31)
+    Uint32                                   GPBDAT;                       // GPIO B Data Register (GPIO32 to 63)
+    Uint32                                   GPBSET;                       // GPIO B Data Set Register (GPIO32 to 63)
+    Uint32                                   GPBCLEAR;                     // GPIO B Data Clear Register (GPIO32 to 63)
+    Uint32                                   GPBTOGGLE;                    // GPIO B Data Toggle Register (GPIO32 to 63)
+};
+
+//---------------------------------------------------------------------------
+// PIE Control Registers (F2837xS_piectrl.h)
+//
+struct PIECTRL_BITS {                       // bits description
+    Uint16 ENPIE:1;                         // 0 PIE Enable
+    Uint16 PIEVECT:15;                      // 15:1 PIE Vector Address
+};
+union PIECTRL_REG {
+    Uint16  all;
+    struct  PIECTRL_BITS  bit;
+};
+struct PIEACK_BITS {                        // bits description
+    Uint16 ACK1:1;                          // 0 Acknowledge PIE Interrupt Group 1
+    Uint16 ACK2:1;                          // 1 Acknowledge PIE Interrupt Group 2
+    Uint16 ACK3:1;                          // 2 Acknowledge PIE Interrupt Group 3
+    Uint16 ACK4:1;                          // 3 Acknowledge PIE Interrupt Group 4
+    Uint16 ACK5:1;                          // 4 Acknowledge PIE Interrupt Group 5
+    Uint16 ACK6:1;                          // 5 Acknowledge PIE Interrupt Group 6
+    Uint16 ACK7:1;                          // 6 Acknowledge PIE Interrupt Group 7
+    Uint16 ACK8:1;                          // 7 Acknowledge PIE Interrupt Group 8
+    Uint16 ACK9:1;                          // 8 Acknowledge PIE Interrupt Group 9
+    Uint16 ACK10:1;                         // 9 Acknowledge PIE Interrupt Group 10
+    Uint16 ACK11:1;                         // 10 Acknowledge PIE Interrupt Group 11
+    Uint16 ACK12:1;                         // 11 Acknowledge PIE Interrupt Group 12
+    Uint16 rsvd1:4;                         // 15:12 Reserved
+};
+union PIEACK_REG {
+    Uint16  all;
+    struct  PIEACK_BITS  bit;
+};
+struct PIEIER_BITS {                        // bits description
+    Uint16 INTx1:1;                         // 0 Enable for Interrupt x.1
+    Uint16 INTx2:1;                         // 1 Enable for Interrupt x.2
+    Uint16 INTx3:1;                         // 2 Enable for Interrupt x.3
+    Uint16 INTx4:1;                         // 3 Enable for Interrupt x.4
+    Uint16 INTx5:1;                         // 4 Enable for Interrupt x.5
+    Uint16 INTx6:1;                         // 5 Enable for Interrupt x.6
+    Uint16 INTx7:1;                         // 6 Enable for Interrupt x.7
+    Uint16 INTx8:1;                         // 7 Enable for Interrupt x.8
+    Uint16 INTx9:1;                         // 8 Enable for Interrupt x.9
+    Uint16 INTx10:1;                        // 9 Enable for Interrupt x.10
+    Uint16 INTx11:1;                        // 10 Enable for Interrupt x.11
+    Uint16 INTx12:1;                        // 11 Enable for Interrupt x.12
+    Uint16 INTx13:1;                        // 12 Enable for Interrupt x.13
+    Uint16 INTx14:1;                        // 13 Enable for Interrupt x.14
+    Uint16 INTx15:1;                        // 14 Enable for Interrupt x.15
+    Uint16 INTx16:1;                        // 15 Enable for Interrupt x.16
+};
+union PIEIER_REG {
+    Uint16  all;
+    struct  PIEIER_BITS  bit;
+};
+struct PIE_CTRL_REGS {
+    union   PIECTRL_REG                      PIECTRL;                      // ePIE Control Register
+    union   PIEACK_REG                       PIEACK;                       // Interrupt Acknowledge Register
+    union   PIEIER_REG                       PIEIER1;                      // Interrupt Group 1 Enable Register
+    union   PIEIER_REG                       PIEIFR1;                      // Interrupt Group 1 Flag Register
+    union   PIEIER_REG                       PIEIER2;                      // Interrupt Group 2 Enable Register
+    union   PIEIER_REG                       PIEIFR2;                      // Interrupt Group 2 Flag Register
+    union   PIEIER_REG                       PIEIER3;                      // Interrupt Group 3 Enable Register
+    union   PIEIER_REG                       PIEIFR3;                      // Interrupt Group 3 Flag Register
+    union   PIEIER_REG                       PIEIER4;                      // Interrupt Group 4 Enable Register
+    union   PIEIER_REG                       PIEIFR4;                      // Interrupt Group 4 Flag Register
+    union   PIEIER_REG                       PIEIER5;                      // Interrupt Group 5 Enable Register
+    union   PIEIER_REG                       PIEIFR5;                      // Interrupt Group 5 Flag Register
+    union   PIEIER_REG                       PIEIER6;                      // Interrupt Group 6 Enable Register
+    union   PIEIER_REG                       PIEIFR6;                      // Interrupt Group 6 Flag Register
+    union   PIEIER_REG                       PIEIER7;                      // Interrupt Group 7 Enable Register
+    union   PIEIER_REG                       PIEIFR7;                      // Interrupt Group 7 Flag Register
+    union   PIEIER_REG                       PIEIER8;                      // Interrupt Group 8 Enable Register
+    union   PIEIER_REG                       PIEIFR8;                      // Interrupt Group 8 Flag Register
+    union   PIEIER_REG                       PIEIER9;                      // Interrupt Group 9 Enable Register
+    union   PIEIER_REG                       PIEIFR9;                      // Interrupt Group 9 Flag Register
+    union   PIEIER_REG                       PIEIER10;                     // Interrupt Group 10 Enable Register
+    union   PIEIER_REG                       PIEIFR10;                     // Interrupt Group 10 Flag Register
+    union   PIEIER_REG                       PIEIER11;                     // Interrupt Group 11 Enable Register
+    union   PIEIER_REG                       PIEIFR11;                     // Interrupt Group 11 Flag Register
+    union   PIEIER_REG                       PIEIER12;                     // Interrupt Group 12 Enable Register
+    union   PIEIER_REG                       PIEIFR12;                     // Interrupt Group 12 Flag Register
+};
+
+//---------------------------------------------------------------------------
+// CLA Registers (F2837xS_cla.h, task vectors, control and interrupt enable)
+//
+struct MCTL_BITS {                          // bits description
+    Uint16 HARDRESET:1;                     // 0 Hard Reset
+    Uint16 SOFTRESET:1;                     // 1 Soft Reset
+    Uint16 IACKE:1;                         // 2 IACK enable
+    Uint16 rsvd1:13;                        // 15:3 Reserved
+};
+union MCTL_REG {
+    Uint16  all;
+    struct  MCTL_BITS  bit;
+};
+struct MIER_BITS {                          // bits description
+    Uint16 INT1:1;                          // 0 Task 1 Interrupt Enable
+    Uint16 INT2:1;                          // 1 Task 2 Interrupt Enable
+    Uint16 INT3:1;                          // 2 Task 3 Interrupt Enable
+    Uint16 INT4:1;                          // 3 Task 4 Interrupt Enable
+    Uint16 INT5:1;                          // 4 Task 5 Interrupt Enable
+    Uint16 INT6:1;                          // 5 Task 6 Interrupt Enable
+    Uint16 INT7:1;                          // 6 Task 7 Interrupt Enable
+    Uint16 INT8:1;                          // 7 Task 8 Interrupt Enable
+    Uint16 rsvd1:8;                         // 15:8 Reserved
+};
+union MIER_REG {
+    Uint16  all;
+    struct  MIER_BITS  bit;
+};
+struct CLA_REGS {
+    Uint16                                   MVECT1;                       // Task Interrupt Vector
+    Uint16                                   MVECT2;                       // Task Interrupt Vector
+    Uint16                                   MVECT3;                       // Task Interrupt Vector
+    Uint16                                   MVECT4;                       // Task Interrupt Vector
+    Uint16                                   MVECT5;                       // Task Interrupt Vector
+    Uint16                                   MVECT6;                       // Task Interrupt Vector
+    Uint16                                   MVECT7;                       // Task Interrupt Vector
+    Uint16                                   MVECT8;                       // Task Interrupt Vector
+    union   MCTL_REG                         MCTL;                         // Control Register
+    union   MIER_REG                         MIFR;                         // Interrupt Flag Register
+    union   MIER_REG                         MIOVF;                        // Interrupt Overflow Flag Register
+    union   MIER_REG                         MIFRC;                        // Interrupt Force Register
+    union   MIER_REG                         MICLR;                        // Interrupt Flag Clear Register
+    union   MIER_REG                         MICLROVF;                     // Interrupt Overflow Flag Clear Register
+    union   MIER_REG                         MIER;                         // Interrupt Enable Register
+    union   MIER_REG                         MIRUN;                        // Interrupt Run Status Register
+};
+
+//---------------------------------------------------------------------------
+// CLA Task and DMA Channel Trigger Source Select (F2837xS_dma.h, DMA_CLA_SRC_SEL_REGS)
+//
+struct CLA1TASKSRCSEL1_BITS {               // bits description
+    Uint16 TASK1:8;                         // 7:0 Selects the Trigger Source for TASK1 of CLA1
+    Uint16 TASK2:8;                         // 15:8 Selects the Trigger Source for TASK2 of CLA1
+    Uint16 TASK3:8;                         // 23:16 Selects the Trigger Source for TASK3 of CLA1
+    Uint16 TASK4:8;                         // 31:24 Selects the Trigger Source for TASK4 of CLA1
+};
+union CLA1TASKSRCSEL1_REG {
+    Uint32  all;
+    struct  CLA1TASKSRCSEL1_BITS  bit;
+};
+struct CLA1TASKSRCSEL2_BITS {               // bits description
+    Uint16 TASK5:8;                         // 7:0 Selects the Trigger Source for TASK5 of CLA1
+    Uint16 TASK6:8;                         // 15:8 Selects the Trigger Source for TASK6 of CLA1
+    Uint16 TASK7:8;                         // 23:16 Selects the Trigger Source for TASK7 of CLA1
+    Uint16 TASK8:8;                         // 31:24 Selects the Trigger Source for TASK8 of CLA1
+};
+union CLA1TASKSRCSEL2_REG {
+    Uint32  all;
+    struct  CLA1TASKSRCSEL2_BITS  bit;
+};
+struct DMACHSRCSEL1_BITS {                  // bits description
+    Uint16 CH1:8;                           // 7:0 Selects the Trigger and Sync Source CH1 of DMA
+    Uint16 CH2:8;                           // 15:8 Selects the Trigger and Sync Source CH2 of DMA
+    Uint16 CH3:8;                           // 23:16 Selects the Trigger and Sync Source CH3 of DMA
+    Uint16 CH4:8;                           // 31:24 Selects the Trigger and Sync Source CH4 of DMA
+};
+union DMACHSRCSEL1_REG {
+    Uint32  all;
+    struct  DMACHSRCSEL1_BITS  bit;
+};
+struct DMACHSRCSEL2_BITS {                  // bits description
+    Uint16 CH5:8;                           // 7:0 Selects the Trigger and Sync Source CH5 of DMA
+    Uint16 CH6:8;                           // 15:8 Selects the Trigger and Sync Source CH6 of DMA
+    Uint16 rsvd1:16;                        // 31:16 Reserved
+};
+union DMACHSRCSEL2_REG {
+    Uint32  all;
+    struct  DMACHSRCSEL2_BITS  bit;
+};
+struct DMA_CLA_SRC_SEL_REGS {
+    Uint32                                   CLA1TASKSRCSELLOCK;           // CLA1 Task Trigger Source Select Lock Register
+    Uint32                                   DMACHSRCSELLOCK;              // DMA Channel Trigger Source Select Lock Register
+    union   CLA1TASKSRCSEL1_REG              CLA1TASKSRCSEL1;              // CLA1 Task Trigger Source Select Register-1
+    union   CLA1TASKSRCSEL2_REG              CLA1TASKSRCSEL2;              // CLA1 Task Trigger Source Select Register-2
+    union   DMACHSRCSEL1_REG                 DMACHSRCSEL1;                 // DMA Channel Trigger Source Select Register-1
+    union   DMACHSRCSEL2_REG                 DMACHSRCSEL2;                 // DMA Channel Trigger Source Select Register-2
+};
+
+//---------------------------------------------------------------------------
+// DMA Registers (F2837xS_dma.h, control and the six channels)
+//
+struct DMACTRL_BITS {                       // bits description
+    Uint16 HARDRESET:1;                     // 0 Hard Reset Bit
+    Uint16 PRIORITYRESET:1;                 // 1 Priority Reset Bit
+    Uint16 rsvd1:14;                        // 15:2 Reserved
+};
+union DMACTRL_REG {
+    Uint16  all;
+    struct  DMACTRL_BITS  bit;
+};
+struct DEBUGCTRL_BITS {                     // bits description
+    Uint16 rsvd1:15;                        // 14:0 Reserved
+    Uint16 FREE:1;                          // 15 Debug Mode Bit
+};
+union DEBUGCTRL_REG {
+    Uint16  all;
+    struct  DEBUGCTRL_BITS  bit;
+};
+struct MODE_BITS {                          // bits description
+    Uint16 PERINTSEL:5;                     // 4:0 Peripheral Interrupt and Sync Select
+    Uint16 rsvd1:2;                         // 6:5 Reserved
+    Uint16 OVRINTE:1;                       // 7 Overflow Interrupt Enable
+    Uint16 PERINTE:1;                       // 8 Peripheral Interrupt Enable
+    Uint16 CHINTMODE:1;                     // 9 Channel Interrupt Mode
+    Uint16 ONESHOT:1;                       // 10 One Shot Mode Bit
+    Uint16 CONTINUOUS:1;                    // 11 Continuous Mode Bit
+    Uint16 rsvd2:2;                         // 13:12 Reserved
+    Uint16 DATASIZE:1;                      // 14 Data Size Mode Bit
+    Uint16 CHINTE:1;                        // 15 Channel Interrupt Enable Bit
+};
+union MODE_REG {
+    Uint16  all;
+    struct  MODE_BITS  bit;
+};
+struct CONTROL_BITS {                       // bits description
+    Uint16 RUN:1;                           // 0 Run Bit
+    Uint16 HALT:1;                          // 1 Halt Bit
+    Uint16 SOFTRESET:1;                     // 2 Soft Reset Bit
+    Uint16 PERINTFRC:1;                     // 3 Interrupt Force Bit
+    Uint16 PERINTCLR:1;                     // 4 Interrupt Clear Bit
+    Uint16 rsvd1:2;                         // 6:5 Reserved
+    Uint16 ERRCLR:1;                        // 7 Error Clear Bit
+    Uint16 PERINTFLG:1;                     // 8 Interrupt Flag Bit
+    Uint16 rsvd2:1;                         // 9 Reserved
+    Uint16 OVRFLG:1;                        // 10 Overflow Flag Bit
+    Uint16 TRANSFERSTS:1;                   // 11 Transfer Status Bit
+    Uint16 BURSTSTS:1;                      // 12 Burst Status Bit
+    Uint16 RUNSTS:1;                        // 13 Run Status Bit
+    Uint16 rsvd3:2;                         // 15:14 Reserved
+};
+union CONTROL_REG {
+    Uint16  all;
+    struct  CONTROL_BITS  bit;
+};
+struct CH_REGS {
+    union   MODE_REG                         MODE;                         // Mode Register
+    union   CONTROL_REG                      CONTROL;                      // Control Register
+    Uint16                                   BURST_SIZE;                   // Burst Size Register
+    Uint16                                   BURST_COUNT;                  // Burst Count Register
+    int16                                    SRC_BURST_STEP;               // Source Burst Step Register
+    int16                                    DST_BURST_STEP;               // Destination Burst Step Register
+    Uint16                                   TRANSFER_SIZE;                // Transfer Size Register
+    Uint16                                   TRANSFER_COUNT;               // Transfer Count Register
+    int16                                    SRC_TRANSFER_STEP;            // Source Transfer Step Register
+    int16                                    DST_TRANSFER_STEP;            // Destination Transfer Step Register
+    Uint16                                   SRC_WRAP_SIZE;                // Source Wrap Size Register
+    Uint16                                   SRC_WRAP_COUNT;               // Source Wrap Count Register
+    int16                                    SRC_WRAP_STEP;                // Source Wrap Step Register
+    Uint16                                   DST_WRAP_SIZE;                // Destination Wrap Size Register
+    Uint16                                   DST_WRAP_COUNT;               // Destination Wrap Count Register
+    int16                                    DST_WRAP_STEP;                // Destination Wrap Step Register
+    Uint32                                   SRC_BEG_ADDR_SHADOW;          // Source Begin Address Shadow Register
+    Uint32                                   SRC_ADDR_SHADOW;              // Source Address Shadow Register
+    Uint32                                   SRC_BEG_ADDR_ACTIVE;          // Source Begin Address Active Register
+    Uint32                                   SRC_ADDR_ACTIVE;              // Source Address Active Register
+    Uint32                                   DST_BEG_ADDR_SHADOW;          // Destination Begin Address Shadow Register
+    Uint32                                   DST_ADDR_SHADOW;              // Destination Address Shadow Register
+    Uint32                                   DST_BEG_ADDR_ACTIVE;          // Destination Begin Address Active Register
+    Uint32                                   DST_ADDR_ACTIVE;              // Destination Address Active Register
+};
+struct DMA_REGS {
+    union   DMACTRL_REG                      DMACTRL;                      // DMA Control Register
+    union   DEBUGCTRL_REG                    DEBUGCTRL;                    // Debug Control Register
+    Uint16                                   PRIORITYCTRL1;                // Priority Control 1 Register
+    Uint16                                   PRIORITYSTAT;                 // Priority Status Register
+    struct  CH_REGS                          CH1;                          // DMA Channel 1 Registers
+    struct  CH_REGS                          CH2;                          // DMA Channel 2 Registers
+    struct  CH_REGS                          CH3;                          // DMA Channel 3 Registers
+    struct  CH_REGS                          CH4;                          // DMA Channel 4 Registers
+    struct  CH_REGS                          CH5;                          // DMA Channel 5 Registers
+    struct  CH_REGS                          CH6;                          // DMA Channel 6 Registers
+};
+
+//---------------------------------------------------------------------------
+// Memory Configuration Registers (F2837xS_memconfig.h, LS RAM and message RAM)
+//
+struct LSXMSEL_BITS {                       // bits description
+    Uint16 MSEL_LS0:2;                      // 1:0 Master Select for LS0 RAM
+    Uint16 MSEL_LS1:2;                      // 3:2 Master Select for LS1 RAM
+    Uint16 MSEL_LS2:2;                      // 5:4 Master Select for LS2 RAM
+    Uint16 MSEL_LS3:2;                      // 7:6 Master Select for LS3 RAM
+    Uint16 MSEL_LS4:2;                      // 9:8 Master Select for LS4 RAM
+    Uint16 MSEL_LS5:2;                      // 11:10 Master Select for LS5 RAM
+    Uint16 rsvd1:4;                         // 15:12 Reserved
+    Uint16 rsvd2:16;                        // 31:16 Reserved
+};
+union LSXMSEL_REG {
+    Uint32  all;
+    struct  LSXMSEL_BITS  bit;
+};
+struct LSXCLAPGM_BITS {                     // bits description
+    Uint16 CLAPGM_LS0:1;                    // 0 Selects LS0 RAM as program vs data memory for CLA
+    Uint16 CLAPGM_LS1:1;                    // 1 Selects LS1 RAM as program vs data memory for CLA
+    Uint16 CLAPGM_LS2:1;                    // 2 Selects LS2 RAM as program vs data memory for CLA
+    Uint16 CLAPGM_LS3:1;                    // 3 Selects LS3 RAM as program vs data memory for CLA
+    Uint16 CLAPGM_LS4:1;                    // 4 Selects LS4 RAM as program vs data memory for CLA
+    Uint16 CLAPGM_LS5:1;                    // 5 Selects LS5 RAM as program vs data memory for CLA
+    Uint16 rsvd1:10;                        // 15:6 Reserved
+    Uint16 rsvd2:16;                        // 31:16 Reserved
+};
+union LSXCLAPGM_REG {
+    Uint32  all;
+    struct  LSXCLAPGM_BITS  bit;
+};
+struct MSGXINIT_BITS {                      // bits description
+    Uint16 INIT_CPUTOCLA1:1;                // 0 Initialization control for CPUTOCLA1 MSG RAM
+    Uint16 INIT_CLA1TOCPU:1;                // 1 Initialization control for CLA1TOCPU MSG RAM
+    Uint16 rsvd1:14;                        // 15:2 Reserved
+    Uint16 rsvd2:16;                        // 31:16 Reserved
+};
+union MSGXINIT_REG {
+    Uint32  all;
+    struct  MSGXINIT_BITS  bit;
+};
+struct MSGXINITDONE_BITS {                  // bits description
+    Uint16 INITDONE_CPUTOCLA1:1;            // 0 Initialization status for CPU to CLA1 MSG RAM
+    Uint16 INITDONE_CLA1TOCPU:1;            // 1 Initialization status for CLA1 to CPU MSG RAM
+    Uint16 rsvd1:14;                        // 15:2 Reserved
+    Uint16 rsvd2:16;                        // 31:16 Reserved
+};
+union MSGXINITDONE_REG {
+    Uint32  all;
+    struct  MSGXINITDONE_BITS  bit;
+};
+struct MEMCFG_REGS {
+    union   LSXMSEL_REG                      LSxMSEL;                      // Local Shared RAM Master Sel Register
+    union   LSXCLAPGM_REG                    LSxCLAPGM;                    // Local Shared RAM Prog/Exe control Register
+    union   MSGXINIT_REG                     MSGxINIT;                     // Message RAM Init Register
+    union   MSGXINITDONE_REG                 MSGxINITDONE;                 // Message RAM InitDone Status Register
+};
+
+//---------------------------------------------------------------------------
+// PIE Vector Table (F2837xS_pievect.h, group 1 and the CLA1 task ends)
+//
+typedef void (*PINT)(void);
+
+struct PIE_VECT_TABLE {
+    PINT    ADCA1_INT;                      // 1.1 - ADCA Interrupt 1
+    PINT    ADCB1_INT;                      // 1.2 - ADCB Interrupt 1
+    PINT    ADCC1_INT;                      // 1.3 - ADCC Interrupt 1
+    PINT    XINT1_INT;                      // 1.4 - XINT1 Interrupt
+    PINT    XINT2_INT;                      // 1.5 - XINT2 Interrupt
+    PINT    ADCD1_INT;                      // 1.6 - ADCD Interrupt 1
+    PINT    TIMER0_INT;                     // 1.7 - Timer 0 Interrupt
+    PINT    WAKE_INT;                       // 1.8 - Standby and Halt Wakeup Interrupt
+    PINT    CLA1_1_INT;                     // 11.1 - CLA1 Interrupt 1
+    PINT    CLA1_8_INT;                     // 11.8 - CLA1 Interrupt 8
+};
+
+//---------------------------------------------------------------------------
+// CPU System Registers (F2837xS_sysctrl.h, clock gating only)
+//
+struct PCLKCR0_BITS {                       // bits description
+    Uint16 CLA1:1;                          // 0 CLA1 Clock Enable Bit
+    Uint16 rsvd1:1;                         // 1 Reserved
+    Uint16 DMA:1;                           // 2 DMA Clock Enable bit
+    Uint16 CPUTIMER0:1;                     // 3 CPUTIMER0 Clock Enable bit
+    Uint16 CPUTIMER1:1;                     // 4 CPUTIMER1 Clock Enable bit
+    Uint16 CPUTIMER2:1;                     // 5 CPUTIMER2 Clock Enable bit
+    Uint16 rsvd2:10;                        // 15:6 Reserved
+    Uint16 HRPWM:1;                         // 16 HRPWM Clock Enable Bit
+    Uint16 rsvd3:1;                         // 17 Reserved
+    Uint16 TBCLKSYNC:1;                     // 18 EPWM Time Base Clock sync
+    Uint16 GTBCLKSYNC:1;                    // 19 EPWM Time Base Clock Global sync
+    Uint16 rsvd4:12;                        // 31:20 Reserved
+};
+union PCLKCR0_REG {
+    Uint32  all;
+    struct  PCLKCR0_BITS  bit;
+};
+struct PCLKCR2_BITS {                       // bits description
+    Uint16 EPWM1:1;                         // 0 EPWM1 Clock Enable bit
+    Uint16 EPWM2:1;                         // 1 EPWM2 Clock Enable bit
+    Uint16 EPWM3:1;                         // 2 EPWM3 Clock Enable bit
+    Uint16 EPWM4:1;                         // 3 EPWM4 Clock Enable bit
+    Uint16 EPWM5:1;                         // 4 EPWM5 Clock Enable bit
+    Uint16 EPWM6:1;                         // 5 EPWM6 Clock Enable bit
+    Uint16 EPWM7:1;                         // 6 EPWM7 Clock Enable bit
+    Uint16 EPWM8:1;                         // 7 EPWM8 Clock Enable bit
+    Uint16 EPWM9:1;                         // 8 EPWM9 Clock Enable bit
+    Uint16 EPWM10:1;                        // 9 EPWM10 Clock Enable bit
+    Uint16 EPWM11:1;                        // 10 EPWM11 Clock Enable bit
+    Uint16 EPWM12:1;                        // 11 EPWM12 Clock Enable bit
+    Uint16 rsvd1:4;                         // 15:12 Reserved
+    Uint16 rsvd2:16;                        // 31:16 Reserved
+};
+union PCLKCR2_REG {
+    Uint32  all;
+    struct  PCLKCR2_BITS  bit;
+};
+struct CPU_SYS_REGS {
+    union   PCLKCR0_REG                      PCLKCR0;                      // Peripheral Clock Gating Registers
+    Uint32                                   PCLKCR1;                      // Peripheral Clock Gating Registers
+    union   PCLKCR2_REG                      PCLKCR2;                      // Peripheral Clock Gating Registers
+};
+
+//---------------------------------------------------------------------------
+// Register instances (hal_regs.c)
+//
+extern volatile struct CPUTIMER_REGS CpuTimer0Regs;
+extern volatile struct CPUTIMER_REGS CpuTimer1Regs;
+extern volatile struct CPUTIMER_REGS CpuTimer2Regs;
+extern volatile struct EPWM_REGS EPwm1Regs;
+extern volatile struct EPWM_REGS EPwm7Regs;
+extern volatile struct EPWM_REGS EPwm9Regs;
+extern volatile struct EQEP_REGS EQep1Regs;
+extern volatile struct ADC_REGS AdcaRegs;
+extern volatile struct ADC_REGS AdcbRegs;
+extern volatile struct ADC_RESULT_REGS AdcaResultRegs;
+extern volatile struct ADC_RESULT_REGS AdcbResultRegs;
+extern volatile struct GPIO_DATA_REGS GpioDataRegs;
+extern volatile struct PIE_CTRL_REGS PieCtrlRegs;
+extern struct PIE_VECT_TABLE PieVectTable;
+extern volatile struct CPU_SYS_REGS CpuSysRegs;
+extern volatile struct CLA_REGS Cla1Regs;
+extern volatile struct DMA_REGS DmaRegs;
+extern volatile struct DMA_CLA_SRC_SEL_REGS DmaClaSrcSelRegs;
+extern volatile struct MEMCFG_REGS MemCfgRegs;
+
+// Clears every register instance and the CPU state above
+void HalReset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end of F2837xS_DEVICE_H definition
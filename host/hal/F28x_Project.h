@@ -0,0 +1,12 @@
+//###########################################################################
+// FILE:   F28x_Project.h (host mock)
+// TITLE:  Host replacement for the F2837xS project include file
+//###########################################################################
+
+#ifndef F28X_PROJECT_H
+#define F28X_PROJECT_H
+
+#include "F2837xS_device.h"     // Host register definitions
+#include "F2837xS_Examples.h"   // Host examples definitions
+
+#endif  // end of F28X_PROJECT_H definition
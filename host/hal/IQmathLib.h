@@ -0,0 +1,75 @@
+//###########################################################################
+// FILE:   IQmathLib.h (host mock)
+// TITLE:  Host replacement for the C28x IQmath library header
+//###########################################################################
+// Bit-exact model of the IQmath fixed-point operations used by
+// pm_stepper_control_iq.c: _iqN values are 32-bit, products are taken in
+// 64 bits and shifted right (rounding toward minus infinity, as the C28x
+// IQmpy intrinsic, or to nearest for the rmpy forms), conversions from
+// constants truncate toward zero.
+// _IQsin/_IQcos round double sin/cos to the nearest LSB; the target library
+// uses a table and may differ from it by a few LSB.
+//###########################################################################
+
+#ifndef IQMATHLIB_H
+#define IQMATHLIB_H
+
+#include <math.h>
+#include <stdint.h>
+
+#ifndef GLOBAL_Q
+#define GLOBAL_Q 24
+#endif
+
+typedef int32_t _iq;
+typedef int32_t _iq30;
+typedef int32_t _iq29;
+typedef int32_t _iq24;
+typedef int32_t _iq20;
+
+static inline _iq IQmathMpy(_iq A, _iq B, int Q){
+	return (_iq)(((int64_t)A*B) >> Q);
+}
+
+static inline _iq IQmathRmpy(_iq A, _iq B, int Q){
+	return (_iq)(((((int64_t)A*B) >> (Q-1))+1) >> 1);
+}
+
+static inline _iq IQmathSat(_iq A, _iq Pos, _iq Neg){
+	return (A > Pos) ? Pos : (A < Neg) ? Neg : A;
+}
+
+static inline _iq IQmathFromDouble(double A, int Q){
+	return (_iq)floor(A*(double)(1L << Q)+0.5);
+}
+
+// Constants and conversions
+#define _IQ30(A) ((_iq)((A)*1073741824.0L))
+#define _IQ29(A) ((_iq)((A)*536870912.0L))
+#define _IQ24(A) ((_iq)((A)*16777216.0L))
+#define _IQ20(A) ((_iq)((A)*1048576.0L))
+#define _IQ(A) _IQ24(A)
+
+#define _IQ30toF(A) ((float)(A)*(1.0f/1073741824.0f))
+#define _IQ24toF(A) ((float)(A)*(1.0f/16777216.0f))
+#define _IQ20toF(A) ((float)(A)*(1.0f/1048576.0f))
+#define _IQtoF(A) _IQ24toF(A)
+
+#define _IQtoIQ20(A) ((_iq)(A) >> (GLOBAL_Q-20))
+#define _IQ20toIQ(A) ((_iq)(A) << (GLOBAL_Q-20))
+
+#define _IQsat(A, Pos, Neg) IQmathSat(A, Pos, Neg)
+
+// Multiplies
+#define _IQ30mpy(A, B) IQmathMpy(A, B, 30)
+#define _IQ20mpy(A, B) IQmathMpy(A, B, 20)
+#define _IQmpy(A, B) IQmathMpy(A, B, GLOBAL_Q)
+#define _IQ30rmpy(A, B) IQmathRmpy(A, B, 30)
+#define _IQrmpy(A, B) IQmathRmpy(A, B, GLOBAL_Q)
+#define _IQmpyI32(A, B) ((_iq)((A)*(B)))
+
+// Trigonometric functions, angle in radians
+#define _IQsin(A) IQmathFromDouble(sin((double)(A)/(1L << GLOBAL_Q)), GLOBAL_Q)
+#define _IQcos(A) IQmathFromDouble(cos((double)(A)/(1L << GLOBAL_Q)), GLOBAL_Q)
+
+#endif  // end of IQMATHLIB_H definition
@@ -0,0 +1,117 @@
+//###########################################################################
+// FILE:   hal_regs.c
+// TITLE:  Host register instances and support library stand-ins
+//###########################################################################
+// Plays the role of F2837xS_GlobalVariableDefs.c for the host build and
+// records the support calls that have no effect on the host.
+//###########################################################################
+
+#include <string.h>
+#include "F28x_Project.h"
+
+volatile Uint16 IER;
+volatile Uint16 IFR;
+volatile Uint16 HalIntm = 1;
+volatile Uint16 HalEallow;
+volatile Uint32 HalEstopCount;
+volatile Uint32 HalDelayUs;
+void (*HalIdleHook)(void);
+volatile Uint16 HalClaForced;
+void (*HalClaHook)(Uint16 Task);
+
+volatile struct CPUTIMER_REGS CpuTimer0Regs;
+volatile struct CPUTIMER_REGS CpuTimer1Regs;
+volatile struct CPUTIMER_REGS CpuTimer2Regs;
+volatile struct EPWM_REGS EPwm1Regs;
+volatile struct EPWM_REGS EPwm7Regs;
+volatile struct EPWM_REGS EPwm9Regs;
+volatile struct EQEP_REGS EQep1Regs;
+volatile struct ADC_REGS AdcaRegs;
+volatile struct ADC_REGS AdcbRegs;
+volatile struct ADC_RESULT_REGS AdcaResultRegs;
+volatile struct ADC_RESULT_REGS AdcbResultRegs;
+volatile struct GPIO_DATA_REGS GpioDataRegs;
+volatile struct PIE_CTRL_REGS PieCtrlRegs;
+struct PIE_VECT_TABLE PieVectTable;
+volatile struct CPU_SYS_REGS CpuSysRegs;
+volatile struct CLA_REGS Cla1Regs;
+volatile struct DMA_REGS DmaRegs;
+volatile struct DMA_CLA_SRC_SEL_REGS DmaClaSrcSelRegs;
+volatile struct MEMCFG_REGS MemCfgRegs;
+
+Uint16 HalPinMux[HAL_GPIO_PINS];
+Uint16 HalPinOutput[HAL_GPIO_PINS];
+
+void HalReset(void){
+	IER = 0;
+	IFR = 0;
+	HalIntm = 1;
+	HalEallow = 0;
+	HalEstopCount = 0;
+	HalDelayUs = 0;
+	memset((void *)&CpuTimer0Regs, 0, sizeof(CpuTimer0Regs));
+	memset((void *)&CpuTimer1Regs, 0, sizeof(CpuTimer1Regs));
+	memset((void *)&CpuTimer2Regs, 0, sizeof(CpuTimer2Regs));
+	memset((void *)&EPwm1Regs, 0, sizeof(EPwm1Regs));
+	memset((void *)&EPwm7Regs, 0, sizeof(EPwm7Regs));
+	memset((void *)&EPwm9Regs, 0, sizeof(EPwm9Regs));
+	memset((void *)&EQep1Regs, 0, sizeof(EQep1Regs));
+	memset((void *)&AdcaRegs, 0, sizeof(AdcaRegs));
+	memset((void *)&AdcbRegs, 0, sizeof(AdcbRegs));
+	memset((void *)&AdcaResultRegs, 0, sizeof(AdcaResultRegs));
+	memset((void *)&AdcbResultRegs, 0, sizeof(AdcbResultRegs));
+	memset((void *)&GpioDataRegs, 0, sizeof(GpioDataRegs));
+	memset((void *)&PieCtrlRegs, 0, sizeof(PieCtrlRegs));
+	memset(&PieVectTable, 0, sizeof(PieVectTable));
+	memset((void *)&CpuSysRegs, 0, sizeof(CpuSysRegs));
+	memset((void *)&Cla1Regs, 0, sizeof(Cla1Regs));
+	memset((void *)&DmaRegs, 0, sizeof(DmaRegs));
+	memset((void *)&DmaClaSrcSelRegs, 0, sizeof(DmaClaSrcSelRegs));
+	memset((void *)&MemCfgRegs, 0, sizeof(MemCfgRegs));
+	MemCfgRegs.MSGxINITDONE.all = 0x3;	// Message RAM initialization completes at once
+	HalClaForced = 0;
+	memset(HalPinMux, 0, sizeof(HalPinMux));
+	memset(HalPinOutput, 0, sizeof(HalPinOutput));
+}
+
+// The only instructions the firmware issues are NOP and ESTOP0
+void HalAsm(const char *Instruction){
+	if (strstr(Instruction, "ESTOP0")) HalEstopCount++;
+	else if (strstr(Instruction, "NOP") && HalIdleHook) HalIdleHook();
+}
+
+// Cla1ForceTaskNandWait(): the hook, if any, runs the task to completion
+void HalClaForce(Uint16 Task){
+	HalClaForced |= 1 << (Task-1);
+	if (HalClaHook) HalClaHook(Task);
+}
+
+void InitSysCtrl(void){
+}
+
+void InitGpio(void){
+}
+
+void GPIO_SetupPinMux(Uint16 pin, Uint16 cpu, Uint16 peripheral){
+	(void)cpu;
+	if (pin < HAL_GPIO_PINS) HalPinMux[pin] = peripheral;
+}
+
+void GPIO_SetupPinOptions(Uint16 pin, Uint16 output, Uint16 flags){
+	(void)flags;
+	if (pin < HAL_GPIO_PINS) HalPinOutput[pin] = output;
+}
+
+// Like the TI version, leaves the PIE enabled once the table is loaded
+void InitPieVectTable(void){
+	memset(&PieVectTable, 0, sizeof(PieVectTable));
+	PieCtrlRegs.PIECTRL.bit.ENPIE = 1;
+}
+
+// Trims come from OTP on the device; only the mode bits matter here
+void AdcSetMode(Uint16 adc, Uint16 resolution, Uint16 signalmode){
+	volatile struct ADC_REGS *Regs = (adc == ADC_ADCA) ? &AdcaRegs : (adc == ADC_ADCB) ? &AdcbRegs : NULL;
+	if (!Regs) return;
+	Regs->ADCCTL2.bit.RESOLUTION = resolution;
+	Regs->ADCCTL2.bit.SIGNALMODE = signalmode;
+}
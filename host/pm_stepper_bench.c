@@ -0,0 +1,406 @@
+//###########################################################################
+// FILE:   pm_stepper_bench.c
+// TITLE:  Host microbenchmarks of the control law and the timer ISR
+//###########################################################################
+// Usage: pm_stepper_bench [-o results.json] [-c baseline.json]
+//                         [-x time_ratio] [-X instruction_ratio] [-m ms]
+// Times the Calc* helpers, the filters of pm_stepper_filter (per sample and
+// in batches of BENCH_INPUTS), StepController and its two stages
+// StepPositionLoop and StepCurrentLoop, its IQmath build StepControllerIQ,
+// the whole cpu_timer0_isr against the host register mocks and
+// SetPWMA/SetPWMB, and prints ns/call
+// and, where the kernel exposes the PMU, user-space instructions/call as
+// JSON. With -c, a case regresses when it is slower than time_ratio
+// (default 1.5) or executes more than instruction_ratio (default 1.05)
+// times its value in a previous JSON output; the exit status is then 1.
+// Each figure is the best of several rounds of about -m milliseconds.
+// The JSON also records the harmonic count N of the build; CMake builds
+// one pm_stepper_bench_n<N> per N (target bench_harmonics).
+//###########################################################################
+
+#include <linux/perf_event.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include "F28x_Project.h"
+#include "pm_stepper_control.h"
+#include "pm_stepper_control_iq.h"
+#include "pm_stepper_isr.h"
+#include "pm_stepper_trig.h"
+
+#define BENCH_ROUNDS 7
+#define BENCH_INPUTS 64						// Input pattern length, a power of 2
+
+struct BENCH_CASE {
+	const char *Name;
+	void (*Run)(long Calls);
+};
+
+struct BENCH_RESULT {
+	double Ns;								// ns/call, best round
+	double Instructions;					// instructions/call, < 0 if not counted
+};
+
+// Firmware pieces under test (pm_stepper_firmware_host)
+void SetPWMA(float);
+void SetPWMB(float);
+__interrupt void cpu_timer0_isr(void);
+#if ADC_DMA
+extern Uint16 AdcDma[2][2][ADC_OVERSAMPLING];
+#endif
+
+static volatile float Sink;
+static float Input[BENCH_INPUTS];
+static struct POSITION_STATE InputPosition[BENCH_INPUTS];	// Input as an encoder position
+static _iq InputIQ[BENCH_INPUTS];			// Input in Q24
+static struct CONTROLLER_STATE State;
+static struct CONTROLLER_IQ_STATE StateIQ;
+static struct DIFF_STATE Diff;
+static struct INTEGRATOR_STATE Int;
+static float Output[BENCH_INPUTS];
+
+//---------------------------------------------------------------------------
+// Cases. Inputs cycle through a fixed pattern so nothing is hoisted out of
+// the loop; state is reset before it can run away.
+//
+static void RunStepDiff(long Calls){
+	long k;
+	for (k=0; k<Calls; k++) Sink = StepDiff(&Diff, Input[k & (BENCH_INPUTS-1)]);
+}
+
+// Calls counts samples, as for RunStepDiff
+static void RunStepDiffBatch(long Calls){
+	long k;
+	for (k=0; k<Calls; k+=BENCH_INPUTS){
+		StepDiffBatch(&Diff, Input, Output, BENCH_INPUTS);
+		Sink = Output[BENCH_INPUTS-1];
+	}
+}
+
+static void RunStepIntegrator(long Calls){
+	long k;
+	for (k=0; k<Calls; k++){
+		if ((k & 1023) == 0) Int.y = 0;
+		Sink = StepIntegrator(&Int, Input[k & (BENCH_INPUTS-1)]);
+	}
+}
+
+static void RunStepIntegratorBatch(long Calls){
+	long k;
+	for (k=0; k<Calls; k+=BENCH_INPUTS){
+		if ((k & 1023) == 0) Int.y = 0;
+		StepIntegratorBatch(&Int, Input, Output, BENCH_INPUTS);
+		Sink = Output[BENCH_INPUTS-1];
+	}
+}
+
+static void RunCalcPosDesired(long Calls){
+	long k;
+	for (k=0; k<Calls; k++) Sink = CalcPosDesired((k & 8191)*CTRL_TS);
+}
+
+static void RunCalcSpeedDesired(long Calls){
+	long k;
+	for (k=0; k<Calls; k++) Sink = CalcSpeedDesired(&State, (k & 8191)*CTRL_TS);
+}
+
+static void RunStepController(long Calls){
+	struct CONTROLLER_INPUTS In;
+	struct CONTROLLER_OUTPUTS Out;
+	long k;
+	for (k=0; k<Calls; k++){
+		if ((k & 1023) == 0) InitController(&State);
+		In.Theta = Input[k & (BENCH_INPUTS-1)];
+		In.Tooth = InputPosition[k & (BENCH_INPUTS-1)].Tooth;
+		In.Pole = InputPosition[k & (BENCH_INPUTS-1)].Pole;
+		In.Ia = Input[(k+16) & (BENCH_INPUTS-1)];
+		In.Ib = Input[(k+32) & (BENCH_INPUTS-1)];
+		StepController(&State, &In, &Out);
+		Sink = Out.Va+Out.Vb;
+	}
+}
+
+// The two stages of StepController, as the CONTROL_SPLIT build runs them
+static void RunStepPositionLoop(long Calls){
+	struct CONTROLLER_INPUTS In;
+	struct CURRENT_SETPOINT Setpoint;
+	long k;
+	for (k=0; k<Calls; k++){
+		if ((k & 1023) == 0) InitController(&State);
+		In.Theta = Input[k & (BENCH_INPUTS-1)];
+		In.Tooth = InputPosition[k & (BENCH_INPUTS-1)].Tooth;
+		In.Pole = InputPosition[k & (BENCH_INPUTS-1)].Pole;
+		In.Ia = Input[(k+16) & (BENCH_INPUTS-1)];
+		In.Ib = Input[(k+32) & (BENCH_INPUTS-1)];
+		StepPositionLoop(&State, &In, &Setpoint);
+		Sink = Setpoint.Va0+Setpoint.Vb0;
+	}
+}
+
+static void RunStepCurrentLoop(long Calls){
+	struct SETPOINT_MAILBOX Mailbox;
+	struct CURRENT_SETPOINT Setpoint = {0.1f, -0.2f, 0, 0, 1.5f, -2.5f};
+	struct CONTROLLER_GAINS Gains;
+	struct CONTROLLER_OUTPUTS Out;
+	long k;
+	InitControllerGains(&Gains);
+	Setpoint.GainA = Gains.alphaA;
+	Setpoint.GainB = Gains.alphaB;
+	InitSetpointMailbox(&Mailbox);
+	PublishSetpoint(&Mailbox, &Setpoint);
+	for (k=0; k<Calls; k++){
+		StepCurrentLoop(&Mailbox.Buffer[Mailbox.Index], Input[k & (BENCH_INPUTS-1)], Input[(k+16) & (BENCH_INPUTS-1)], &Out);
+		Sink = Out.Va+Out.Vb;
+	}
+}
+
+// Same inputs as RunStepController, in fixed point
+static void RunStepControllerIQ(long Calls){
+	struct CONTROLLER_IQ_INPUTS In;
+	struct CONTROLLER_IQ_OUTPUTS Out;
+	long k;
+	for (k=0; k<Calls; k++){
+		if ((k & 1023) == 0) InitControllerIQ(&StateIQ, &State.Gains);
+		In.Theta = CalcPositionIQ(&InputPosition[k & (BENCH_INPUTS-1)]);
+		In.Tooth = InputPosition[k & (BENCH_INPUTS-1)].Tooth;
+		In.Pole = InputPosition[k & (BENCH_INPUTS-1)].Pole;
+		In.Ia = InputIQ[(k+16) & (BENCH_INPUTS-1)];
+		In.Ib = InputIQ[(k+32) & (BENCH_INPUTS-1)];
+		StepControllerIQ(&StateIQ, &In, &Out);
+		Sink = _IQtoF(Out.Va+Out.Vb);
+	}
+}
+
+#if ADC_DMA
+// Both halves of one ADC alike, every conversion the code of I
+static void FillAdcDma(Uint16 Codes[2][ADC_OVERSAMPLING], float I){
+	Uint16 Code = (Uint16)(fabsf(I)*(1/CTRL_AMPS_PER_CODE));
+	int k;
+	for (k=0; k<ADC_OVERSAMPLING; k++) Codes[0][k] = Codes[1][k] = Code;
+}
+#endif
+
+// The ISR reads QPOSCNT and the currents the DMA left in AdcDma, or those
+// adca1_isr left in Currents
+static void RunTimer0Isr(long Calls){
+	long k;
+	for (k=0; k<Calls; k++){
+		if ((k & 1023) == 0) InitController(&Isr.Controller);
+		EQep1Regs.QPOSCNT = -(int32)(Input[k & (BENCH_INPUTS-1)]*6366.2f);
+#if ADC_DMA
+		FillAdcDma(AdcDma[0], Input[(k+16) & (BENCH_INPUTS-1)]);
+		FillAdcDma(AdcDma[1], Input[(k+32) & (BENCH_INPUTS-1)]);
+#else
+		PublishCurrents(&Isr.Currents, Input[(k+16) & (BENCH_INPUTS-1)], Input[(k+32) & (BENCH_INPUTS-1)]);
+#endif
+		cpu_timer0_isr();
+	}
+}
+
+static void RunSetPWM(long Calls){
+	long k;
+	for (k=0; k<Calls; k++){
+		SetPWMA(Input[k & (BENCH_INPUTS-1)]*8);
+		SetPWMB(Input[(k+16) & (BENCH_INPUTS-1)]*8);
+	}
+}
+
+static const struct BENCH_CASE Cases[] = {
+	{"StepDiff", RunStepDiff},
+	{"StepDiffBatch", RunStepDiffBatch},
+	{"StepIntegrator", RunStepIntegrator},
+	{"StepIntegratorBatch", RunStepIntegratorBatch},
+	{"CalcPosDesired", RunCalcPosDesired},
+	{"CalcSpeedDesired", RunCalcSpeedDesired},
+	{"StepController", RunStepController},
+	{"StepPositionLoop", RunStepPositionLoop},
+	{"StepCurrentLoop", RunStepCurrentLoop},
+	{"StepControllerIQ", RunStepControllerIQ},
+	{"cpu_timer0_isr", RunTimer0Isr},
+	{"SetPWMA+SetPWMB", RunSetPWM},
+};
+#define BENCH_CASES ((int)(sizeof(Cases)/sizeof(Cases[0])))
+
+//---------------------------------------------------------------------------
+// Measurement
+//
+static double Now(void){
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec*1e9+t.tv_nsec;
+}
+
+// User-space retired instructions of this thread, -1 without a PMU
+static int OpenInstructionCounter(void){
+	struct perf_event_attr Attr;
+	memset(&Attr, 0, sizeof(Attr));
+	Attr.type = PERF_TYPE_HARDWARE;
+	Attr.size = sizeof(Attr);
+	Attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+	Attr.disabled = 1;
+	Attr.exclude_kernel = 1;
+	Attr.exclude_hv = 1;
+	return (int)syscall(__NR_perf_event_open, &Attr, 0, -1, -1, 0);
+}
+
+static void ResetState(void){
+	int k;
+	InitController(&State);
+	InitController(&Isr.Controller);
+	InitDiff(&Diff, CTRL_DIFF_CUTOFF, CTRL_TS);
+	InitIntegrator(&Int, CTRL_TS);
+	for (k=0; k<BENCH_INPUTS; k++){
+		Input[k] = 0.5f*k/BENCH_INPUTS-0.1f*(k & 3);
+		InitPosition(&InputPosition[k], CalcCounts(Input[k]));
+		InputIQ[k] = FloatToIQ(Input[k]);
+	}
+}
+
+static void Measure(const struct BENCH_CASE *c, int Counter, double Ms, struct BENCH_RESULT *r){
+	long long Count;
+	long Calls = 1000;
+	double t0, t;
+	int Round;
+
+	ResetState();
+	// Grow the call count until one round takes about Ms
+	for (;;){
+		t0 = Now();
+		c->Run(Calls);
+		t = Now()-t0;
+		if (t >= Ms*1e6 || Calls > (1L << 40)) break;
+		Calls = (t > Ms*1e4) ? (long)(Calls*(Ms*1e6/t)) : Calls*10;
+	}
+	r->Ns = t/Calls;
+	for (Round=0; Round<BENCH_ROUNDS; Round++){
+		t0 = Now();
+		c->Run(Calls);
+		t = (Now()-t0)/Calls;
+		if (t < r->Ns) r->Ns = t;
+	}
+	r->Instructions = -1;
+	if (Counter >= 0){
+		ioctl(Counter, PERF_EVENT_IOC_RESET, 0);
+		ioctl(Counter, PERF_EVENT_IOC_ENABLE, 0);
+		c->Run(Calls);
+		ioctl(Counter, PERF_EVENT_IOC_DISABLE, 0);
+		if (read(Counter, &Count, sizeof(Count)) == sizeof(Count)) r->Instructions = (double)Count/Calls;
+	}
+}
+
+static void WriteJson(FILE *f, const struct BENCH_RESULT *r){
+	int k;
+	fprintf(f, "{\n  \"benchmark\": \"pm_stepper_bench\",\n  \"harmonics\": %d,\n  \"results\": [\n", HARMONIC_COUNT);
+	for (k=0; k<BENCH_CASES; k++){
+		fprintf(f, "    {\"name\": \"%s\", \"ns_per_call\": %.3f, \"instructions_per_call\": ", Cases[k].Name, r[k].Ns);
+		if (r[k].Instructions >= 0) fprintf(f, "%.1f}", r[k].Instructions);
+		else fprintf(f, "null}");
+		fprintf(f, "%s\n", (k+1 < BENCH_CASES) ? "," : "");
+	}
+	fprintf(f, "  ]\n}\n");
+}
+
+// Finds "key": <number|null> after Text; returns -1 for null or a missing key
+static double JsonNumber(const char *Text, const char *Key){
+	const char *p = strstr(Text, Key);
+	const char *End = strchr(Text, '}');
+	if (!p || (End && p > End)) return -1;
+	p = strchr(p+strlen(Key), ':');
+	return (p && strncmp(p+1+strspn(p+1, " "), "null", 4)) ? atof(p+1) : -1;
+}
+
+// Compares against every case named in a previous JSON output
+static int CheckBaseline(const char *Path, const struct BENCH_RESULT *r, double TimeRatio, double InstrRatio){
+	char *Text, *p, Name[64];
+	long Size;
+	int k, Failed = 0;
+	double Ns, Instr;
+	FILE *f = fopen(Path, "r");
+
+	if (!f){
+		perror(Path);
+		return -1;
+	}
+	fseek(f, 0, SEEK_END);
+	Size = ftell(f);
+	rewind(f);
+	Text = calloc(Size+1, 1);
+	if (!Text || fread(Text, 1, Size, f) != (size_t)Size){
+		fclose(f);
+		free(Text);
+		return -1;
+	}
+	fclose(f);
+	for (p=Text; (p = strstr(p, "\"name\": \"")) != NULL; ){
+		p += 9;
+		if (sscanf(p, "%63[^\"]", Name) != 1) continue;
+		Ns = JsonNumber(p, "\"ns_per_call\"");
+		Instr = JsonNumber(p, "\"instructions_per_call\"");
+		for (k=0; k<BENCH_CASES && strcmp(Cases[k].Name, Name); k++);
+		if (k == BENCH_CASES){
+			fprintf(stderr, "%-18s missing from this build\n", Name);
+			Failed++;
+			continue;
+		}
+		if (Ns > 0 && r[k].Ns > Ns*TimeRatio){
+			fprintf(stderr, "%-18s %.2f ns/call, baseline %.2f (limit x%.2f)\n", Name, r[k].Ns, Ns, TimeRatio);
+			Failed++;
+		}
+		if (Instr > 0 && r[k].Instructions > Instr*InstrRatio){
+			fprintf(stderr, "%-18s %.1f instructions/call, baseline %.1f (limit x%.2f)\n",
+					Name, r[k].Instructions, Instr, InstrRatio);
+			Failed++;
+		}
+	}
+	free(Text);
+	return Failed;
+}
+
+int main(int argc, char **argv){
+	struct BENCH_RESULT Results[BENCH_CASES];
+	const char *OutPath = NULL, *BasePath = NULL;
+	double TimeRatio = 1.5, InstrRatio = 1.05, Ms = 20;
+	int a, k, Counter, Failed = 0;
+	FILE *Out = stdout;
+
+	for (a=1; a<argc; a++){
+		if (!strcmp(argv[a], "-o") && a+1<argc) OutPath = argv[++a];
+		else if (!strcmp(argv[a], "-c") && a+1<argc) BasePath = argv[++a];
+		else if (!strcmp(argv[a], "-x") && a+1<argc) TimeRatio = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-X") && a+1<argc) InstrRatio = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-m") && a+1<argc) Ms = atof(argv[++a]);
+		else {
+			fprintf(stderr, "usage: %s [-o results.json] [-c baseline.json] [-x time_ratio]"
+							" [-X instruction_ratio] [-m ms]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	HalReset();
+	EPwm7Regs.TBPRD = 5000;
+	EPwm9Regs.TBPRD = 5000;
+	InitTrigTable();
+	Counter = OpenInstructionCounter();
+	for (k=0; k<BENCH_CASES; k++){
+		Measure(&Cases[k], Counter, Ms, &Results[k]);
+	}
+	if (Counter >= 0) close(Counter);
+
+	if (OutPath && !(Out = fopen(OutPath, "w"))){
+		perror(OutPath);
+		return 2;
+	}
+	WriteJson(Out, Results);
+	if (Out != stdout) fclose(Out);
+	if (BasePath){
+		Failed = CheckBaseline(BasePath, Results, TimeRatio, InstrRatio);
+		if (Failed < 0) return 2;
+		fprintf(stderr, "%d regression%s against %s\n", Failed, (Failed == 1) ? "" : "s", BasePath);
+	}
+	return Failed ? 1 : 0;
+}
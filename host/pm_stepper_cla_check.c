@@ -0,0 +1,220 @@
+//###########################################################################
+// FILE:   pm_stepper_cla_check.c
+// TITLE:  Equivalence of the CLA1 tasks and StepController
+//###########################################################################
+// Usage: pm_stepper_cla_check [-t seconds] [-e ripple] [-v error] [-o trace.csv]
+// Runs Cla1Task1 (host build of pm_stepper_cla.cla, set up by InitCla and
+// fed by PublishTrajectory) and StepController side by side for -t seconds
+// (default CHECK_TF, at most 2*tf), as pm_stepper_iq_check does: the same eQEP
+// count, the reference trajectory plus a ripple of -e rad (default 0.01),
+// for both, and the currents of StepController's IaD/IbD of the previous tick
+// plus 50 mA of ripple, seen as the firmware sees them: a 12-bit ADC
+// magnitude signed by the previous Va/Vb. The law amplifies a float LSB into
+// a different run within a second (and CLAsin/CLAcos are table interpolations
+// on the target), so each tick Task1 starts from StepController's integrators,
+// estimators, speed filter and Va/Vb; the phases run on their own. Prints,
+// per signal, the largest error (|CLA-float|, divided by |float| where that
+// is above 1) and the float peak, and the ticks where the tooth or pole
+// phase or the EPwm7/EPwm9 CMPA of Task1 differ from UpdatePosition and
+// SetPWMA/SetPWMB. No plant closes the loop, so with the Controller Gains
+// the float law grows past Vmax after about 4 s and overflows before tf;
+// CHECK_TF stops the default run while it is bounded. Exits 1 when a phase
+// differs, a signal of either law is not finite or the error of Va or Vb is
+// above -v (default 0.01).
+//###########################################################################
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "F28x_Project.h"
+#include "pm_stepper_control.h"
+#include "pm_stepper_cla.h"
+#include "pm_stepper_trig.h"
+
+void SetPWMA(float V);
+void SetPWMB(float V);
+
+#define CHECK_TF 4.0						// Default run length (s), Va/Vb peak within Vmax
+
+#define CHECK_DTHETA 0
+#define CHECK_TAU 1
+#define CHECK_IAD 2
+#define CHECK_IBD 3
+#define CHECK_VA 4
+#define CHECK_VB 5
+#define CHECK_SIGNALS 6
+
+static const char *SignalNames[CHECK_SIGNALS] = {
+	"DTheta", "Tau", "IaD", "IbD", "Va", "Vb"
+};
+
+struct CHECK_RESULT {
+	double MaxDiff[CHECK_SIGNALS];			// max |CLA-float|/max(1,|float|)
+	double Peak[CHECK_SIGNALS];				// max |float|
+	long WorstTick[CHECK_SIGNALS];
+	long PhaseDiffs;						// Ticks with another Tooth or Pole
+	long PwmDiffs;							// Ticks with another CMPA
+	long Missed;							// ClaState.Missed at the end
+	long NonFinite;							// Signals found NaN or inf
+	long FirstNonFinite;					// Tick of the first one
+};
+
+static void Compare(struct CHECK_RESULT *r, int Signal, long Tick, double Float, double Cla){
+	double d;
+	if (!isfinite(Float) || !isfinite(Cla)){
+		if (!r->NonFinite++) r->FirstNonFinite = Tick;
+		return;
+	}
+	d = fabs(Cla-Float)/fmax(1, fabs(Float));
+	if (fabs(Float) > r->Peak[Signal]) r->Peak[Signal] = fabs(Float);
+	if (d > r->MaxDiff[Signal]){
+		r->MaxDiff[Signal] = d;
+		r->WorstTick[Signal] = Tick;
+	}
+}
+
+// Forced tasks run at once, as Cla1ForceTaskNandWait() returns after them
+static void RunClaTask(Uint16 Task){
+	if (Task == 1) Cla1Task1();
+	else if (Task == 8) Cla1Task8();
+}
+
+// Task1's law state as StepController left it
+static void SyncClaState(const struct CONTROLLER_STATE *Ctrl, const struct CONTROLLER_OUTPUTS *Out){
+	int i;
+	ClaState.Sigma2Int = Ctrl->Sigma2Int.y;
+	ClaState.Sigma5Int = Ctrl->Sigma5Int.y;
+	for (i=0; i<HARMONIC_COUNT; i++){
+		ClaState.gammakP[i] = Ctrl->gammakP[i];
+		ClaState.gammakA[i] = Ctrl->gammakA[i];
+		ClaState.gammakPD[i] = Ctrl->gammakPD[i];
+		ClaState.gammakAD[i] = Ctrl->gammakAD[i];
+	}
+	ClaState.Speed = Ctrl->Speed;
+	ClaState.Va = Out->Va;
+	ClaState.Vb = Out->Vb;
+}
+
+// What the firmware reads of a phase current: the ADC code of its magnitude
+static Uint16 AdcCode(float I){
+	long Code = lround(fabs(I)/CLA_AMPS_PER_CODE);
+	return (Uint16)(Code > 4095 ? 4095 : Code);
+}
+
+static void RunCheck(double Tf, double Ripple, struct CHECK_RESULT *r, FILE *Trace){
+	static struct CONTROLLER_STATE Ctrl, Trajectory;
+	struct CONTROLLER_INPUTS In;
+	struct CONTROLLER_OUTPUTS Out = {0, 0};
+	struct POSITION_STATE Position;
+	float Ia=0, Ib=0;
+	Uint16 CmpA, CmpB;
+	double t;
+	long Tick, Ticks = (long)(Tf*CTRL_ITS+0.5), Counts;
+	int k;
+
+	memset(r, 0, sizeof(*r));
+	HalReset();
+	HalClaHook = RunClaTask;
+	EPwm7Regs.TBPRD = 5000;
+	EPwm9Regs.TBPRD = 5000;
+	InitController(&Ctrl);
+	InitController(&Trajectory);
+	Counts = CalcCounts(CalcPosDesired(0));
+	InitPosition(&Position, Counts);
+	InitCla(&Ctrl.Gains, &Position);
+	PublishTrajectory(&Trajectory);
+	for (Tick=0; Tick<Ticks; Tick++){
+		t = (Tick+1)*CTRL_TS;
+		Counts = CalcCounts(CalcPosDesired(t)+Ripple*(sin(7*t)+0.2*sin(90*t)));
+		UpdatePosition(&Position, Counts);
+		In.Theta = CalcPosition(&Position);
+		In.Tooth = Position.Tooth;
+		In.Pole = Position.Pole;
+		In.Ia = AdcCode(Ia)*CLA_AMPS_PER_CODE;
+		In.Ib = AdcCode(Ib)*CLA_AMPS_PER_CODE;
+		if (Out.Va<0) In.Ia = -In.Ia;
+		if (Out.Vb<0) In.Ib = -In.Ib;
+		StepController(&Ctrl, &In, &Out);
+
+		EQep1Regs.QPOSCNT = -Counts;
+		for (k=0; k<ADC_OVERSAMPLING; k++){
+			(&AdcaResultRegs.ADCRESULT0)[k] = AdcCode(Ia);
+			(&AdcbResultRegs.ADCRESULT0)[k] = AdcCode(Ib);
+		}
+		Cla1Task1();
+		CmpA = EPwm7Regs.CMPA.bit.CMPA;
+		CmpB = EPwm9Regs.CMPA.bit.CMPA;
+		PublishTrajectory(&Trajectory);
+
+		SetPWMA(Out.Va);
+		SetPWMB(Out.Vb);
+		if (CmpA != EPwm7Regs.CMPA.bit.CMPA || CmpB != EPwm9Regs.CMPA.bit.CMPA) r->PwmDiffs++;
+		if (ClaState.Tooth != Position.Tooth || ClaState.Pole != Position.Pole) r->PhaseDiffs++;
+		Compare(r, CHECK_DTHETA, Tick, Ctrl.DTheta, ClaState.DTheta);
+		Compare(r, CHECK_TAU, Tick, Ctrl.Tau, ClaState.Tau);
+		Compare(r, CHECK_IAD, Tick, Ctrl.IaD, ClaState.IaD);
+		Compare(r, CHECK_IBD, Tick, Ctrl.IbD, ClaState.IbD);
+		Compare(r, CHECK_VA, Tick, Out.Va, ClaState.Va);
+		Compare(r, CHECK_VB, Tick, Out.Vb, ClaState.Vb);
+		if (Trace){
+			fprintf(Trace, "%.3f,%.5f,%.5f,%.5f,%.5f,%.4f,%.4f,%.4f,%.4f\n", t, In.Theta,
+					Ctrl.Tau, ClaState.Tau, Ctrl.IaD, Out.Va, ClaState.Va, Out.Vb, ClaState.Vb);
+		}
+
+		Ia = Ctrl.IaD+0.05f*sin(300*t);
+		Ib = Ctrl.IbD+0.05f*cos(300*t);
+		SyncClaState(&Ctrl, &Out);
+	}
+	r->Missed = ClaState.Missed;
+	HalClaHook = NULL;
+}
+
+int main(int argc, char **argv){
+	struct CHECK_RESULT Result;
+	const char *TracePath = NULL;
+	FILE *Trace = NULL;
+	double Tf = CHECK_TF, Ripple = 0.01, Tolerance = 0.01;
+	int a, i;
+
+	for (a=1; a<argc; a++){
+		if (!strcmp(argv[a], "-t") && a+1<argc) Tf = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-e") && a+1<argc) Ripple = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-v") && a+1<argc) Tolerance = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-o") && a+1<argc) TracePath = argv[++a];
+		else Tf = 0;
+		if (Tf <= 0 || Tf > 2*CTRL_TF){
+			fprintf(stderr, "usage: %s [-t seconds] [-e ripple] [-v error] [-o trace.csv]\n", argv[0]);
+			return 2;
+		}
+	}
+	InitTrigTable();
+	if (TracePath){
+		if (!(Trace = fopen(TracePath, "w"))){
+			perror(TracePath);
+			return 2;
+		}
+		fprintf(Trace, "time,Theta,Tau,TauCla,IaD,Va,VaCla,Vb,VbCla\n");
+	}
+
+	RunCheck(Tf, Ripple, &Result, Trace);
+	if (Trace) fclose(Trace);
+
+	printf("signal         max error   float peak   at t (s)\n");
+	for (i=0; i<CHECK_SIGNALS; i++){
+		printf("%-10s %13.3e %12.4g %10.3f\n", SignalNames[i], Result.MaxDiff[i], Result.Peak[i],
+			   (Result.WorstTick[i]+1)*CTRL_TS);
+	}
+	printf("ticks with another tooth/pole phase: %ld, another CMPA: %ld, missed trajectories: %ld,"
+		   " non-finite signals: %ld\n", Result.PhaseDiffs, Result.PwmDiffs, Result.Missed, Result.NonFinite);
+	if (Result.NonFinite){
+		printf("FAIL: non-finite signal from t=%.3f s\n", (Result.FirstNonFinite+1)*CTRL_TS);
+		return 1;
+	}
+	if (Result.PhaseDiffs || Result.MaxDiff[CHECK_VA] > Tolerance || Result.MaxDiff[CHECK_VB] > Tolerance){
+		printf("FAIL: phases differ or Va/Vb error above %g\n", Tolerance);
+		return 1;
+	}
+	printf("PASS: Va/Vb error within %g\n", Tolerance);
+	return 0;
+}
@@ -0,0 +1,9 @@
+//###########################################################################
+// FILE:   pm_stepper_cla_host.c
+// TITLE:  Host build of the CLA1 tasks
+//###########################################################################
+// gcc/clang do not know the .cla extension; the CLA C of the tasks is plain
+// C99 against host/hal/CLAmath.h, so it is compiled here as is.
+//###########################################################################
+
+#include "pm_stepper_cla.cla"
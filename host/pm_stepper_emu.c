@@ -0,0 +1,643 @@
+//###########################################################################
+// FILE:   pm_stepper_emu.c
+// TITLE:  Cycle-approximate emulation of the peripherals used by the firmware
+//###########################################################################
+
+#include <math.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+#include "pm_stepper_emu.h"
+
+#define EMU_PI 3.14159265358979323846
+#define EMU_NEVER (~(Uint64)0)
+
+// Events of one ePWM period, in the order the counter meets them
+#define PWM_ZERO 0
+#define PWM_CAU 1
+#define PWM_PRD 2
+#define PWM_CAD 3
+
+struct EMU_EPWM {
+	volatile struct EPWM_REGS *Regs;
+	int Instance;							// n of ePWMn, selects the ADC trigger
+	int Running;
+	Uint64 PeriodStart;						// Cycle of the last CTR=0
+	Uint32 Tbclk;							// SYSCLK cycles per TBCLK
+	Uint16 Mode;							// CTRMODE latched at CTR=0
+	Uint16 Prd;								// Active TBPRD
+	Uint16 Cmpa;							// Active CMPA
+	int Next;								// Next event of the period
+	Uint16 SocaCount;
+};
+
+struct EMU_ADC {
+	volatile struct ADC_REGS *Regs;
+	volatile struct ADC_RESULT_REGS *Results;
+	int Vector;								// PIE group 1 vector of ADCINT1
+	Uint16 DmaTrigger;						// DMACHSRCSEL value of ADCINT1
+	int Busy, Sampled;
+	int Soc;								// SOC being converted
+	int Last;								// Round-robin pointer
+	Uint64 SampleEnd, ConvEnd;
+	Uint16 Code;							// Held by the S/H
+};
+
+struct EMU_DMA {
+	volatile struct CH_REGS *Regs;
+	Uint16 Source;							// DMACHSRCSEL of the channel
+	int Pending;							// Triggered, burst at the end of the cycle
+};
+
+struct EMU_TIMER {
+	volatile struct CPUTIMER_REGS *Regs;
+	int Vector;								// -1 = not routed to PIE group 1
+	int Running;
+	Uint64 Start;							// Cycle at which TIM = PRD
+	Uint64 Next;							// Next underflow
+	Uint32 Prescale;
+};
+
+static struct {
+	struct EMU_CONFIG Config;
+	Uint64 Now;
+	Uint64 BusyUntil;						// CPU inside an ISR until then
+	struct EMU_EPWM Pwm[3];
+	struct EMU_ADC Adc[2];
+	struct EMU_DMA Dma[EMU_DMA_CHANNELS];
+	struct EMU_TIMER Timer[3];
+	int AckPending;							// PIE group 1 blocked until PIEACK
+	Uint64 FlagTime[EMU_VECTORS];
+	struct PLANT_STATE Plant;
+	Uint64 PlantCycle;
+	double Va, Vb;
+	struct EMU_STATS Stats;
+	jmp_buf Idle;
+} Emu;
+
+void FirmwareMain(void);
+
+void InitEmuConfig(struct EMU_CONFIG *Config){
+	int k;
+	memset(Config, 0, sizeof(*Config));
+	InitPlantParams(&Config->Plant);
+	Config->SysclkHz = 200e6;
+	Config->EpwmClkDiv = 2;
+	Config->CountsPerRev = 40000;
+	Config->AdcLsb = 0.000791452315;
+	Config->IntLatency = 14;
+	for (k=0; k<EMU_VECTORS; k++) Config->IsrCycles[k] = 60;
+	Config->IsrCycles[EMU_VECTOR_TIMER0] = 4000;
+	Config->PlantStep = 10e-6;
+}
+
+const struct EMU_STATS *EmuStats(void){
+	return &Emu.Stats;
+}
+
+const struct PLANT_STATE *EmuPlant(void){
+	return &Emu.Plant;
+}
+
+// A flag that stays set while its INTx is disabled is only a DMA or CLA
+// trigger, and is not counted as lost
+static void RaisePie(int Vector){
+	Uint16 Bit = 1 << Vector;
+	if (PieCtrlRegs.PIEIFR1.all & Bit){
+		if (PieCtrlRegs.PIEIER1.all & Bit) Emu.Stats.Vector[Vector].Lost++;
+		return;
+	}
+	PieCtrlRegs.PIEIFR1.all |= Bit;
+	Emu.FlagTime[Vector] = Emu.Now;
+}
+
+//---------------------------------------------------------------------------
+// Plant and power stage
+//
+static void AdvancePlant(Uint64 To){
+	double Left = (double)(To-Emu.PlantCycle)/Emu.Config.SysclkHz, h;
+	while (Left > 0){
+		h = (Left < Emu.Config.PlantStep) ? Left : Emu.Config.PlantStep;
+		StepPlant(&Emu.Config.Plant, &Emu.Plant, Emu.Va, Emu.Vb, h);
+		Left -= h;
+	}
+	Emu.PlantCycle = To;
+}
+
+// Period average of an up-down ePWM output with set/clear on CMPA
+static double Duty(const struct EMU_EPWM *p){
+	volatile struct EPWM_REGS *r = p->Regs;
+	double High;
+	if (!p->Running || p->Prd == 0) return 0;
+	High = (p->Cmpa >= p->Prd) ? 0 : (double)(p->Prd-p->Cmpa)/p->Prd;
+	if (r->AQCTLA.bit.CAU == AQ_SET && r->AQCTLA.bit.CAD == AQ_CLEAR) return High;
+	if (r->AQCTLA.bit.CAU == AQ_CLEAR && r->AQCTLA.bit.CAD == AQ_SET) return 1-High;
+	return 0;
+}
+
+static void UpdateDrive(void){
+	double Vbus = Emu.Config.Plant.Vbus;
+	Emu.Va = Duty(&Emu.Pwm[1])*(GpioDataRegs.GPADAT.bit.GPIO15 ? Vbus : -Vbus);
+	Emu.Vb = Duty(&Emu.Pwm[2])*(GpioDataRegs.GPADAT.bit.GPIO17 ? Vbus : -Vbus);
+}
+
+//---------------------------------------------------------------------------
+// DMA
+//
+// The address registers hold the low half of a host address
+// (F2837xS_device.h); the firmware data and the register mocks share the
+// upper half with DmaRegs
+static volatile Uint16 *DmaWord(Uint32 Address){
+	return (volatile Uint16 *)((((uintptr_t)&DmaRegs) & ~(uintptr_t)0xFFFFFFFFu) | Address);
+}
+
+static void TriggerDma(Uint16 Source){
+	int k;
+	for (k=0; k<EMU_DMA_CHANNELS; k++){
+		volatile struct CH_REGS *r = Emu.Dma[k].Regs;
+		if (Emu.Dma[k].Source != Source || !r->MODE.bit.PERINTE) continue;
+		if (r->CONTROL.bit.PERINTFLG) r->CONTROL.bit.OVRFLG = 1;
+		r->CONTROL.bit.PERINTFLG = 1;
+		Emu.Dma[k].Pending = 1;
+	}
+}
+
+// Word steps of the address registers, in host bytes
+static void DmaStep(volatile Uint32 *Address, int16 Step){
+	*Address += (Uint32)((int32)Step*(int32)sizeof(Uint16));
+}
+
+// One burst, as in the TRM: the shadow addresses take effect at the start
+// of a transfer; after each burst but the last the transfer step (or the
+// wrap) moves the addresses on. Bursts take no time, and there is no sync,
+// one-shot or channel interrupt
+static void RunDmaBurst(struct EMU_DMA *d){
+	volatile struct CH_REGS *r = d->Regs;
+	int Words = r->MODE.bit.DATASIZE ? 2 : 1, k;
+	d->Pending = 0;
+	r->CONTROL.bit.PERINTFLG = 0;
+	if (!r->CONTROL.bit.RUNSTS) return;
+	if (!r->CONTROL.bit.TRANSFERSTS){
+		r->SRC_BEG_ADDR_ACTIVE = r->SRC_BEG_ADDR_SHADOW;
+		r->SRC_ADDR_ACTIVE = r->SRC_ADDR_SHADOW;
+		r->DST_BEG_ADDR_ACTIVE = r->DST_BEG_ADDR_SHADOW;
+		r->DST_ADDR_ACTIVE = r->DST_ADDR_SHADOW;
+		r->TRANSFER_COUNT = r->TRANSFER_SIZE;
+		r->SRC_WRAP_COUNT = r->SRC_WRAP_SIZE;
+		r->DST_WRAP_COUNT = r->DST_WRAP_SIZE;
+		r->CONTROL.bit.TRANSFERSTS = 1;
+	}
+	for (r->BURST_COUNT = r->BURST_SIZE;; r->BURST_COUNT--){
+		for (k=0; k<Words; k++) DmaWord(r->DST_ADDR_ACTIVE)[k] = DmaWord(r->SRC_ADDR_ACTIVE)[k];
+		if (r->BURST_COUNT == 0) break;
+		DmaStep(&r->SRC_ADDR_ACTIVE, r->SRC_BURST_STEP);
+		DmaStep(&r->DST_ADDR_ACTIVE, r->DST_BURST_STEP);
+	}
+	Emu.Stats.DmaBursts[d-Emu.Dma]++;
+	Emu.Stats.LastDmaBurst = Emu.Now;
+	if (r->TRANSFER_COUNT == 0){
+		r->CONTROL.bit.TRANSFERSTS = 0;
+		if (!r->MODE.bit.CONTINUOUS) r->CONTROL.bit.RUNSTS = 0;
+		return;
+	}
+	r->TRANSFER_COUNT--;
+	if (r->SRC_WRAP_COUNT == 0){
+		r->SRC_WRAP_COUNT = r->SRC_WRAP_SIZE;
+		DmaStep(&r->SRC_BEG_ADDR_ACTIVE, r->SRC_WRAP_STEP);
+		r->SRC_ADDR_ACTIVE = r->SRC_BEG_ADDR_ACTIVE;
+	}
+	else {
+		r->SRC_WRAP_COUNT--;
+		DmaStep(&r->SRC_ADDR_ACTIVE, r->SRC_TRANSFER_STEP);
+	}
+	if (r->DST_WRAP_COUNT == 0){
+		r->DST_WRAP_COUNT = r->DST_WRAP_SIZE;
+		DmaStep(&r->DST_BEG_ADDR_ACTIVE, r->DST_WRAP_STEP);
+		r->DST_ADDR_ACTIVE = r->DST_BEG_ADDR_ACTIVE;
+	}
+	else {
+		r->DST_WRAP_COUNT--;
+		DmaStep(&r->DST_ADDR_ACTIVE, r->DST_TRANSFER_STEP);
+	}
+}
+
+// Run, halt and the write-one-to-clear bits; the trigger source select
+static void SyncDma(struct EMU_DMA *d, Uint16 Source){
+	volatile struct CH_REGS *r = d->Regs;
+	d->Source = Source;
+	if (r->CONTROL.bit.RUN){
+		r->CONTROL.bit.RUN = 0;
+		r->CONTROL.bit.RUNSTS = 1;
+	}
+	if (r->CONTROL.bit.HALT){
+		r->CONTROL.bit.HALT = 0;
+		r->CONTROL.bit.RUNSTS = 0;
+	}
+	if (r->CONTROL.bit.SOFTRESET){
+		r->CONTROL.bit.SOFTRESET = 0;
+		r->CONTROL.bit.TRANSFERSTS = 0;
+	}
+	if (r->CONTROL.bit.PERINTCLR){
+		r->CONTROL.bit.PERINTCLR = 0;
+		r->CONTROL.bit.PERINTFLG = 0;
+		d->Pending = 0;
+	}
+	if (r->CONTROL.bit.ERRCLR){
+		r->CONTROL.bit.ERRCLR = 0;
+		r->CONTROL.bit.OVRFLG = 0;
+	}
+	if (r->CONTROL.bit.PERINTFRC){
+		r->CONTROL.bit.PERINTFRC = 0;
+		r->CONTROL.bit.PERINTFLG = 1;
+		d->Pending = 1;
+	}
+}
+
+//---------------------------------------------------------------------------
+// ADC
+//
+static volatile union ADCSOCxCTL_REG *SocCtl(struct EMU_ADC *a, int Soc){
+	return &(&a->Regs->ADCSOC0CTL)[Soc];
+}
+
+static volatile Uint16 *Result(struct EMU_ADC *a, int Soc){
+	return &(&a->Results->ADCRESULT0)[Soc];
+}
+
+// Shunt + ADC: the magnitude of the phase current, channel 0 only
+static Uint16 ReadChannel(struct EMU_ADC *a, Uint16 Channel){
+	double I = (a == &Emu.Adc[0]) ? Emu.Plant.Ia : Emu.Plant.Ib;
+	double Code = fabs(I)*(1/Emu.Config.AdcLsb);
+	if (Channel != 0) return 0;
+	return (Code > 4095) ? 4095 : (Uint16)Code;
+}
+
+static void EndOfConversion(struct EMU_ADC *a, int Soc){
+	volatile struct ADC_REGS *r = a->Regs;
+	if (!r->ADCINTSEL1N2.bit.INT1E || r->ADCINTSEL1N2.bit.INT1SEL != Soc) return;
+	if (r->ADCINTFLG.bit.ADCINT1 && !r->ADCINTSEL1N2.bit.INT1CONT){
+		r->ADCINTOVF.bit.ADCINT1 = 1;
+		Emu.Stats.AdcOverflows[a-Emu.Adc]++;
+		return;
+	}
+	r->ADCINTFLG.bit.ADCINT1 = 1;
+	RaisePie(a->Vector);
+	TriggerDma(a->DmaTrigger);
+}
+
+static void StartConversion(struct EMU_ADC *a){
+	volatile struct ADC_REGS *r = a->Regs;
+	Uint32 Div = (r->ADCCTL2.bit.PRESCALE+2)/2;
+	double Conv = r->ADCCTL2.bit.RESOLUTION ? 29.5 : 10.5;	// ADCCLK cycles
+	int k, Soc;
+	if (a->Busy || r->ADCSOCFLG1.all == 0) return;
+	for (k=1; k<=16; k++){
+		Soc = (a->Last+k) & 15;
+		if (r->ADCSOCFLG1.all & (1 << Soc)) break;
+	}
+	r->ADCSOCFLG1.all &= ~(1 << Soc);
+	a->Busy = 1;
+	a->Sampled = 0;
+	a->Soc = Soc;
+	a->SampleEnd = Emu.Now+SocCtl(a, Soc)->bit.ACQPS+1;
+	a->ConvEnd = a->SampleEnd+(Uint64)(Conv*Div+0.5);
+}
+
+static void TriggerAdc(int Trigger){
+	int i, Soc;
+	for (i=0; i<2; i++){
+		struct EMU_ADC *a = &Emu.Adc[i];
+		if (!a->Regs->ADCCTL1.bit.ADCPWDNZ) continue;
+		for (Soc=0; Soc<16; Soc++){
+			if (SocCtl(a, Soc)->bit.TRIGSEL != Trigger) continue;
+			if (a->Regs->ADCSOCFLG1.all & (1 << Soc)) a->Regs->ADCSOCOVF1.all |= 1 << Soc;
+			a->Regs->ADCSOCFLG1.all |= 1 << Soc;
+		}
+		StartConversion(a);
+	}
+}
+
+static Uint64 AdcNext(const struct EMU_ADC *a){
+	if (!a->Busy) return EMU_NEVER;
+	return a->Sampled ? a->ConvEnd : a->SampleEnd;
+}
+
+static void RunAdc(struct EMU_ADC *a){
+	if (a->Busy && !a->Sampled && a->SampleEnd == Emu.Now){
+		a->Code = ReadChannel(a, SocCtl(a, a->Soc)->bit.CHSEL);
+		a->Sampled = 1;
+		if (!a->Regs->ADCCTL1.bit.INTPULSEPOS) EndOfConversion(a, a->Soc);
+	}
+	if (a->Busy && a->Sampled && a->ConvEnd == Emu.Now){
+		*Result(a, a->Soc) = a->Code;
+		a->Busy = 0;
+		a->Last = a->Soc;
+		if (a->Regs->ADCCTL1.bit.INTPULSEPOS) EndOfConversion(a, a->Soc);
+		StartConversion(a);
+	}
+}
+
+// Write-one-to-clear and force registers
+static void SyncAdc(struct EMU_ADC *a){
+	volatile struct ADC_REGS *r = a->Regs;
+	r->ADCINTFLG.all &= ~r->ADCINTFLGCLR.all;
+	r->ADCINTFLGCLR.all = 0;
+	r->ADCINTOVF.all &= ~r->ADCINTOVFCLR.all;
+	r->ADCINTOVFCLR.all = 0;
+	r->ADCSOCOVF1.all &= ~r->ADCSOCOVFCLR1.all;
+	r->ADCSOCOVFCLR1.all = 0;
+	if (r->ADCSOCFRC1.all){
+		r->ADCSOCFLG1.all |= r->ADCSOCFRC1.all;
+		r->ADCSOCFRC1.all = 0;
+	}
+	StartConversion(a);
+}
+
+//---------------------------------------------------------------------------
+// ePWM
+//
+// Counter value of an event, or -1 if the counter never meets it
+static long PwmOffset(const struct EMU_EPWM *p, int Event){
+	int UpDown = (p->Mode == TB_COUNT_UPDOWN);
+	switch (Event){
+	case PWM_ZERO: return 0;
+	case PWM_CAU: return (p->Cmpa <= p->Prd) ? p->Cmpa : -1;
+	case PWM_PRD: return p->Prd;
+	case PWM_CAD: return (UpDown && p->Cmpa <= p->Prd) ? 2L*p->Prd-p->Cmpa : -1;
+	}
+	return -1;
+}
+
+static long PwmLength(const struct EMU_EPWM *p){
+	return (p->Mode == TB_COUNT_UPDOWN) ? 2L*p->Prd : p->Prd+1L;
+}
+
+static Uint64 PwmNext(struct EMU_EPWM *p){
+	long Offset;
+	if (!p->Running || PwmLength(p) <= 0) return EMU_NEVER;
+	while (p->Next <= PWM_CAD && (Offset = PwmOffset(p, p->Next)) < 0) p->Next++;
+	if (p->Next > PWM_CAD){
+		p->PeriodStart += (Uint64)PwmLength(p)*p->Tbclk;
+		p->Next = PWM_ZERO;
+		Offset = 0;
+	}
+	return p->PeriodStart+(Uint64)Offset*p->Tbclk;
+}
+
+static void LoadCmpa(struct EMU_EPWM *p, int Event){
+	Uint16 Mode = p->Regs->CMPCTL.bit.LOADAMODE;
+	if (p->Regs->CMPCTL.bit.SHDWAMODE) return;
+	if ((Event == PWM_ZERO && (Mode == CC_CTR_ZERO || Mode == CC_CTR_ZERO_PRD))
+	 || (Event == PWM_PRD && (Mode == CC_CTR_PRD || Mode == CC_CTR_ZERO_PRD))){
+		p->Cmpa = p->Regs->CMPA.bit.CMPA;
+	}
+}
+
+static void Soca(struct EMU_EPWM *p, int Event){
+	volatile struct EPWM_REGS *r = p->Regs;
+	Uint16 Sel = r->ETSEL.bit.SOCASEL;
+	int Hit = (Sel == ET_CTR_ZERO && Event == PWM_ZERO) || (Sel == ET_CTR_PRD && Event == PWM_PRD)
+		   || (Sel == ET_CTR_PRDZERO && (Event == PWM_ZERO || Event == PWM_PRD))
+		   || (Sel == ET_CTRU_CMPA && Event == PWM_CAU) || (Sel == ET_CTRD_CMPA && Event == PWM_CAD);
+	if (!Hit || !r->ETSEL.bit.SOCAEN || r->ETPS.bit.SOCAPRD == 0) return;
+	if (++p->SocaCount < r->ETPS.bit.SOCAPRD){
+		r->ETPS.bit.SOCACNT = p->SocaCount;
+		return;
+	}
+	p->SocaCount = 0;
+	r->ETPS.bit.SOCACNT = 0;
+	r->ETFLG.bit.SOCA = 1;
+	Emu.Stats.Soca[p-Emu.Pwm]++;
+	TriggerAdc(5+2*(p->Instance-1));	// TRIGSEL of ePWMn SOCA
+}
+
+static void RunPwm(struct EMU_EPWM *p){
+	int Event = p->Next;
+	if (Event == PWM_ZERO){
+		if (!p->Regs->TBCTL.bit.PRDLD) p->Prd = p->Regs->TBPRD;
+		p->Mode = p->Regs->TBCTL.bit.CTRMODE;
+	}
+	LoadCmpa(p, Event);
+	Soca(p, Event);
+	p->Next++;
+}
+
+static Uint32 Tbclk(volatile struct EPWM_REGS *r){
+	Uint32 Hsp = r->TBCTL.bit.HSPCLKDIV ? 2*r->TBCTL.bit.HSPCLKDIV : 1;
+	return Emu.Config.EpwmClkDiv*Hsp*(1u << r->TBCTL.bit.CLKDIV);
+}
+
+// Start/stop on TBCLKSYNC and CTRMODE, immediate loads, TBCTR readback
+static void SyncPwm(struct EMU_EPWM *p){
+	volatile struct EPWM_REGS *r = p->Regs;
+	int Run = CpuSysRegs.PCLKCR0.bit.TBCLKSYNC && r->TBCTL.bit.CTRMODE != TB_FREEZE;
+	Uint64 Count;
+	if (Run && !p->Running){
+		p->Running = 1;
+		p->Tbclk = Tbclk(r);
+		p->Mode = r->TBCTL.bit.CTRMODE;
+		p->Prd = r->TBPRD;
+		p->Cmpa = r->CMPA.bit.CMPA;
+		p->PeriodStart = Emu.Now-(Uint64)r->TBCTR*p->Tbclk;
+		p->Next = PWM_ZERO;
+	}
+	else if (!Run) p->Running = 0;
+	if (!p->Running) return;
+	if (r->TBCTL.bit.PRDLD) p->Prd = r->TBPRD;
+	if (r->CMPCTL.bit.SHDWAMODE) p->Cmpa = r->CMPA.bit.CMPA;
+	Count = (Emu.Now-p->PeriodStart)/p->Tbclk;
+	if (p->Mode == TB_COUNT_UPDOWN && Count > p->Prd){
+		r->TBCTR = (Uint16)(2*p->Prd-Count);
+		r->TBSTS.bit.CTRDIR = 0;
+	}
+	else {
+		r->TBCTR = (Uint16)Count;
+		r->TBSTS.bit.CTRDIR = 1;
+	}
+}
+
+//---------------------------------------------------------------------------
+// CPU timers
+//
+static void SyncTimer(struct EMU_TIMER *t){
+	volatile struct CPUTIMER_REGS *r = t->Regs;
+	Uint64 Period;
+	t->Prescale = (((Uint32)r->TPRH.bit.TDDRH << 8) | r->TPR.bit.TDDR)+1;
+	Period = ((Uint64)r->PRD.all+1)*t->Prescale;
+	if (r->TCR.bit.TRB){
+		r->TCR.bit.TRB = 0;
+		r->TIM.all = r->PRD.all;
+		t->Start = Emu.Now;
+	}
+	if (r->TCR.bit.TSS){
+		t->Running = 0;
+		t->Next = EMU_NEVER;
+		return;
+	}
+	if (!t->Running){
+		t->Running = 1;
+		t->Start = Emu.Now-(Uint64)(r->PRD.all-r->TIM.all)*t->Prescale;
+	}
+	r->TIM.all = r->PRD.all-(Uint32)(((Emu.Now-t->Start)/t->Prescale) % ((Uint64)r->PRD.all+1));
+	t->Next = t->Start+((Emu.Now-t->Start)/Period+1)*Period;
+}
+
+static void RunTimer(struct EMU_TIMER *t){
+	t->Regs->TCR.bit.TIF = 1;
+	if (t->Vector >= 0 && t->Regs->TCR.bit.TIE) RaisePie(t->Vector);
+	SyncTimer(t);
+}
+
+//---------------------------------------------------------------------------
+// Register side effects of the code that just ran
+//
+static void SyncPeripherals(void){
+	volatile struct GPIO_DATA_REGS *g = &GpioDataRegs;
+	int k;
+	g->GPADAT.all = ((g->GPADAT.all | g->GPASET.all) & ~g->GPACLEAR.all) ^ g->GPATOGGLE.all;
+	g->GPASET.all = g->GPACLEAR.all = g->GPATOGGLE.all = 0;
+	for (k=0; k<3; k++) SyncPwm(&Emu.Pwm[k]);
+	for (k=0; k<3; k++) SyncTimer(&Emu.Timer[k]);
+	for (k=0; k<2; k++) SyncAdc(&Emu.Adc[k]);
+	for (k=0; k<EMU_DMA_CHANNELS; k++){
+		Uint32 Sel = (k < 4) ? DmaClaSrcSelRegs.DMACHSRCSEL1.all >> 8*k : DmaClaSrcSelRegs.DMACHSRCSEL2.all >> 8*(k-4);
+		SyncDma(&Emu.Dma[k], (Uint16)(Sel & 0xFF));
+	}
+	if (EQep1Regs.QEPCTL.bit.QPEN){
+		// The encoder counts down for positive rotation (CalcPosition negates)
+		EQep1Regs.QPOSCNT = -(int32)floor(Emu.Plant.Theta*(Emu.Config.CountsPerRev/(2*EMU_PI)));
+		EQep1Regs.QEPSTS.bit.QDF = (Emu.Plant.W < 0);
+	}
+}
+
+//---------------------------------------------------------------------------
+// PIE group 1
+//
+static int PendingVector(Uint64 *When){
+	Uint16 Ready;
+	int v;
+	if (!PieCtrlRegs.PIECTRL.bit.ENPIE || !(IER & M_INT1) || Emu.AckPending) return -1;
+	Ready = PieCtrlRegs.PIEIFR1.all & PieCtrlRegs.PIEIER1.all;
+	for (v=0; v<EMU_VECTORS; v++){
+		if (Ready & (1 << v)) break;
+	}
+	if (v == EMU_VECTORS) return -1;
+	*When = Emu.FlagTime[v]+Emu.Config.IntLatency;
+	if (*When < Emu.BusyUntil) *When = Emu.BusyUntil;
+	return v;
+}
+
+static void Dispatch(int v, EMU_TRACE Trace, void *User){
+	PINT Isr = ((PINT *)&PieVectTable)[v];
+	struct EMU_VECTOR_STATS *s = &Emu.Stats.Vector[v];
+	struct EMU_EVENT Event;
+
+	PieCtrlRegs.PIEIFR1.all &= ~(1 << v);
+	Emu.AckPending = 1;
+	Event.Cycle = Emu.Now;
+	Event.Vector = v;
+	Event.Latency = (Uint32)(Emu.Now-Emu.FlagTime[v]);
+	s->Count++;
+	s->SumLatency += Event.Latency;
+	if (Event.Latency > s->MaxLatency) s->MaxLatency = Event.Latency;
+	if (Trace) Trace(User, &Event);
+
+	SyncPeripherals();
+	PieCtrlRegs.PIEACK.all = 0;
+	HalIntm = 1;
+	if (Isr) Isr();
+	HalIntm = 0;
+	if (PieCtrlRegs.PIEACK.all & PIEACK_GROUP1) Emu.AckPending = 0;
+	PieCtrlRegs.PIEACK.all = 0;
+	SyncPeripherals();
+	UpdateDrive();
+	Emu.BusyUntil = Emu.Now+Emu.Config.IsrCycles[v];
+	Emu.Stats.BusyCycles += Emu.Config.IsrCycles[v];
+}
+
+//---------------------------------------------------------------------------
+// Boot and run
+//
+static void IdleHook(void){
+	longjmp(Emu.Idle, 1);
+}
+
+int BootEmulator(const struct EMU_CONFIG *Config){
+	static volatile struct EPWM_REGS *const PwmRegs[3] = {&EPwm1Regs, &EPwm7Regs, &EPwm9Regs};
+	static const int PwmInstance[3] = {1, 7, 9};
+	int k;
+
+	memset(&Emu, 0, sizeof(Emu));
+	Emu.Config = *Config;
+	HalReset();
+	InitPlant(&Emu.Plant);
+	for (k=0; k<3; k++){
+		Emu.Pwm[k].Regs = PwmRegs[k];
+		Emu.Pwm[k].Instance = PwmInstance[k];
+	}
+	Emu.Adc[0].Regs = &AdcaRegs;
+	Emu.Adc[0].Results = &AdcaResultRegs;
+	Emu.Adc[0].Vector = EMU_VECTOR_ADCA1;
+	Emu.Adc[1].Regs = &AdcbRegs;
+	Emu.Adc[1].Results = &AdcbResultRegs;
+	Emu.Adc[1].Vector = EMU_VECTOR_ADCB1;
+	Emu.Adc[0].DmaTrigger = DMA_ADCAINT1;
+	Emu.Adc[1].DmaTrigger = DMA_ADCBINT1;
+	for (k=0; k<EMU_DMA_CHANNELS; k++) Emu.Dma[k].Regs = &(&DmaRegs.CH1)[k];
+	for (k=0; k<2; k++) Emu.Adc[k].Last = 15;
+	Emu.Timer[0].Regs = &CpuTimer0Regs;
+	Emu.Timer[0].Vector = EMU_VECTOR_TIMER0;
+	Emu.Timer[1].Regs = &CpuTimer1Regs;
+	Emu.Timer[1].Vector = -1;
+	Emu.Timer[2].Regs = &CpuTimer2Regs;
+	Emu.Timer[2].Vector = -1;
+	for (k=0; k<3; k++) Emu.Timer[k].Next = EMU_NEVER;
+
+	// main() never returns: its idle loop hands control back here
+	HalIdleHook = IdleHook;
+	if (setjmp(Emu.Idle) == 0){
+		FirmwareMain();
+		HalIdleHook = NULL;
+		return -1;
+	}
+	HalIdleHook = NULL;
+	SyncPeripherals();
+	UpdateDrive();
+	return 0;
+}
+
+Uint64 RunEmulator(double Seconds, EMU_TRACE Trace, void *User){
+	Uint64 End = Emu.Now+(Uint64)(Seconds*Emu.Config.SysclkHz+0.5), Next, When;
+	int k, v, Busy;
+
+	while (!HalEstopCount){
+		Next = End;
+		for (k=0; k<3; k++) if ((When = PwmNext(&Emu.Pwm[k])) < Next) Next = When;
+		for (k=0; k<2; k++) if ((When = AdcNext(&Emu.Adc[k])) < Next) Next = When;
+		for (k=0; k<3; k++) if (Emu.Timer[k].Vector >= 0 && Emu.Timer[k].Next < Next) Next = Emu.Timer[k].Next;
+		if (!HalIntm && PendingVector(&When) >= 0 && When < Next) Next = When;
+		AdvancePlant(Next);
+		Emu.Now = Next;
+		if (Next == End) break;
+
+		// Peripherals first, so flags raised on this cycle are visible below
+		do {
+			Busy = 0;
+			for (k=0; k<3; k++){
+				if (PwmNext(&Emu.Pwm[k]) == Emu.Now){
+					RunPwm(&Emu.Pwm[k]);
+					Busy = 1;
+				}
+			}
+		} while (Busy);
+		for (k=0; k<2; k++) RunAdc(&Emu.Adc[k]);
+		// After both ADCs, so a burst on ADCA's end of conversion sees ADCB's result
+		for (k=0; k<EMU_DMA_CHANNELS; k++) if (Emu.Dma[k].Pending) RunDmaBurst(&Emu.Dma[k]);
+		for (k=0; k<3; k++) if (Emu.Timer[k].Vector >= 0 && Emu.Timer[k].Next == Emu.Now) RunTimer(&Emu.Timer[k]);
+		UpdateDrive();
+
+		if (!HalIntm && (v = PendingVector(&When)) >= 0 && When <= Emu.Now) Dispatch(v, Trace, User);
+	}
+	SyncPeripherals();
+	return Emu.Now;
+}
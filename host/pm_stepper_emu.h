@@ -0,0 +1,89 @@
+//###########################################################################
+// FILE:   pm_stepper_emu.h
+// TITLE:  Cycle-approximate emulation of the peripherals used by the firmware
+//###########################################################################
+// Runs the unmodified firmware (pm_stepper_firmware_host) against a timing
+// model of the parts of the F2837xS it uses, closed around the motor model:
+//  - ePWM1/7/9 time bases (up and up-down), TBPRD and CMPA shadow loads on
+//    zero/period, SOCA event selection and prescale.
+//  - ADCA/ADCB SOC triggers, round-robin conversion with the ACQPS window
+//    and the 12/16-bit conversion time, ADCINT1 with early/late pulse,
+//    continuous mode and overflow.
+//  - DMA CH1..CH6 on ADCAINT1/ADCBINT1: bursts with burst, transfer and
+//    wrap steps, continuous mode; each burst completes on its trigger cycle.
+//  - eQEP1 position counter, read as the x4 count of the rotor angle.
+//  - CPU Timer0/1/2 down counters; Timer0 raises PIE 1.7.
+//  - PIE group 1 dispatch: PIEIER1, PIEACK, IER and INTM, lowest INTx first,
+//    no nesting. An ISR's register accesses all happen at its entry; the
+//    CPU is then held for a configurable number of cycles.
+// Phase voltages are the period average of the ePWM7/ePWM9 duty, signed by
+// the GPIO15/GPIO17 direction pins; dead band is not modelled.
+// Time is counted in SYSCLK cycles. The firmware state is global, so only
+// one emulator exists per process.
+//###########################################################################
+
+#ifndef PM_STEPPER_EMU_H
+#define PM_STEPPER_EMU_H
+
+#include "F28x_Project.h"
+#include "pm_stepper_plant.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EMU_VECTORS 8						// PIE group 1, INTx1..INTx8
+#define EMU_VECTOR_ADCA1 0
+#define EMU_VECTOR_ADCB1 1
+#define EMU_VECTOR_TIMER0 6
+#define EMU_DMA_CHANNELS 6
+
+struct EMU_CONFIG {
+	struct PLANT_PARAMS Plant;				// Motor driven by ePWM7/ePWM9
+	double SysclkHz;						// 200 MHz, InitSysPll(XTAL_OSC, IMULT_20, ...)
+	int EpwmClkDiv;							// EPWMCLK = SYSCLK/EpwmClkDiv (2 out of reset)
+	int CountsPerRev;						// eQEP1 x4 counts per revolution
+	double AdcLsb;							// Amps per ADC code on the current shunts
+	Uint32 IntLatency;						// Cycles from PIE flag to the first ISR instruction
+	Uint32 IsrCycles[EMU_VECTORS];			// Cycles each group 1 ISR keeps the CPU busy
+	double PlantStep;						// Max plant integration step (s)
+};
+
+// One ISR dispatch
+struct EMU_EVENT {
+	Uint64 Cycle;							// Entry, SYSCLK cycles since boot
+	int Vector;								// INTx-1 in PIE group 1
+	Uint32 Latency;							// Cycles from PIE flag to entry
+};
+
+struct EMU_VECTOR_STATS {
+	long Count;								// ISR entries
+	long Lost;								// Flags raised, INTx enabled, while the previous one was still pending
+	Uint32 MaxLatency;						// (cycles)
+	double SumLatency;						// (cycles)
+};
+
+struct EMU_STATS {
+	struct EMU_VECTOR_STATS Vector[EMU_VECTORS];
+	long Soca[3];							// SOCA pulses of ePWM1, ePWM7, ePWM9
+	long AdcOverflows[2];					// ADCINT1 overflows of ADCA, ADCB
+	long DmaBursts[EMU_DMA_CHANNELS];		// Bursts of DMA CH1..CH6
+	Uint64 LastDmaBurst;					// Cycle of the last burst of any channel
+	Uint64 BusyCycles;						// CPU cycles spent in ISRs
+};
+
+typedef void (*EMU_TRACE)(void *User, const struct EMU_EVENT *Event);
+
+void InitEmuConfig(struct EMU_CONFIG *Config);
+// Resets the registers and runs the firmware main() up to its idle loop
+int BootEmulator(const struct EMU_CONFIG *Config);
+// Runs for Seconds, or until the firmware executes ESTOP0; returns the cycle reached
+Uint64 RunEmulator(double Seconds, EMU_TRACE Trace, void *User);
+const struct EMU_STATS *EmuStats(void);
+const struct PLANT_STATE *EmuPlant(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end of PM_STEPPER_EMU_H definition
@@ -0,0 +1,165 @@
+//###########################################################################
+// FILE:   pm_stepper_emu_main.c
+// TITLE:  Command line front end of the peripheral emulator
+//###########################################################################
+// Usage: pm_stepper_emu [-t seconds] [-v dispatches] [-d epwmclkdiv]
+//                       [-c timer0_isr_cycles] [-o dispatches.csv]
+//                       [-s svarray.dat] [-k gamma_k] [-e max_err]
+// Boots the firmware, runs it until ESTOP0 (or -t seconds) and prints
+// the rate and latency of every group 1 ISR, the DMA bursts, how old the
+// ADC currents are when cpu_timer0_isr runs, and the tracking error of the
+// motor model.
+// -v prints the first dispatches as they interleave. -s saves the SVArray
+// section as CCS would, for pm_stepper_replay.
+// After boot the ripple adaptation gains are set to -k (default
+// SIM_GAMMA_K, as pm_stepper_sim_cli), since the motor model drifts at the
+// firmware's GammakP/GammakA. The exit status is 1 when the final |ThetaT|
+// is above max_err (default SIM_MAX_ERR). The CLA build is not checked,
+// its law is not emulated.
+//###########################################################################
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pm_stepper_emu.h"
+#include "pm_stepper_replay.h"
+#include "pm_stepper_isr.h"
+#include "pm_stepper_sim.h"
+
+#if CONTROL_MATH == CONTROL_IQ
+#define DesiredTheta() _IQ20toF(Isr.ControllerIQ.ThetaD)
+#else
+#define DesiredTheta() Isr.Controller.ThetaD
+#endif
+extern float ThetaArray[SVARRAY_SIZE], DThetaArray[SVARRAY_SIZE], IaArray[SVARRAY_SIZE];
+extern float IbArray[SVARRAY_SIZE], VaArray[SVARRAY_SIZE], VbArray[SVARRAY_SIZE];
+
+static const char *const VectorName[EMU_VECTORS] = {
+	"adca1_isr", "adcb1_isr", "INTx3", "INTx4", "INTx5", "INTx6", "cpu_timer0_isr", "INTx8"
+};
+
+struct EMU_LOG {
+	FILE *Csv;
+	long Verbose;
+	double SysclkHz;
+	Uint64 LastEntry[EMU_VECTORS];
+	Uint64 MaxAge;						// adca1_isr or DMA burst to Timer0 ISR (cycles)
+	double SumAge;
+	long Ticks;
+};
+
+static void LogDispatch(void *User, const struct EMU_EVENT *e){
+	struct EMU_LOG *Log = (struct EMU_LOG *)User;
+	if (e->Vector == EMU_VECTOR_TIMER0){
+		// ADC_DMA builds: the tick reads the half of the last burst
+		Uint64 Sample = EmuStats()->LastDmaBurst ? EmuStats()->LastDmaBurst : Log->LastEntry[EMU_VECTOR_ADCA1];
+		Uint64 Age = e->Cycle-Sample;
+		if (Sample){
+			if (Age > Log->MaxAge) Log->MaxAge = Age;
+			Log->SumAge += Age;
+		}
+		Log->Ticks++;
+	}
+	Log->LastEntry[e->Vector] = e->Cycle;
+	if (Log->Verbose > 0){
+		printf("%12.3f us  %-15s latency %u\n", e->Cycle*1e6/Log->SysclkHz, VectorName[e->Vector], e->Latency);
+		Log->Verbose--;
+	}
+	if (Log->Csv) fprintf(Log->Csv, "%llu,%d,%u\n", (unsigned long long)e->Cycle, e->Vector, e->Latency);
+}
+
+static int SaveCapture(const char *Path){
+	static struct SVARRAY Sv;
+	memcpy(Sv.Signal[SV_THETA], ThetaArray, sizeof(ThetaArray));
+	memcpy(Sv.Signal[SV_DTHETA], DThetaArray, sizeof(DThetaArray));
+	memcpy(Sv.Signal[SV_IA], IaArray, sizeof(IaArray));
+	memcpy(Sv.Signal[SV_IB], IbArray, sizeof(IbArray));
+	memcpy(Sv.Signal[SV_VA], VaArray, sizeof(VaArray));
+	memcpy(Sv.Signal[SV_VB], VbArray, sizeof(VbArray));
+	return SaveSvArray(Path, NULL, &Sv, 0);
+}
+
+int main(int argc, char **argv){
+	struct EMU_CONFIG Config;
+	struct EMU_LOG Log;
+	const struct EMU_STATS *Stats;
+	const char *OutPath = NULL, *SvPath = NULL;
+	double Seconds = 1e9, MaxErr = SIM_MAX_ERR, GammaK = SIM_GAMMA_K, Elapsed, ThetaT;
+	Uint64 Cycles;
+	int a, k;
+
+	InitEmuConfig(&Config);
+	memset(&Log, 0, sizeof(Log));
+	for (a=1; a<argc; a++){
+		if (!strcmp(argv[a], "-t") && a+1<argc) Seconds = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-v") && a+1<argc) Log.Verbose = atol(argv[++a]);
+		else if (!strcmp(argv[a], "-d") && a+1<argc) Config.EpwmClkDiv = atoi(argv[++a]);
+		else if (!strcmp(argv[a], "-c") && a+1<argc) Config.IsrCycles[EMU_VECTOR_TIMER0] = atol(argv[++a]);
+		else if (!strcmp(argv[a], "-o") && a+1<argc) OutPath = argv[++a];
+		else if (!strcmp(argv[a], "-s") && a+1<argc) SvPath = argv[++a];
+		else if (!strcmp(argv[a], "-k") && a+1<argc) GammaK = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-e") && a+1<argc) MaxErr = atof(argv[++a]);
+		else {
+			fprintf(stderr, "usage: %s [-t seconds] [-v dispatches] [-d epwmclkdiv]"
+							" [-c timer0_isr_cycles] [-o dispatches.csv] [-s svarray.dat]"
+							" [-k gamma_k] [-e max_err]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (Config.EpwmClkDiv < 1) Config.EpwmClkDiv = 1;
+	Log.SysclkHz = Config.SysclkHz;
+	if (OutPath){
+		Log.Csv = fopen(OutPath, "w");
+		if (!Log.Csv){
+			perror(OutPath);
+			return 1;
+		}
+		fprintf(Log.Csv, "cycle,vector,latency\n");
+	}
+
+	if (BootEmulator(&Config) != 0){
+		fprintf(stderr, "firmware main() returned\n");
+		return 1;
+	}
+	Isr.Controller.Gains.gammaKP = Isr.Controller.Gains.gammaKA = GammaK;
+#if CONTROL_MATH == CONTROL_IQ
+	Isr.ControllerIQ.gammaKP = Isr.ControllerIQ.gammaKA = _IQ(GammaK);
+#endif
+	Cycles = RunEmulator(Seconds, LogDispatch, &Log);
+	Elapsed = Cycles/Config.SysclkHz;
+	Stats = EmuStats();
+
+	printf("emulated         %.6f s (%llu cycles)%s\n", Elapsed, (unsigned long long)Cycles,
+		   HalEstopCount ? ", stopped on ESTOP0" : "");
+	for (k=0; k<EMU_VECTORS; k++){
+		const struct EMU_VECTOR_STATS *s = &Stats->Vector[k];
+		if (!s->Count && !s->Lost) continue;
+		printf("%-16s %8ld calls %10.1f Hz  latency mean %6.1f max %6u cycles  lost %ld\n",
+			   VectorName[k], s->Count, Elapsed > 0 ? s->Count/Elapsed : 0,
+			   s->Count ? s->SumLatency/s->Count : 0, s->MaxLatency, s->Lost);
+	}
+	printf("SOCA pulses      ePWM1 %ld, ePWM7 %ld, ePWM9 %ld\n", Stats->Soca[0], Stats->Soca[1], Stats->Soca[2]);
+	printf("ADCINT1 overflow A %ld, B %ld\n", Stats->AdcOverflows[0], Stats->AdcOverflows[1]);
+	printf("DMA bursts       CH1 %ld, CH2 %ld\n", Stats->DmaBursts[0], Stats->DmaBursts[1]);
+	printf("CPU in ISRs      %.2f%%\n", Cycles ? 100.0*Stats->BusyCycles/Cycles : 0);
+	printf("Ia/Ib age at tick mean %.1f us, max %.1f us\n",
+		   Log.Ticks ? Log.SumAge/Log.Ticks*1e6/Config.SysclkHz : 0,
+		   Log.MaxAge*1e6/Config.SysclkHz);
+	ThetaT = EmuPlant()->Theta-DesiredTheta();
+	printf("ThetaT           %.6f rad (motor %.5f, desired %.5f)\n",
+		   ThetaT, EmuPlant()->Theta, DesiredTheta());
+	if (Log.Csv) fclose(Log.Csv);
+	if (SvPath && SaveCapture(SvPath) != 0){
+		perror(SvPath);
+		return 1;
+	}
+#if CONTROL_MATH != CONTROL_CLA
+	if (!isfinite(ThetaT) || fabs(ThetaT) > MaxErr){
+		printf("FAIL: final |ThetaT| above %g rad\n", MaxErr);
+		return 1;
+	}
+	printf("PASS: final |ThetaT| within %g rad\n", MaxErr);
+#endif
+	return 0;
+}
@@ -0,0 +1,160 @@
+//###########################################################################
+// FILE:   pm_stepper_iq_check.c
+// TITLE:  Equivalence of StepControllerIQ and StepController
+//###########################################################################
+// Usage: pm_stepper_iq_check [-t seconds] [-e ripple] [-v volts] [-o trace.csv]
+// Drives the float and the IQmath law with the same inputs for -t seconds
+// (default tf, at most 2*tf): the position follows the reference trajectory
+// plus a ripple of -e rad (default 0.01), quantized to encoder counts, and
+// is the same for both; each law's currents follow its own IaD/IbD of the
+// previous tick plus the same 50 mA of ripple, as behind an ideal current
+// loop. Feeding one law the currents of the other would leave its current
+// adaptation without feedback. Prints, per signal, the largest difference and
+// the float peak; exits 1 when a signal of either law is not finite or Va
+// or Vb differ by more than -v volts (default 0.1, 0.8% of Vmax). Most of
+// the difference is the float law's own: its time += Ts drifts 0.4 ms over
+// tf, so its ThetaD is 1.4 mrad off where the IQ trajectory is within
+// 0.06 mrad.
+//###########################################################################
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pm_stepper_control.h"
+#include "pm_stepper_control_iq.h"
+#include "pm_stepper_trig.h"
+
+#define CHECK_THETAD 0
+#define CHECK_DTHETA 1
+#define CHECK_DTHETAD 2
+#define CHECK_TAU 3
+#define CHECK_IAD 4
+#define CHECK_IBD 5
+#define CHECK_VA 6
+#define CHECK_VB 7
+#define CHECK_SIGNALS 8
+
+static const char *SignalNames[CHECK_SIGNALS] = {
+	"ThetaD", "DTheta", "DThetaD", "Tau", "IaD", "IbD", "Va", "Vb"
+};
+
+struct CHECK_RESULT {
+	double MaxDiff[CHECK_SIGNALS];			// max |IQ-float|
+	double Peak[CHECK_SIGNALS];				// max |float|
+	long WorstTick[CHECK_SIGNALS];
+	long NonFinite;							// Signals found NaN or inf
+	long FirstNonFinite;					// Tick of the first one
+};
+
+static void Compare(struct CHECK_RESULT *r, int Signal, long Tick, double Float, double Fixed){
+	double d;
+	if (!isfinite(Float) || !isfinite(Fixed)){
+		if (!r->NonFinite++) r->FirstNonFinite = Tick;
+		return;
+	}
+	d = fabs(Fixed-Float);
+	if (fabs(Float) > r->Peak[Signal]) r->Peak[Signal] = fabs(Float);
+	if (d > r->MaxDiff[Signal]){
+		r->MaxDiff[Signal] = d;
+		r->WorstTick[Signal] = Tick;
+	}
+}
+
+static void RunCheck(double Tf, double Ripple, struct CHECK_RESULT *r, FILE *Trace){
+	static struct CONTROLLER_STATE Ctrl;
+	static struct CONTROLLER_IQ_STATE CtrlIQ;
+	struct CONTROLLER_INPUTS In;
+	struct CONTROLLER_OUTPUTS Out;
+	struct CONTROLLER_IQ_INPUTS InIQ;
+	struct CONTROLLER_IQ_OUTPUTS OutIQ;
+	struct POSITION_STATE Position;
+	float Ia=0, Ib=0, IaIQ=0, IbIQ=0;
+	double t;
+	long Tick, Ticks = (long)(Tf*CTRL_ITS+0.5), Counts;
+
+	memset(r, 0, sizeof(*r));
+	InitController(&Ctrl);
+	InitControllerIQ(&CtrlIQ, &Ctrl.Gains);
+	for (Tick=0; Tick<Ticks; Tick++){
+		t = (Tick+1)*CTRL_TS;
+		Counts = CalcCounts(CalcPosDesired(t)+Ripple*(sin(7*t)+0.2*sin(90*t)));
+		if (Tick == 0) InitPosition(&Position, Counts);
+		else UpdatePosition(&Position, Counts);
+		In.Theta = CalcPosition(&Position);
+		In.Tooth = InIQ.Tooth = Position.Tooth;
+		In.Pole = InIQ.Pole = Position.Pole;
+		In.Ia = Ia;
+		In.Ib = Ib;
+		InIQ.Theta = CalcPositionIQ(&Position);
+		InIQ.Ia = FloatToIQ(IaIQ);
+		InIQ.Ib = FloatToIQ(IbIQ);
+		StepController(&Ctrl, &In, &Out);
+		StepControllerIQ(&CtrlIQ, &InIQ, &OutIQ);
+
+		Compare(r, CHECK_THETAD, Tick, Ctrl.ThetaD, _IQ20toF(CtrlIQ.ThetaD));
+		Compare(r, CHECK_DTHETA, Tick, Ctrl.DTheta, _IQ20toF(CtrlIQ.DTheta));
+		Compare(r, CHECK_DTHETAD, Tick, Ctrl.DThetaD, _IQ20toF(CtrlIQ.DThetaD));
+		Compare(r, CHECK_TAU, Tick, Ctrl.Tau, _IQtoF(CtrlIQ.Tau));
+		Compare(r, CHECK_IAD, Tick, Ctrl.IaD, _IQtoF(CtrlIQ.IaD));
+		Compare(r, CHECK_IBD, Tick, Ctrl.IbD, _IQtoF(CtrlIQ.IbD));
+		Compare(r, CHECK_VA, Tick, Out.Va, _IQtoF(OutIQ.Va));
+		Compare(r, CHECK_VB, Tick, Out.Vb, _IQtoF(OutIQ.Vb));
+		if (Trace){
+			fprintf(Trace, "%.3f,%.5f,%.5f,%.5f,%.5f,%.4f,%.4f,%.4f,%.4f\n", t, In.Theta,
+					Ctrl.Tau, _IQtoF(CtrlIQ.Tau), Ctrl.IaD, Out.Va, _IQtoF(OutIQ.Va), Out.Vb, _IQtoF(OutIQ.Vb));
+		}
+
+		Ia = Ctrl.IaD+0.05f*sin(300*t);
+		Ib = Ctrl.IbD+0.05f*cos(300*t);
+		IaIQ = _IQtoF(CtrlIQ.IaD)+0.05f*sin(300*t);
+		IbIQ = _IQtoF(CtrlIQ.IbD)+0.05f*cos(300*t);
+	}
+}
+
+int main(int argc, char **argv){
+	struct CHECK_RESULT Result;
+	const char *TracePath = NULL;
+	FILE *Trace = NULL;
+	double Tf = CTRL_TF, Ripple = 0.01, Tolerance = 0.1;
+	int a, i;
+
+	for (a=1; a<argc; a++){
+		if (!strcmp(argv[a], "-t") && a+1<argc) Tf = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-e") && a+1<argc) Ripple = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-v") && a+1<argc) Tolerance = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-o") && a+1<argc) TracePath = argv[++a];
+		else Tf = 0;
+		if (Tf <= 0 || Tf > 2*CTRL_TF){
+			fprintf(stderr, "usage: %s [-t seconds] [-e ripple] [-v volts] [-o trace.csv]\n", argv[0]);
+			return 2;
+		}
+	}
+	InitTrigTable();
+	if (TracePath){
+		if (!(Trace = fopen(TracePath, "w"))){
+			perror(TracePath);
+			return 2;
+		}
+		fprintf(Trace, "time,Theta,Tau,TauIQ,IaD,Va,VaIQ,Vb,VbIQ\n");
+	}
+
+	RunCheck(Tf, Ripple, &Result, Trace);
+	if (Trace) fclose(Trace);
+
+	printf("signal     max |IQ-float|   float peak   relative   at t (s)\n");
+	for (i=0; i<CHECK_SIGNALS; i++){
+		printf("%-10s %14.3e %12.4f %9.3f%% %10.3f\n", SignalNames[i], Result.MaxDiff[i], Result.Peak[i],
+			   Result.Peak[i] > 0 ? 100*Result.MaxDiff[i]/Result.Peak[i] : 0, (Result.WorstTick[i]+1)*CTRL_TS);
+	}
+	if (Result.NonFinite){
+		printf("FAIL: %ld non-finite signals from t=%.3f s\n", Result.NonFinite, (Result.FirstNonFinite+1)*CTRL_TS);
+		return 1;
+	}
+	if (Result.MaxDiff[CHECK_VA] > Tolerance || Result.MaxDiff[CHECK_VB] > Tolerance){
+		printf("FAIL: Va/Vb differ by more than %g V\n", Tolerance);
+		return 1;
+	}
+	printf("PASS: Va/Vb within %g V\n", Tolerance);
+	return 0;
+}
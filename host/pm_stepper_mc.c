@@ -0,0 +1,87 @@
+//###########################################################################
+// FILE:   pm_stepper_mc.c
+// TITLE:  Monte Carlo robustness sweep of the closed-loop simulation
+//###########################################################################
+
+#include <string.h>
+#include "work_pool.h"
+#include "pm_stepper_mc.h"
+
+struct MC_JOB {
+	const struct MC_CONFIG *Config;
+	struct MC_RUN *Runs;
+};
+
+void InitMcConfig(struct MC_CONFIG *Config){
+	memset(Config, 0, sizeof(*Config));
+	InitSimConfig(&Config->Nominal);
+	Config->PlantSpread = 0.2;
+	Config->GainSpread = 0.2;
+	Config->Runs = 1000;
+	Config->Seed = 1;
+}
+
+// splitmix64: one independent stream per run
+static unsigned long long NextRandom(unsigned long long *s){
+	unsigned long long z = (*s += 0x9E3779B97F4A7C15ULL);
+	z = (z^(z>>30))*0xBF58476D1CE4E5B9ULL;
+	z = (z^(z>>27))*0x94D049BB133111EBULL;
+	return z^(z>>31);
+}
+
+// Nominal*(1+u*Spread), u uniform in [-1, 1)
+static double Perturb(unsigned long long *s, double Nominal, double Spread){
+	double u = (NextRandom(s)>>11)*(2.0/9007199254740992.0)-1.0;
+	return Nominal*(1.0+u*Spread);
+}
+
+void DrawMcRun(const struct MC_CONFIG *Config, long Index, struct SIM_CONFIG *Sim){
+	unsigned long long s = Config->Seed^((unsigned long long)Index*0xD1B54A32D192ED03ULL);
+	struct PLANT_PARAMS *P = &Sim->Plant;
+	struct CONTROLLER_GAINS *G = &Sim->Gains;
+	double Ps = Config->PlantSpread, Gs = Config->GainSpread;
+
+	*Sim = Config->Nominal;
+	P->Jr = Perturb(&s, P->Jr, Ps);
+	P->Br = Perturb(&s, P->Br, Ps);
+	P->Rph = Perturb(&s, P->Rph, Ps);
+	P->Lph = Perturb(&s, P->Lph, Ps);
+	P->Kt = Perturb(&s, P->Kt, Ps);
+	G->kp = Perturb(&s, G->kp, Gs);
+	G->kd = Perturb(&s, G->kd, Gs);
+	G->alphaA = Perturb(&s, G->alphaA, Gs);
+	G->alphaB = Perturb(&s, G->alphaB, Gs);
+	G->gamma2 = Perturb(&s, G->gamma2, Gs);
+	G->gamma5 = Perturb(&s, G->gamma5, Gs);
+	G->gammaKP = Perturb(&s, G->gammaKP, Gs);
+	G->gammaKA = Perturb(&s, G->gammaKA, Gs);
+	G->gammaP = Perturb(&s, G->gammaP, Gs);
+}
+
+static void McWorker(void *Arg, long Index){
+	struct MC_JOB *Job = (struct MC_JOB *)Arg;
+	struct MC_RUN *Run = &Job->Runs[Index];
+	struct SIM_CONFIG Sim;
+	struct SIM_RESULT Result;
+
+	DrawMcRun(Job->Config, Index, &Sim);
+	RunSimulation(&Sim, &Result, NULL, NULL);
+	Run->Jr = Sim.Plant.Jr;
+	Run->Br = Sim.Plant.Br;
+	Run->Rph = Sim.Plant.Rph;
+	Run->Lph = Sim.Plant.Lph;
+	Run->Kt = Sim.Plant.Kt;
+	Run->Gains = Sim.Gains;
+	Run->RmsThetaErr = Result.RmsThetaErr;
+	Run->MaxThetaErr = Result.MaxThetaErr;
+	Run->PeakCurrent = Result.PeakCurrent;
+	Run->SatTime = Result.SatTime;
+	Run->Diverged = Result.Diverged;
+}
+
+int RunMonteCarlo(const struct MC_CONFIG *Config, struct MC_RUN *Runs){
+	struct MC_JOB Job;
+	Job.Config = Config;
+	Job.Runs = Runs;
+	return RunWorkPool(Config->Threads, Config->Runs, McWorker, &Job);
+}
@@ -0,0 +1,47 @@
+//###########################################################################
+// FILE:   pm_stepper_mc.h
+// TITLE:  Monte Carlo robustness sweep of the closed-loop simulation
+//###########################################################################
+// Every run draws J, b, R, L, km of the motor and the Controller Gains
+// uniformly within +/- a relative spread of their nominal values and runs
+// a full closed-loop simulation. The controller keeps using the nominal
+// System Constants, as the firmware would on a production unit. Draws only
+// depend on (Seed, run index), so results do not depend on thread count.
+//###########################################################################
+
+#ifndef PM_STEPPER_MC_H
+#define PM_STEPPER_MC_H
+
+#include "pm_stepper_sim.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct MC_CONFIG {
+	struct SIM_CONFIG Nominal;			// Motor, gains and run length before perturbation
+	double PlantSpread;					// Relative spread of J, b, R, L, km (0.2 = +/-20%)
+	double GainSpread;					// Relative spread of every gain
+	long Runs;
+	unsigned long long Seed;
+	int Threads;						// 0 = one per online core
+};
+
+struct MC_RUN {
+	float Jr, Br, Rph, Lph, Kt;			// Motor parameters used
+	struct CONTROLLER_GAINS Gains;		// Gains used
+	float RmsThetaErr, MaxThetaErr;		// Tracking error (rad)
+	float PeakCurrent;					// (A)
+	float SatTime;						// (s)
+	int Diverged;
+};
+
+void InitMcConfig(struct MC_CONFIG *Config);
+void DrawMcRun(const struct MC_CONFIG *Config, long Index, struct SIM_CONFIG *Sim);
+int RunMonteCarlo(const struct MC_CONFIG *Config, struct MC_RUN *Runs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end of PM_STEPPER_MC_H definition
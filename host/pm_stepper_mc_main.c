@@ -0,0 +1,142 @@
+//###########################################################################
+// FILE:   pm_stepper_mc_main.c
+// TITLE:  Command line front end of the Monte Carlo robustness sweep
+//###########################################################################
+// Usage: pm_stepper_mc [-n runs] [-j threads] [-p plant_spread]
+//                      [-g gain_spread] [-k gamma_k] [-t tf] [-S seed]
+//                      [-e max_err] [-o results.csv]
+// Prints percentiles of tracking error, peak current and saturation time
+// over all runs, and optionally writes one CSV line per run. The nominal
+// gains are those of pm_stepper_sim_cli; -k sets its ripple adaptation
+// gains, e.g. to the firmware's GammakP/GammakA.
+// The unperturbed motor and gains run first: if that run diverges or its
+// max |ThetaT| is above max_err (default SIM_MAX_ERR) the sweep would only
+// measure the nominal failure, so it is not run and the exit status is 1.
+//###########################################################################
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "work_pool.h"
+#include "pm_stepper_mc.h"
+#include "pm_stepper_trig.h"
+
+static int CompareFloat(const void *a, const void *c){
+	float x = *(const float *)a, y = *(const float *)c;
+	return (x > y)-(x < y);
+}
+
+// mean, p50, p95 and max of one metric over the runs that did not diverge
+static void PrintMetric(const char *Name, const char *Unit, float *v, long n){
+	double Sum = 0;
+	long k;
+	if (n == 0){
+		printf("%-16s no finite runs\n", Name);
+		return;
+	}
+	qsort(v, n, sizeof(*v), CompareFloat);
+	for (k=0; k<n; k++) Sum += v[k];
+	printf("%-16s mean %-11.5g p50 %-11.5g p95 %-11.5g max %-11.5g %s\n",
+		   Name, Sum/n, v[n/2], v[(long)(0.95*(n-1))], v[n-1], Unit);
+}
+
+static void WriteRuns(FILE *f, const struct MC_RUN *Runs, long n){
+	long k;
+	fprintf(f, "run,J,b,R,L,km,Kp,Kd,AlphaA,AlphaB,Gamma2,Gamma5,GammakP,GammakA,gamma,"
+			   "rms_err,max_err,peak_i,sat_time,diverged\n");
+	for (k=0; k<n; k++){
+		const struct MC_RUN *r = &Runs[k];
+		const struct CONTROLLER_GAINS *g = &r->Gains;
+		fprintf(f, "%ld,%.5g,%.5g,%.5g,%.5g,%.5g,%.5g,%.5g,%.5g,%.5g,%.5g,%.5g,%.5g,%.5g,%.5g,"
+				   "%.5g,%.5g,%.5g,%.4g,%d\n",
+				k, r->Jr, r->Br, r->Rph, r->Lph, r->Kt,
+				g->kp, g->kd, g->alphaA, g->alphaB, g->gamma2, g->gamma5, g->gammaKP, g->gammaKA, g->gammaP,
+				r->RmsThetaErr, r->MaxThetaErr, r->PeakCurrent, r->SatTime, r->Diverged);
+	}
+}
+
+int main(int argc, char **argv){
+	struct MC_CONFIG Config;
+	struct MC_RUN *Runs;
+	struct SIM_RESULT Nominal;
+	float *Metric;
+	const char *OutPath = NULL;
+	double MaxErr = SIM_MAX_ERR, Elapsed;
+	long k, n, Diverged = 0, Failed = 0;
+	struct timespec t0, t1;
+	int a;
+
+	InitTrigTable();
+	InitMcConfig(&Config);
+	for (a=1; a<argc; a++){
+		if (!strcmp(argv[a], "-n") && a+1<argc) Config.Runs = atol(argv[++a]);
+		else if (!strcmp(argv[a], "-j") && a+1<argc) Config.Threads = atoi(argv[++a]);
+		else if (!strcmp(argv[a], "-p") && a+1<argc) Config.PlantSpread = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-g") && a+1<argc) Config.GainSpread = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-k") && a+1<argc) Config.Nominal.Gains.gammaKP = Config.Nominal.Gains.gammaKA = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-t") && a+1<argc) Config.Nominal.Tf = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-S") && a+1<argc) Config.Seed = strtoull(argv[++a], NULL, 0);
+		else if (!strcmp(argv[a], "-e") && a+1<argc) MaxErr = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-o") && a+1<argc) OutPath = argv[++a];
+		else {
+			fprintf(stderr, "usage: %s [-n runs] [-j threads] [-p plant_spread] [-g gain_spread]"
+							" [-k gamma_k] [-t tf] [-S seed] [-e max_err] [-o results.csv]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (Config.Runs < 1) Config.Runs = 1;
+	RunSimulation(&Config.Nominal, &Nominal, NULL, NULL);
+	printf("nominal          max |ThetaT| %.5g rad%s\n", Nominal.MaxThetaErr, Nominal.Diverged ? " (diverged)" : "");
+	if (Nominal.Diverged || Nominal.MaxThetaErr > MaxErr){
+		printf("FAIL: the nominal run is not within %g rad, no sweep\n", MaxErr);
+		return 1;
+	}
+	Runs = calloc(Config.Runs, sizeof(*Runs));
+	Metric = calloc(Config.Runs, sizeof(*Metric));
+	if (!Runs || !Metric){
+		fprintf(stderr, "out of memory\n");
+		return 1;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	if (RunMonteCarlo(&Config, Runs) != 0){
+		fprintf(stderr, "could not start all worker threads\n");
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	Elapsed = (t1.tv_sec-t0.tv_sec)+(t1.tv_nsec-t0.tv_nsec)*1e-9;
+
+	for (k=0; k<Config.Runs; k++){
+		if (Runs[k].Diverged) Diverged++;
+		if (Runs[k].Diverged || Runs[k].MaxThetaErr > MaxErr) Failed++;
+	}
+	printf("runs             %ld (%d threads, %.2f s, %.0f runs/s)\n", Config.Runs,
+		   Config.Threads > 0 ? Config.Threads : WorkPoolDefaultThreads(), Elapsed,
+		   Elapsed > 0 ? Config.Runs/Elapsed : 0);
+	printf("spread           plant +/-%.0f%%, gains +/-%.0f%%, seed %llu\n",
+		   Config.PlantSpread*100, Config.GainSpread*100, Config.Seed);
+	printf("diverged         %ld\n", Diverged);
+	printf("max err > %-6g %ld (%.1f%%)\n", MaxErr, Failed, 100.0*Failed/Config.Runs);
+
+	for (n=0, k=0; k<Config.Runs; k++) if (!Runs[k].Diverged) Metric[n++] = Runs[k].RmsThetaErr;
+	PrintMetric("rms ThetaT", "rad", Metric, n);
+	for (n=0, k=0; k<Config.Runs; k++) if (!Runs[k].Diverged) Metric[n++] = Runs[k].MaxThetaErr;
+	PrintMetric("max |ThetaT|", "rad", Metric, n);
+	for (n=0, k=0; k<Config.Runs; k++) if (!Runs[k].Diverged) Metric[n++] = Runs[k].PeakCurrent;
+	PrintMetric("peak current", "A", Metric, n);
+	for (n=0, k=0; k<Config.Runs; k++) if (!Runs[k].Diverged) Metric[n++] = Runs[k].SatTime;
+	PrintMetric("saturated", "s", Metric, n);
+
+	if (OutPath){
+		FILE *f = fopen(OutPath, "w");
+		if (!f){
+			perror(OutPath);
+			return 1;
+		}
+		WriteRuns(f, Runs, Config.Runs);
+		fclose(f);
+	}
+	free(Runs);
+	free(Metric);
+	return 0;
+}
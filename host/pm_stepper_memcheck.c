@@ -0,0 +1,522 @@
+//###########################################################################
+// FILE:   pm_stepper_memcheck.c
+// TITLE:  Memory usage report and budget check of a C2000 link
+//###########################################################################
+// Usage: pm_stepper_memcheck [-b budget] [-A] [-v] <name>.map | <name>_linkInfo.xml
+// Reads the linker map or the --xml_link_info data-base of the CCS build
+// and prints, for RAMLS* and RAMGS* (-A: every memory area), the used and
+// free words, the output sections placed there and the words each object
+// file takes (-v: down to its input sections).
+// With -b every rule of the budget file is checked; it holds lines
+//     area <name> <limit>
+//     section <name> <limit>
+// where <name> may end in '*' and <limit> is in words (0x.. or decimal) or
+// a percentage of the memory area, e.g. "area RAMLS* 95%". Overlapping
+// memory areas, or output sections in RAM, are always errors. The exit
+// status is 1 on any error, so the tool can run as a CCS post-build step.
+//###########################################################################
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MEM_MAX_AREAS 256
+#define MEM_MAX_SECTIONS 1024
+#define MEM_MAX_PIECES 8192
+#define MEM_MAX_OBJECTS 256
+
+struct MEM_AREA {
+	char Name[48];
+	int Page;
+	unsigned long Origin, Length, Used;
+};
+
+struct MEM_SECTION {
+	char Name[64];
+	int Page;
+	unsigned long Origin, Length;
+	int Area;								// Index in Areas, -1 if outside all of them
+};
+
+struct MEM_PIECE {
+	int Section;
+	char Object[96];						// "file.obj" or "lib.lib(member.obj)", "--HOLE--" for fill
+	char Input[64];							// Input section
+	unsigned long Origin, Length;
+};
+
+struct MEM_LINK {
+	char Linker[80];
+	struct MEM_AREA Areas[MEM_MAX_AREAS];
+	struct MEM_SECTION Sections[MEM_MAX_SECTIONS];
+	struct MEM_PIECE Pieces[MEM_MAX_PIECES];
+	int AreaCount, SectionCount, PieceCount;
+};
+
+static struct MEM_LINK Link;
+
+static char *ReadFile(const char *Path){
+	FILE *f = fopen(Path, "rb");
+	char *Text;
+	long Size;
+
+	if (!f) return NULL;
+	fseek(f, 0, SEEK_END);
+	Size = ftell(f);
+	rewind(f);
+	Text = calloc(Size+1, 1);
+	if (Text && fread(Text, 1, Size, f) != (size_t)Size){
+		free(Text);
+		Text = NULL;
+	}
+	fclose(f);
+	return Text;
+}
+
+static void Copy(char *Out, size_t Size, const char *p, size_t n){
+	if (n >= Size) n = Size-1;
+	memcpy(Out, p, n);
+	Out[n] = 0;
+}
+
+static int FindArea(int Page, unsigned long Address){
+	int i;
+	for (i=0; i<Link.AreaCount; i++){
+		const struct MEM_AREA *a = &Link.Areas[i];
+		if (a->Page == Page && Address >= a->Origin && Address < a->Origin+a->Length) return i;
+	}
+	return -1;
+}
+
+static struct MEM_SECTION *AddSection(const char *Name, int Page, unsigned long Origin, unsigned long Length){
+	struct MEM_SECTION *s;
+	if (Link.SectionCount >= MEM_MAX_SECTIONS) return NULL;
+	s = &Link.Sections[Link.SectionCount++];
+	Copy(s->Name, sizeof(s->Name), Name, strlen(Name));
+	s->Page = Page;
+	s->Origin = Origin;
+	s->Length = Length;
+	s->Area = FindArea(Page, Origin);
+	return s;
+}
+
+static void AddPiece(const char *Object, const char *Input, unsigned long Origin, unsigned long Length){
+	struct MEM_PIECE *p;
+	if (Link.PieceCount >= MEM_MAX_PIECES || !Link.SectionCount) return;
+	p = &Link.Pieces[Link.PieceCount++];
+	p->Section = Link.SectionCount-1;
+	Copy(p->Object, sizeof(p->Object), Object, strlen(Object));
+	Copy(p->Input, sizeof(p->Input), Input, strlen(Input));
+	p->Origin = Origin;
+	p->Length = Length;
+}
+
+//---------------------------------------------------------------------------
+// Linker map: MEMORY CONFIGURATION and SECTION ALLOCATION MAP
+//
+static int ParseMap(char *Text){
+	char *Line, *Next, *Rest, Name[64] = "", Lib[64] = "", Object[96], Input[64];
+	enum {NONE, MEMORY, SECTIONS} Part = NONE;
+	unsigned long Origin, Length, Used;
+	int Page = 0, Skip = 0, n;
+
+	for (Line=Text; Line && *Line; Line=Next){
+		Next = strchr(Line, '\n');
+		if (Next) *Next++ = 0;
+		n = (int)strlen(Line);
+		if (n && Line[n-1] == '\r') Line[n-1] = 0;
+
+		if (strstr(Line, "TMS320C2000 Linker")){
+			Rest = Line+strspn(Line, " ");
+			Copy(Link.Linker, sizeof(Link.Linker), Rest, strcspn(Rest, "\r\n"));
+			while (strlen(Link.Linker) && Link.Linker[strlen(Link.Linker)-1] == ' ') Link.Linker[strlen(Link.Linker)-1] = 0;
+		}
+		else if (!strncmp(Line, "MEMORY CONFIGURATION", 20)) Part = MEMORY;
+		else if (!strncmp(Line, "SECTION ALLOCATION MAP", 22)) Part = SECTIONS;
+		else if (!strncmp(Line, "GLOBAL SYMBOLS", 14) || !strncmp(Line, "LINKER GENERATED", 16)) Part = NONE;
+		else if (Part == MEMORY){
+			if (sscanf(Line, " PAGE %d", &Page) == 1) continue;
+			if (Link.AreaCount < MEM_MAX_AREAS &&
+				sscanf(Line, " %47s %lx %lx %lx", Name, &Origin, &Length, &Used) == 4){
+				struct MEM_AREA *a = &Link.Areas[Link.AreaCount++];
+				strcpy(a->Name, Name);
+				a->Page = Page;
+				a->Origin = Origin;
+				a->Length = Length;
+				a->Used = Used;
+			}
+		}
+		else if (Part == SECTIONS){
+			// "name page origin length [attr]", the name alone on the line before a '*' when long
+			if (Line[0] && !isspace((unsigned char)Line[0])){
+				char Attr[32] = "";
+				if (Line[0] != '*') sscanf(Line, "%63s", Name);
+				if (sscanf(Line+strcspn(Line, " \t"), " %d %lx %lx %31s", &Page, &Origin, &Length, Attr) >= 3){
+					// DSECT and COPY sections take no memory of their own
+					Skip = !strcmp(Attr, "DSECT") || !strcmp(Attr, "COPY") || Length == 0;
+					if (!Skip) AddSection(Name, Page, Origin, Length);
+				}
+				continue;
+			}
+			if (Skip || sscanf(Line, " %lx %lx %n", &Origin, &Length, &n) < 2) continue;
+			Rest = Line+n;
+			Input[0] = 0;
+			if (!strncmp(Rest, "--HOLE--", 8)) strcpy(Object, "--HOLE--");
+			else {
+				char *Paren = strrchr(Rest, '(');
+				char *Colon = strstr(Rest, " : ");
+				if (Paren) Copy(Input, sizeof(Input), Paren+1, strcspn(Paren+1, ")"));
+				if (Rest[0] == ':' || Colon){
+					// "lib : member (sect)", or ": member (sect)" continuing the last library
+					char *Member = (Rest[0] == ':') ? Rest+1 : Colon+3;
+					if (Rest[0] != ':') Copy(Lib, sizeof(Lib), Rest, Colon-Rest);
+					Member += strspn(Member, " ");
+					snprintf(Object, sizeof(Object), "%s(%.*s)", Lib, (int)strcspn(Member, " ("), Member);
+				}
+				else Copy(Object, sizeof(Object), Rest, strcspn(Rest, " ("));
+			}
+			AddPiece(Object, Input, Origin, Length);
+		}
+	}
+	return Link.AreaCount ? 0 : -1;
+}
+
+//---------------------------------------------------------------------------
+// linkInfo XML: placement_map areas -> logical groups -> object components
+//
+struct XML_RANGE {
+	const char *Begin, *End;
+};
+
+// Next <Tag ...>...</Tag> at or after p and before End
+static int XmlElement(const char *p, const char *End, const char *Tag, struct XML_RANGE *r){
+	char Open[48], Close[48];
+	size_t n;
+	snprintf(Open, sizeof(Open), "<%s", Tag);
+	snprintf(Close, sizeof(Close), "</%s>", Tag);
+	n = strlen(Open);
+	for (;;){
+		p = strstr(p, Open);
+		if (!p || p >= End) return 0;
+		if (p[n] == '>' || p[n] == ' ') break;
+		p += n;
+	}
+	r->Begin = p;
+	r->End = strstr(p, Close);
+	if (!r->End || r->End > End){
+		// Empty element such as <input_file_ref idref="fl-4"/>
+		r->End = strchr(p, '>');
+		if (!r->End || r->End > End) return 0;
+	}
+	return 1;
+}
+
+static int XmlText(const struct XML_RANGE *r, const char *Tag, char *Out, size_t Size){
+	struct XML_RANGE t;
+	const char *s;
+	if (!XmlElement(r->Begin, r->End, Tag, &t)) return 0;
+	s = strchr(t.Begin, '>');
+	if (!s || s >= t.End) return 0;
+	s++;
+	Copy(Out, Size, s, t.End-s);
+	return 1;
+}
+
+static unsigned long XmlNumber(const struct XML_RANGE *r, const char *Tag){
+	char Text[32];
+	return XmlText(r, Tag, Text, sizeof(Text)) ? strtoul(Text, NULL, 0) : 0;
+}
+
+static int XmlAttribute(const char *p, const char *End, const char *Name, char *Out, size_t Size){
+	char Key[32];
+	const char *q, *Tag = strchr(p, '>');
+	snprintf(Key, sizeof(Key), " %s=\"", Name);
+	q = strstr(p, Key);
+	if (!q || q > End || (Tag && q > Tag)) return 0;
+	q += strlen(Key);
+	Copy(Out, Size, q, strcspn(q, "\""));
+	return 1;
+}
+
+// Element with id="Id" among the Tag elements of List
+static int XmlFindId(const struct XML_RANGE *List, const char *Tag, const char *Id, struct XML_RANGE *r){
+	const char *p = List->Begin;
+	char Found[32];
+	while (XmlElement(p, List->End, Tag, r)){
+		if (XmlAttribute(r->Begin, r->End, "id", Found, sizeof(Found)) && !strcmp(Found, Id)) return 1;
+		p = r->End;
+	}
+	return 0;
+}
+
+static void AddGroupContents(const struct XML_RANGE *Doc, const struct XML_RANGE *Group, int Depth){
+	struct XML_RANGE Contents, Ref, FileRef, Oc, Files, File, Components, Groups, Sub;
+	char Id[32], Name[64], Kind[16], FileName[48], Member[44], Object[96];
+	const char *p;
+
+	if (Depth > 8 || !XmlElement(Group->Begin, Group->End, "contents", &Contents)) return;
+	XmlElement(Doc->Begin, Doc->End, "object_component_list", &Components);
+	for (p=Contents.Begin; XmlElement(p, Contents.End, "object_component_ref", &Ref); p=Ref.End){
+		if (!XmlAttribute(Ref.Begin, Ref.End, "idref", Id, sizeof(Id)) || !XmlFindId(&Components, "object_component", Id, &Oc)) continue;
+		XmlText(&Oc, "name", Name, sizeof(Name));
+		strcpy(Object, "?");
+		if (XmlElement(Oc.Begin, Oc.End, "input_file_ref", &FileRef) && XmlAttribute(FileRef.Begin, FileRef.End, "idref", Id, sizeof(Id)) &&
+			XmlElement(Doc->Begin, Doc->End, "input_file_list", &Files) && XmlFindId(&Files, "input_file", Id, &File)){
+			Kind[0] = 0;
+			XmlText(&File, "kind", Kind, sizeof(Kind));
+			XmlText(&File, "file", FileName, sizeof(FileName));
+			XmlText(&File, "name", Member, sizeof(Member));
+			if (!strcmp(Kind, "archive")) snprintf(Object, sizeof(Object), "%s(%s)", FileName, Member);
+			else snprintf(Object, sizeof(Object), "%s", Member);
+		}
+		AddPiece(Object, Name, XmlNumber(&Oc, "run_address"), XmlNumber(&Oc, "size"));
+	}
+	// Groups nested in groups
+	XmlElement(Doc->Begin, Doc->End, "logical_group_list", &Groups);
+	for (p=Contents.Begin; XmlElement(p, Contents.End, "logical_group_ref", &Ref); p=Ref.End){
+		if (XmlAttribute(Ref.Begin, Ref.End, "idref", Id, sizeof(Id)) && XmlFindId(&Groups, "logical_group", Id, &Sub)){
+			AddGroupContents(Doc, &Sub, Depth+1);
+		}
+	}
+}
+
+static int ParseLinkInfo(const char *Text){
+	struct XML_RANGE Doc = {Text, Text+strlen(Text)}, Map, Area, Details, Space, Ref, Groups, Group;
+	char Id[32], Name[64];
+	const char *p, *q;
+	int Page;
+
+	XmlText(&Doc, "banner", Link.Linker, sizeof(Link.Linker));
+	if (!XmlElement(Doc.Begin, Doc.End, "placement_map", &Map) ||
+		!XmlElement(Doc.Begin, Doc.End, "logical_group_list", &Groups)) return -1;
+	// All areas first, so sections find theirs
+	for (p=Map.Begin; XmlElement(p, Map.End, "memory_area", &Area) && Link.AreaCount < MEM_MAX_AREAS; p=Area.End){
+		struct MEM_AREA *a = &Link.Areas[Link.AreaCount++];
+		XmlText(&Area, "name", a->Name, sizeof(a->Name));
+		a->Page = (int)XmlNumber(&Area, "page_id");
+		a->Origin = XmlNumber(&Area, "origin");
+		a->Length = XmlNumber(&Area, "length");
+		a->Used = XmlNumber(&Area, "used_space");
+	}
+	for (p=Map.Begin; XmlElement(p, Map.End, "memory_area", &Area); p=Area.End){
+		Page = (int)XmlNumber(&Area, "page_id");
+		if (!XmlElement(Area.Begin, Area.End, "usage_details", &Details)) continue;
+		for (q=Details.Begin; XmlElement(q, Details.End, "allocated_space", &Space); q=Space.End){
+			if (!XmlElement(Space.Begin, Space.End, "logical_group_ref", &Ref) ||
+				!XmlAttribute(Ref.Begin, Ref.End, "idref", Id, sizeof(Id))) continue;
+			Name[0] = 0;
+			if (XmlFindId(&Groups, "logical_group", Id, &Group)) XmlText(&Group, "name", Name, sizeof(Name));
+			if (!AddSection(Name[0] ? Name : Id, Page, XmlNumber(&Space, "start_address"), XmlNumber(&Space, "size"))) break;
+			if (Name[0]) AddGroupContents(&Doc, &Group, 0);
+		}
+	}
+	return Link.AreaCount ? 0 : -1;
+}
+
+//---------------------------------------------------------------------------
+// Report and checks
+//
+static int Match(const char *Pattern, const char *Name){
+	size_t n = strlen(Pattern);
+	if (n && Pattern[n-1] == '*') return !strncmp(Pattern, Name, n-1);
+	return !strcmp(Pattern, Name);
+}
+
+static int Shown(const struct MEM_AREA *a, int All){
+	return All || Match("RAMLS*", a->Name) || Match("RAMGS*", a->Name);
+}
+
+struct MEM_OBJECT {
+	const char *Name;
+	unsigned long Words;
+};
+
+static int ByWords(const void *x, const void *y){
+	const struct MEM_OBJECT *a = x, *b_ = y;
+	return (a->Words < b_->Words) - (a->Words > b_->Words);
+}
+
+static void PrintArea(int Index, int Verbose){
+	const struct MEM_AREA *a = &Link.Areas[Index];
+	struct MEM_OBJECT Objects[MEM_MAX_OBJECTS];
+	int i, k, Count = 0;
+
+	printf("%-14s %4d  0x%05lx  0x%05lx  0x%05lx  0x%05lx  %5.1f%%\n", a->Name, a->Page, a->Origin, a->Length,
+		   a->Used, a->Length-a->Used, a->Length ? 100.0*a->Used/a->Length : 0);
+	for (i=0; i<Link.SectionCount; i++){
+		const struct MEM_SECTION *s = &Link.Sections[i];
+		if (s->Area != Index) continue;
+		printf("    %-28s  0x%05lx  0x%05lx\n", s->Name, s->Origin, s->Length);
+		for (k=0; k<Link.PieceCount; k++){
+			const struct MEM_PIECE *p = &Link.Pieces[k];
+			if (p->Section != i) continue;
+			if (Verbose) printf("        %-40s %-16s 0x%05lx\n", p->Object, p->Input, p->Length);
+		}
+	}
+	// Words per object file over all sections of the area
+	for (k=0; k<Link.PieceCount; k++){
+		const struct MEM_PIECE *p = &Link.Pieces[k];
+		if (Link.Sections[p->Section].Area != Index) continue;
+		for (i=0; i<Count && strcmp(Objects[i].Name, p->Object); i++);
+		if (i == Count){
+			if (Count == MEM_MAX_OBJECTS) continue;
+			Objects[Count].Name = p->Object;
+			Objects[Count++].Words = 0;
+		}
+		Objects[i].Words += p->Length;
+	}
+	qsort(Objects, Count, sizeof(Objects[0]), ByWords);
+	for (i=0; i<Count; i++) printf("      %-40s 0x%05lx\n", Objects[i].Name, Objects[i].Words);
+}
+
+// "1234", "0x4d2" or "95%" of Whole
+static int ParseLimit(const char *Text, unsigned long Whole, unsigned long *Limit){
+	char *End;
+	double v = strtod(Text, &End);
+	if (End == Text) return 0;
+	if (*End == '%'){
+		*Limit = (unsigned long)(Whole*v/100);
+		return 1;
+	}
+	*Limit = strtoul(Text, &End, 0);
+	return *End == 0;
+}
+
+static int CheckBudget(const char *Path){
+	FILE *f = fopen(Path, "r");
+	char Line[256], Kind[16], Name[64], Limit[32];
+	unsigned long Max;
+	int Errors = 0, i, Hit, LineNo = 0;
+
+	if (!f){
+		perror(Path);
+		return -1;
+	}
+	while (fgets(Line, sizeof(Line), f)){
+		LineNo++;
+		if (Line[strspn(Line, " \t")] == '#' || sscanf(Line, "%15s %63s %31s", Kind, Name, Limit) != 3) continue;
+		Hit = 0;
+		if (!strcmp(Kind, "area")){
+			for (i=0; i<Link.AreaCount; i++){
+				const struct MEM_AREA *a = &Link.Areas[i];
+				if (!Match(Name, a->Name)) continue;
+				Hit = 1;
+				if (!ParseLimit(Limit, a->Length, &Max)) break;
+				if (a->Used > Max){
+					printf("over budget: area %s uses 0x%lx of 0x%lx words, limit %s (0x%lx)\n",
+						   a->Name, a->Used, a->Length, Limit, Max);
+					Errors++;
+				}
+			}
+		}
+		else if (!strcmp(Kind, "section")){
+			for (i=0; i<Link.SectionCount; i++){
+				const struct MEM_SECTION *s = &Link.Sections[i];
+				unsigned long Whole = (s->Area >= 0) ? Link.Areas[s->Area].Length : 0;
+				if (!Match(Name, s->Name)) continue;
+				Hit = 1;
+				if (!ParseLimit(Limit, Whole, &Max)) break;
+				if (s->Length > Max){
+					printf("over budget: section %s takes 0x%lx words, limit %s (0x%lx)\n", s->Name, s->Length, Limit, Max);
+					Errors++;
+				}
+			}
+		}
+		else {
+			fprintf(stderr, "%s:%d: expected area or section\n", Path, LineNo);
+			Errors++;
+			continue;
+		}
+		if (Hit && !ParseLimit(Limit, 1, &Max)){
+			fprintf(stderr, "%s:%d: bad limit %s\n", Path, LineNo, Limit);
+			Errors++;
+		}
+		else if (!Hit) printf("budget: no %s matches %s\n", Kind, Name);
+	}
+	fclose(f);
+	return Errors;
+}
+
+// Linker command files can give two areas the same words; the link then succeeds.
+// Sections are only compared within RAM*: the header files alias some
+// boot ROM variables onto peripheral frames on purpose.
+static int CheckOverlaps(void){
+	int i, k, Errors = 0;
+	for (i=0; i<Link.AreaCount; i++){
+		for (k=i+1; k<Link.AreaCount; k++){
+			const struct MEM_AREA *a = &Link.Areas[i], *o = &Link.Areas[k];
+			if (a->Page != o->Page || !a->Length || !o->Length) continue;
+			if (a->Origin < o->Origin+o->Length && o->Origin < a->Origin+a->Length){
+				printf("overlap: areas %s and %s on page %d\n", a->Name, o->Name, a->Page);
+				Errors++;
+			}
+		}
+	}
+	for (i=0; i<Link.SectionCount; i++){
+		for (k=i+1; k<Link.SectionCount; k++){
+			const struct MEM_SECTION *s = &Link.Sections[i], *o = &Link.Sections[k];
+			if (s->Page != o->Page || s->Area < 0 || o->Area < 0 ||
+				!Match("RAM*", Link.Areas[s->Area].Name) || !Match("RAM*", Link.Areas[o->Area].Name)) continue;
+			if (s->Origin < o->Origin+o->Length && o->Origin < s->Origin+s->Length){
+				printf("overlap: sections %s (0x%lx+0x%lx) and %s (0x%lx+0x%lx) on page %d\n",
+					   s->Name, s->Origin, s->Length, o->Name, o->Origin, o->Length, s->Page);
+				Errors++;
+			}
+		}
+	}
+	return Errors;
+}
+
+int main(int argc, char **argv){
+	const char *Path = NULL, *Budget = NULL;
+	int a, i, All = 0, Verbose = 0, Errors, Failed;
+	char *Text;
+	size_t n;
+
+	for (a=1; a<argc; a++){
+		if (!strcmp(argv[a], "-b") && a+1<argc) Budget = argv[++a];
+		else if (!strcmp(argv[a], "-A")) All = 1;
+		else if (!strcmp(argv[a], "-v")) Verbose = 1;
+		else if (argv[a][0] != '-' && !Path) Path = argv[a];
+		else {
+			Path = NULL;
+			break;
+		}
+	}
+	if (!Path){
+		fprintf(stderr, "usage: %s [-b budget] [-A] [-v] <name>.map | <name>_linkInfo.xml\n", argv[0]);
+		return 2;
+	}
+	Text = ReadFile(Path);
+	if (!Text){
+		perror(Path);
+		return 2;
+	}
+	n = strlen(Path);
+	Failed = (n > 4 && !strcmp(Path+n-4, ".xml")) ? ParseLinkInfo(Text) : ParseMap(Text);
+	if (Failed){
+		fprintf(stderr, "%s: no memory configuration found\n", Path);
+		free(Text);
+		return 2;
+	}
+
+	printf("%s (%s)\n\n", Path, Link.Linker);
+	printf("area           page  origin   length   used     free     used\n");
+	for (i=0; i<Link.AreaCount; i++){
+		if (Shown(&Link.Areas[i], All)) PrintArea(i, Verbose);
+	}
+	printf("\n");
+	Errors = CheckOverlaps();
+	if (Budget){
+		Failed = CheckBudget(Budget);
+		if (Failed < 0){
+			free(Text);
+			return 2;
+		}
+		Errors += Failed;
+	}
+	printf("%d error%s\n", Errors, (Errors == 1) ? "" : "s");
+	free(Text);
+	return Errors ? 1 : 0;
+}
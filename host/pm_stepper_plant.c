@@ -0,0 +1,60 @@
+//###########################################################################
+// FILE:   pm_stepper_plant.c
+// TITLE:  Two-phase PM stepper motor model for host simulation
+//###########################################################################
+
+#include <math.h>
+#include <string.h>
+#include "pm_stepper_plant.h"
+#include "pm_stepper_control.h"
+
+// Nominal values are the firmware System Constants
+void InitPlantParams(struct PLANT_PARAMS *Params){
+	memset(Params, 0, sizeof(*Params));
+	Params->Rph = CTRL_R;
+	Params->Lph = CTRL_L;
+	Params->Kt = CTRL_KM;
+	Params->Jr = CTRL_J;
+	Params->Br = CTRL_B;
+	Params->Teeth = CTRL_NR;
+	Params->Poles = CTRL_NP;
+	Params->Vbus = CTRL_VMAX;
+}
+
+void InitPlant(struct PLANT_STATE *State){
+	memset(State, 0, sizeof(*State));
+}
+
+static void PlantDerivatives(const struct PLANT_PARAMS *P, const struct PLANT_STATE *X, double Va, double Vb, struct PLANT_STATE *dX){
+	double seno = sin(P->Teeth*X->Theta);
+	double cose = cos(P->Teeth*X->Theta);
+	double Tm = P->Kt*(-X->Ia*seno+X->Ib*cose);
+	double Td = 0;
+	int k;
+	for (k=0; k<PLANT_HARMONICS; k++){
+		if (P->TdC[k] != 0 || P->TdS[k] != 0){
+			double e = (k+1)*P->Poles*X->Theta;
+			Td += P->TdC[k]*cos(e)+P->TdS[k]*sin(e);
+		}
+	}
+	dX->Ia = (Va-P->Rph*X->Ia+P->Kt*X->W*seno)/P->Lph;
+	dX->Ib = (Vb-P->Rph*X->Ib-P->Kt*X->W*cose)/P->Lph;
+	dX->Theta = X->W;
+	dX->W = (Tm-P->Br*X->W-Td)/P->Jr;
+}
+
+// One explicit midpoint (RK2) step of length h with Va/Vb held constant.
+// Stable for h well below L/R (1.2 ms for the nominal motor).
+void StepPlant(const struct PLANT_PARAMS *Params, struct PLANT_STATE *State, double Va, double Vb, double h){
+	struct PLANT_STATE k1, mid;
+	PlantDerivatives(Params, State, Va, Vb, &k1);
+	mid.Ia = State->Ia+0.5*h*k1.Ia;
+	mid.Ib = State->Ib+0.5*h*k1.Ib;
+	mid.Theta = State->Theta+0.5*h*k1.Theta;
+	mid.W = State->W+0.5*h*k1.W;
+	PlantDerivatives(Params, &mid, Va, Vb, &k1);
+	State->Ia += h*k1.Ia;
+	State->Ib += h*k1.Ib;
+	State->Theta += h*k1.Theta;
+	State->W += h*k1.W;
+}
@@ -0,0 +1,50 @@
+//###########################################################################
+// FILE:   pm_stepper_plant.h
+// TITLE:  Two-phase PM stepper motor model for host simulation
+//###########################################################################
+// Electrical and mechanical equations, written with the same sign
+// conventions as the control law:
+//   L*dIa/dt = Va - R*Ia + km*w*sin(Nr*theta)
+//   L*dIb/dt = Vb - R*Ib - km*w*cos(Nr*theta)
+//   J*dw/dt  = km*(-Ia*sin(Nr*theta) + Ib*cos(Nr*theta)) - b*w - Td(theta)
+// Td is an optional detent/ripple torque on the same np harmonics that the
+// controller estimates with gammakP/gammakA.
+//###########################################################################
+
+#ifndef PM_STEPPER_PLANT_H
+#define PM_STEPPER_PLANT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PLANT_HARMONICS 3
+
+struct PLANT_PARAMS {
+	double Rph;							// Phase Winding Resistance (Ohm)
+	double Lph;							// Phase Winding Inductance (H)
+	double Kt;							// Motor Torque Constant (N*m/A)
+	double Jr;							// Rotor Inertia (kg*m^2)
+	double Br;							// Rotor Damping (N*m/(rad/s))
+	int Teeth;							// Number of teeth
+	int Poles;							// Number of poles
+	double Vbus;						// Bus voltage (V)
+	double TdC[PLANT_HARMONICS];		// Ripple torque, cos((k+1)*np*theta) terms (N*m)
+	double TdS[PLANT_HARMONICS];		// Ripple torque, sin((k+1)*np*theta) terms (N*m)
+};
+
+struct PLANT_STATE {
+	double Ia, Ib;						// Phase currents (A)
+	double Theta;						// Rotor position (rad)
+	double W;							// Rotor speed (rad/s)
+};
+
+void InitPlantParams(struct PLANT_PARAMS *Params);
+void InitPlant(struct PLANT_STATE *State);
+void StepPlant(const struct PLANT_PARAMS *Params, struct PLANT_STATE *State, double Va, double Vb, double h);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end of PM_STEPPER_PLANT_H definition
@@ -0,0 +1,121 @@
+//###########################################################################
+// FILE:   pm_stepper_profile_main.c
+// TITLE:  Report of the cpu_timer0_isr section profile saved from the target
+//###########################################################################
+// Usage: pm_stepper_profile [-q] profile.dat
+// profile.dat is the Profile variable saved from the CCS Memory Browser
+// (TI Data hex or raw binary, 16 or 32-bit words, PROFILE_WORDS 32-bit
+// words long). Prints min/mean/max cycles and the share of the control
+// period per section, the headroom left by the worst tick and, unless -q,
+// the histograms. The ADC ISRs are not profiled: their load comes on top.
+//###########################################################################
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pm_stepper_profile.h"
+#include "pm_stepper_replay.h"
+
+static const char *SectionNames[PROFILE_SECTIONS] = {
+	"latency", "sensing", "trig", "controller", "adaptation", "pwm", "logging", "isr"
+};
+
+// Fields in declaration order, each 32-bit value stored low word first
+static int LoadProfile(const char *Path, struct PROFILE *p){
+	uint16_t Words[2*PROFILE_WORDS];
+	uint32_t v[PROFILE_WORDS];
+	long n = ReadCaptureWords(Path, Words, 2*PROFILE_WORDS);
+	const uint32_t *w = v;
+	int i, k;
+
+	memset(p, 0, sizeof(*p));
+	if (n != 2*(long)PROFILE_WORDS) return (n < 0) ? (int)n : -3;
+	for (i=0; i<(int)PROFILE_WORDS; i++) v[i] = Words[2*i] | ((uint32_t)Words[2*i+1] << 16);
+	p->Magic = *w++;
+	p->TimerHz = *w++;
+	p->PeriodCycles = *w++;
+	p->Overhead = *w++;
+	for (i=0; i<PROFILE_SECTIONS; i++){
+		struct PROFILE_SECTION *s = &p->Section[i];
+		s->Count = *w++;
+		s->Min = *w++;
+		s->Max = *w++;
+		s->BinShift = *w++;
+		s->Sum = w[0] | ((uint64_t)w[1] << 32);
+		w += 2;
+		for (k=0; k<PROFILE_BINS; k++) s->Hist[k] = *w++;
+	}
+	return 0;
+}
+
+static void PrintHistogram(const char *Name, const struct PROFILE_SECTION *s){
+	uint32_t Peak = 0, Width = 1UL << s->BinShift;
+	int k, Bar;
+
+	for (k=0; k<PROFILE_BINS; k++) if (s->Hist[k] > Peak) Peak = s->Hist[k];
+	printf("\n%s (bins of %lu cycles)\n", Name, (unsigned long)Width);
+	for (k=0; k<PROFILE_BINS; k++){
+		if (!s->Hist[k]) continue;
+		Bar = (int)((50.0*s->Hist[k]+Peak-1)/Peak);
+		printf("  %7lu-%-7lu %9lu %.*s\n", (unsigned long)(k*Width), (unsigned long)((k+1)*Width-1),
+			   (unsigned long)s->Hist[k], Bar, "##################################################");
+	}
+}
+
+int main(int argc, char **argv){
+	struct PROFILE p;
+	const char *Path = NULL;
+	double Us, Worst;
+	int a, i, Quiet = 0, Err;
+
+	for (a=1; a<argc; a++){
+		if (!strcmp(argv[a], "-q")) Quiet = 1;
+		else if (argv[a][0] != '-' && !Path) Path = argv[a];
+		else {
+			Path = NULL;
+			break;
+		}
+	}
+	if (!Path){
+		fprintf(stderr, "usage: %s [-q] profile.dat\n", argv[0]);
+		return 2;
+	}
+	Err = LoadProfile(Path, &p);
+	if (Err){
+		fprintf(stderr, "%s: %s\n", Path, (Err == -1) ? "cannot read" :
+				(Err == -2) ? "not TI Data hex" : "not the size of Profile");
+		return 2;
+	}
+	if (p.Magic != PROFILE_MAGIC || !p.TimerHz || !p.PeriodCycles){
+		fprintf(stderr, "%s: Profile not initialized (InitProfile not run or PROFILE_ENABLE 0)\n", Path);
+		return 2;
+	}
+
+	Us = 1e6/p.TimerHz;
+	printf("%lu ticks of %lu cycles (%.1f Hz at %.0f MHz), %lu cycles per section boundary\n\n",
+		   (unsigned long)p.Section[PROFILE_ISR].Count, (unsigned long)p.PeriodCycles,
+		   (double)p.TimerHz/p.PeriodCycles, p.TimerHz*1e-6, (unsigned long)p.Overhead);
+	printf("section        min    mean     max  max (us)  max %% of tick\n");
+	for (i=0; i<PROFILE_SECTIONS; i++){
+		const struct PROFILE_SECTION *s = &p.Section[i];
+		if (!s->Count){
+			printf("%-10s %7s\n", SectionNames[i], "-");
+			continue;
+		}
+		printf("%-10s %7lu %7.0f %7lu %9.2f %14.2f\n", SectionNames[i], (unsigned long)s->Min,
+			   (double)s->Sum/s->Count, (unsigned long)s->Max, s->Max*Us, 100.0*s->Max/p.PeriodCycles);
+	}
+
+	// Worst entry latency plus worst body: what a faster tick must still fit
+	Worst = (double)p.Section[PROFILE_LATENCY].Max+p.Section[PROFILE_ISR].Max;
+	printf("\nworst tick %.0f cycles (%.1f us, %.1f%% of the period), headroom %.0f cycles\n",
+		   Worst, Worst*Us, 100.0*Worst/p.PeriodCycles, p.PeriodCycles-Worst);
+	if (Worst > 0) printf("control rate limit %.1f kHz, before the ADC ISRs and any margin\n", p.TimerHz/Worst*1e-3);
+
+	if (!Quiet){
+		for (i=0; i<PROFILE_SECTIONS; i++){
+			if (p.Section[i].Count) PrintHistogram(SectionNames[i], &p.Section[i]);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,166 @@
+//###########################################################################
+// FILE:   pm_stepper_replay.c
+// TITLE:  Replay of SVArray captures through the host-built controller
+//###########################################################################
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pm_stepper_replay.h"
+
+#define SVARRAY_WORDS (SVARRAY_SIGNALS*SVARRAY_SIZE*2)	// 16-bit words in the section
+
+static const int DeclarationOrder[SVARRAY_SIGNALS] = {SV_THETA, SV_DTHETA, SV_IA, SV_IB, SV_VA, SV_VB};
+
+// TI Data: "1651 1 <addr> <page> <len>", then one 0x-prefixed word per line
+static long ReadTiData(FILE *f, uint16_t *Words, long MaxWords){
+	unsigned Magic, Format;
+	char Token[32];
+	long n = 0;
+	unsigned long v;
+	size_t Digits;
+
+	if (fscanf(f, "%u %u %*s %*s %*s", &Magic, &Format) != 2 || Magic != 1651 || Format != 1) return -2;
+	while (n < MaxWords && fscanf(f, "%31s", Token) == 1){
+		if (strncmp(Token, "0x", 2) && strncmp(Token, "0X", 2)) return -2;
+		Digits = strlen(Token+2);
+		v = strtoul(Token+2, NULL, 16);
+		Words[n++] = (uint16_t)v;
+		if (Digits > 4 && n < MaxWords) Words[n++] = (uint16_t)(v >> 16);
+	}
+	return n;
+}
+
+// Raw binary: little-endian 16-bit words
+static long ReadRaw(FILE *f, uint16_t *Words, long MaxWords){
+	unsigned char Byte[2];
+	long n = 0;
+	while (n < MaxWords && fread(Byte, 1, 2, f) == 2){
+		Words[n++] = (uint16_t)(Byte[0] | (Byte[1] << 8));
+	}
+	return n;
+}
+
+long ReadCaptureWords(const char *Path, uint16_t *Words, long MaxWords){
+	char Head[5] = {0};
+	FILE *f = fopen(Path, "rb");
+	long n;
+
+	if (!f) return -1;
+	n = (long)fread(Head, 1, 4, f);
+	rewind(f);
+	n = (n == 4 && !strcmp(Head, "1651")) ? ReadTiData(f, Words, MaxWords) : ReadRaw(f, Words, MaxWords);
+	fclose(f);
+	return n;
+}
+
+int LoadSvArray(const char *Path, const int *Order, struct SVARRAY *Sv){
+	uint16_t *Words;
+	long n, i;
+	int k;
+	uint32_t Bits;
+
+	if (!Order) Order = DeclarationOrder;
+	Words = malloc(SVARRAY_WORDS*sizeof(*Words));
+	if (!Words) return -1;
+	n = ReadCaptureWords(Path, Words, SVARRAY_WORDS);
+	if (n != SVARRAY_WORDS){
+		free(Words);
+		return (n < 0) ? (int)n : -3;
+	}
+
+	Sv->Count = 0;
+	for (k=0; k<SVARRAY_SIGNALS; k++){
+		const uint16_t *w = &Words[(long)k*SVARRAY_SIZE*2];
+		for (i=0; i<SVARRAY_SIZE; i++){
+			// Low word first, as the C28x stores a float32
+			Bits = w[2*i] | ((uint32_t)w[2*i+1] << 16);
+			memcpy(&Sv->Signal[Order[k]][i], &Bits, sizeof(Bits));
+			if (Bits != 0 && i >= Sv->Count) Sv->Count = i+1;
+		}
+	}
+	free(Words);
+	return 0;
+}
+
+int SaveSvArray(const char *Path, const int *Order, const struct SVARRAY *Sv, unsigned long Address){
+	FILE *f;
+	long i;
+	int k;
+	uint32_t Bits;
+
+	if (!Order) Order = DeclarationOrder;
+	f = fopen(Path, "w");
+	if (!f) return -1;
+	fprintf(f, "1651 1 %lx 1 %x\n", Address, SVARRAY_WORDS);
+	for (k=0; k<SVARRAY_SIGNALS; k++){
+		for (i=0; i<SVARRAY_SIZE; i++){
+			memcpy(&Bits, &Sv->Signal[Order[k]][i], sizeof(Bits));
+			fprintf(f, "0x%04X\n0x%04X\n", (unsigned)(Bits & 0xFFFF), (unsigned)(Bits >> 16));
+		}
+	}
+	return fclose(f) ? -1 : 0;
+}
+
+void InitReplayConfig(struct REPLAY_CONFIG *Config){
+	memset(Config, 0, sizeof(*Config));
+	InitControllerGains(&Config->Gains);
+	Config->AbsTol = 0.05;
+	Config->RelTol = 0.02;
+}
+
+static int Check(const struct REPLAY_CONFIG *Config, struct REPLAY_RESULT *Result, int Signal,
+				 float Replayed, float Logged){
+	double Err;
+	// Equal, including the same infinity or both NaN, once the loop has blown up
+	if (Replayed == Logged || (isnan(Replayed) && isnan(Logged))) return 1;
+	Err = fabs((double)Replayed-Logged);
+	if (Err > Result->MaxErr[Signal] || Err != Err) Result->MaxErr[Signal] = Err;
+	return Err <= Config->AbsTol+Config->RelTol*fabs(Logged);
+}
+
+void RunReplay(const struct REPLAY_CONFIG *Config, const struct SVARRAY *Sv,
+			   struct REPLAY_RESULT *Result, REPLAY_LOGGER Log, void *User){
+	const float (*s)[SVARRAY_SIZE] = Sv->Signal;
+	struct CONTROLLER_STATE Ctrl;
+	struct CONTROLLER_INPUTS In;
+	struct CONTROLLER_OUTPUTS Out;
+	struct POSITION_STATE Position;
+	float Replayed[SVARRAY_SIGNALS] = {0};
+	long k;
+	int Pass;
+
+	memset(Result, 0, sizeof(*Result));
+	Result->FirstFailure = -1;
+	if (Sv->Count <= 0) return;
+	InitController(&Ctrl);
+	Ctrl.Gains = Config->Gains;
+	for (k=0; k<Sv->Count; k++){
+		In.Theta = s[SV_THETA][k];
+		In.Ia = s[SV_IA][k];
+		In.Ib = s[SV_IB][k];
+		if (k == 0) InitPosition(&Position, CalcCounts(In.Theta));
+		else UpdatePosition(&Position, CalcCounts(In.Theta));
+		In.Tooth = Position.Tooth;
+		In.Pole = Position.Pole;
+		StepController(&Ctrl, &In, &Out);
+
+		Replayed[SV_THETA] = In.Theta;
+		Replayed[SV_IA] = In.Ia;
+		Replayed[SV_IB] = In.Ib;
+		Replayed[SV_DTHETA] = Ctrl.DTheta;
+		Replayed[SV_VA] = Out.Va;
+		Replayed[SV_VB] = Out.Vb;
+		Pass = Check(Config, Result, SV_DTHETA, Ctrl.DTheta, s[SV_DTHETA][k]);
+		Pass &= Check(Config, Result, SV_VA, Out.Va, s[SV_VA][k]);
+		Pass &= Check(Config, Result, SV_VB, Out.Vb, s[SV_VB][k]);
+		Result->Compared++;
+		if (!Pass){
+			if (Result->FirstFailure < 0) Result->FirstFailure = k;
+			Result->Failed++;
+		}
+		if (Log) Log(User, k, Sv, Replayed, Pass);
+	}
+}
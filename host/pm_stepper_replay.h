@@ -0,0 +1,73 @@
+//###########################################################################
+// FILE:   pm_stepper_replay.h
+// TITLE:  Replay of SVArray captures through the host-built controller
+//###########################################################################
+// cpu_timer0_isr logs In.Theta, Controller.DTheta, In.Ia, In.Ib, Out.Va and
+// Out.Vb every RESULTS_DECIMATION control ticks into the six arrays of the
+// SVArray section. A capture of that section saved from CCS (Memory Browser,
+// Save Memory, TI Data hex or raw binary, 16 or 32-bit words) is loaded here
+// and its Theta/Ia/Ib fed back into StepController, one entry per tick.
+// Every tick is replayed from logged inputs and DTheta/Va/Vb must match to
+// float rounding, so the capture has to come from a build with the default
+// RESULTS_DECIMATION 1 and with the gains given in REPLAY_CONFIG. The
+// controller state depends on every tick, so a decimated capture cannot be
+// replayed.
+//###########################################################################
+
+#ifndef PM_STEPPER_REPLAY_H
+#define PM_STEPPER_REPLAY_H
+
+#include <stdint.h>
+#include "pm_stepper_control.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SVARRAY_SIZE 5000					// RESULTS_BUFFER_SIZE
+#define SVARRAY_SIGNALS 6
+
+// Arrays in the order they are declared in the firmware
+#define SV_THETA 0
+#define SV_DTHETA 1
+#define SV_IA 2
+#define SV_IB 3
+#define SV_VA 4
+#define SV_VB 5
+
+struct SVARRAY {
+	float Signal[SVARRAY_SIGNALS][SVARRAY_SIZE];
+	long Count;								// Entries written before the capture
+};
+
+struct REPLAY_CONFIG {
+	struct CONTROLLER_GAINS Gains;			// Gains the firmware was built with
+	double AbsTol;							// Va/Vb (V) and DTheta (rad/s) tolerance
+	double RelTol;							// ... plus this fraction of the logged value
+};
+
+struct REPLAY_RESULT {
+	long Compared;							// Logged entries checked
+	long Failed;							// Entries with any signal out of tolerance
+	long FirstFailure;						// Index of the first one, -1 if none
+	double MaxErr[SVARRAY_SIGNALS];			// max |replayed-logged| of DTheta, Va, Vb
+};
+
+// Optional per-entry observer: Replayed holds DTheta, Va and Vb at SV_DTHETA, SV_VA, SV_VB
+typedef void (*REPLAY_LOGGER)(void *User, long Index, const struct SVARRAY *Sv,
+							  const float Replayed[SVARRAY_SIGNALS], int Pass);
+
+// Memory Browser save (TI Data hex or raw) as 16-bit words; < 0 as LoadSvArray
+long ReadCaptureWords(const char *Path, uint16_t *Words, long MaxWords);
+// Order[k] is the signal stored k-th in the section; NULL = declaration order
+int LoadSvArray(const char *Path, const int *Order, struct SVARRAY *Sv);
+int SaveSvArray(const char *Path, const int *Order, const struct SVARRAY *Sv, unsigned long Address);
+void InitReplayConfig(struct REPLAY_CONFIG *Config);
+void RunReplay(const struct REPLAY_CONFIG *Config, const struct SVARRAY *Sv,
+			   struct REPLAY_RESULT *Result, REPLAY_LOGGER Log, void *User);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end of PM_STEPPER_REPLAY_H definition
@@ -0,0 +1,101 @@
+//###########################################################################
+// FILE:   pm_stepper_replay_main.c
+// TITLE:  Command line front end of the SVArray replay harness
+//###########################################################################
+// Usage: pm_stepper_replay [-k gamma_k] [-a abs_tol] [-r rel_tol]
+//                          [-l order] [-o compare.csv] capture.dat
+//   -k  gammaKP and gammaKA of the capture (default those of the firmware;
+//       pm_stepper_emu captures use its -k, SIM_GAMMA_K by default)
+//   -l  order of the arrays in the section, e.g. Va,Vb,Theta,DTheta,Ia,Ib
+//       (take it from the .map file; default is declaration order)
+//   -o  write logged and replayed DTheta/Va/Vb for every entry
+// Exits with 1 if any entry is out of tolerance.
+//###########################################################################
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pm_stepper_replay.h"
+#include "pm_stepper_trig.h"
+
+static const char *const SignalName[SVARRAY_SIGNALS] = {"Theta", "DTheta", "Ia", "Ib", "Va", "Vb"};
+
+static int ParseOrder(char *List, int *Order){
+	char *Name = strtok(List, ",");
+	int k = 0, s;
+	while (Name && k < SVARRAY_SIGNALS){
+		for (s=0; s<SVARRAY_SIGNALS && strcmp(Name, SignalName[s]); s++);
+		if (s == SVARRAY_SIGNALS) return -1;
+		Order[k++] = s;
+		Name = strtok(NULL, ",");
+	}
+	return (k == SVARRAY_SIGNALS && !Name) ? 0 : -1;
+}
+
+static void WriteEntry(void *User, long Index, const struct SVARRAY *Sv,
+					   const float Replayed[SVARRAY_SIGNALS], int Pass){
+	fprintf((FILE *)User, "%ld,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%d\n", Index,
+			Sv->Signal[SV_THETA][Index], Sv->Signal[SV_DTHETA][Index], Replayed[SV_DTHETA],
+			Sv->Signal[SV_VA][Index], Replayed[SV_VA], Sv->Signal[SV_VB][Index], Replayed[SV_VB], Pass);
+}
+
+int main(int argc, char **argv){
+	static struct SVARRAY Sv;
+	struct REPLAY_CONFIG Config;
+	struct REPLAY_RESULT Result;
+	int Order[SVARRAY_SIGNALS], *OrderArg = NULL, a, Status;
+	const char *Path = NULL, *OutPath = NULL;
+	FILE *Out = NULL;
+	long k;
+
+	InitTrigTable();
+	InitReplayConfig(&Config);
+	for (a=1; a<argc; a++){
+		if (!strcmp(argv[a], "-k") && a+1<argc) Config.Gains.gammaKP = Config.Gains.gammaKA = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-a") && a+1<argc) Config.AbsTol = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-r") && a+1<argc) Config.RelTol = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-l") && a+1<argc && ParseOrder(argv[++a], Order) == 0) OrderArg = Order;
+		else if (!strcmp(argv[a], "-o") && a+1<argc) OutPath = argv[++a];
+		else if (argv[a][0] != '-' && !Path) Path = argv[a];
+		else Path = NULL, a = argc;
+	}
+	if (!Path){
+		fprintf(stderr, "usage: %s [-k gamma_k] [-a abs_tol] [-r rel_tol] [-l order]"
+						" [-o compare.csv] capture.dat\n", argv[0]);
+		return 2;
+	}
+
+	Status = LoadSvArray(Path, OrderArg, &Sv);
+	if (Status == -1){
+		perror(Path);
+		return 2;
+	}
+	if (Status != 0){
+		fprintf(stderr, "%s: %s\n", Path, (Status == -3) ? "does not hold the whole SVArray section"
+															: "not a hex TI Data or raw binary capture");
+		return 2;
+	}
+	if (OutPath){
+		Out = fopen(OutPath, "w");
+		if (!Out){
+			perror(OutPath);
+			return 2;
+		}
+		fprintf(Out, "entry,Theta,DTheta,DTheta_replay,Va,Va_replay,Vb,Vb_replay,pass\n");
+	}
+
+	RunReplay(&Config, &Sv, &Result, Out ? WriteEntry : NULL, Out);
+	if (Out) fclose(Out);
+
+	printf("entries          %ld (one per control tick)\n", Sv.Count);
+	printf("tolerance        %g + %g*|logged|\n", Config.AbsTol, Config.RelTol);
+	for (k=SV_DTHETA; k<SVARRAY_SIGNALS; k++){
+		if (k == SV_IA || k == SV_IB) continue;
+		printf("max |%s err| %*s%.6g\n", SignalName[k], (int)(10-strlen(SignalName[k])), "", Result.MaxErr[k]);
+	}
+	printf("out of tolerance %ld of %ld", Result.Failed, Result.Compared);
+	if (Result.FirstFailure >= 0) printf(", first at entry %ld (t = %.3f s)", Result.FirstFailure,
+										 (Result.FirstFailure+1)*CTRL_TS);
+	printf("\n");
+	return Result.Failed ? 1 : 0;
+}
@@ -0,0 +1,270 @@
+//###########################################################################
+// FILE:   pm_stepper_rtscheck.c
+// TITLE:  Run-time library calls of the control tick in a C2000 build
+//###########################################################################
+// Usage: pm_stepper_rtscheck -r rules [-v] <file>.asm ...
+// Reads the assembly the CCS build keeps (--keep_asm), or a dis2000
+// listing, and finds the functions of the control tick: the roots of the
+// rules file and, from them, every function they call that is defined in
+// the files read. A call from one of them (LCR, LC, FFC or a tail LB) to a
+// routine of the rules' forbid lines is an error, unless an allow line
+// names the pair. The rules file holds lines
+//     root <function>
+//     forbid <routine>
+//     allow <function> <routine>
+// with C names for functions and assembly names for routines ("FS$$DIV");
+// '*' in a name matches any run of characters. Calls through a pointer are
+// not followed, so hooks such as ProfileMark are roots of their own.
+// -v lists the functions of the tick and the caller each was reached from.
+// The exit status is 1 on any error, so the tool can run as a CCS
+// post-build step.
+//###########################################################################
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RTS_MAX_FUNCTIONS 1024
+#define RTS_MAX_CALLS 8192
+#define RTS_MAX_RULES 128
+
+struct RTS_FUNCTION {
+	char Name[64];							// C name, without the leading '_' of COFF
+	const char *File;
+	int Line;
+	int Hot;								// Part of the control tick
+	int From;								// Caller it was reached from, -1 for a root
+};
+
+struct RTS_CALL {
+	int Caller;								// Index in Functions
+	char Callee[64];						// Assembly name as written
+	const char *File;
+	int Line;
+};
+
+struct RTS_RULE {
+	char Kind[8];							// "root", "forbid" or "allow"
+	char Name[64], Routine[64];
+};
+
+static struct RTS_FUNCTION Functions[RTS_MAX_FUNCTIONS];
+static struct RTS_CALL Calls[RTS_MAX_CALLS];
+static struct RTS_RULE Rules[RTS_MAX_RULES];
+static int FunctionCount, CallCount, RuleCount;
+
+static void Copy(char *Out, size_t Size, const char *p, size_t n){
+	if (n >= Size) n = Size-1;
+	memcpy(Out, p, n);
+	Out[n] = 0;
+}
+
+// '*' matches any run of characters, anywhere in the pattern
+static int Match(const char *Pattern, const char *Name){
+	if (*Pattern == '*') return Match(Pattern+1, Name) || (*Name && Match(Pattern, Name+1));
+	if (!*Pattern) return !*Name;
+	return *Pattern == *Name && Match(Pattern+1, Name+1);
+}
+
+// COFF gives C names a leading underscore
+static const char *CName(const char *Symbol){
+	return (Symbol[0] == '_') ? Symbol+1 : Symbol;
+}
+
+static int FindFunction(const char *Name){
+	int i;
+	for (i=0; i<FunctionCount; i++){
+		if (!strcmp(Functions[i].Name, Name)) return i;
+	}
+	return -1;
+}
+
+static int IsCall(const char *Mnemonic){
+	return !strcmp(Mnemonic, "LCR") || !strcmp(Mnemonic, "LC") || !strcmp(Mnemonic, "FFC") || !strcmp(Mnemonic, "LB");
+}
+
+// Initialized data the compiler emits with labels of its own (.econst tables)
+static int IsDataSection(const char *Name){
+	return !strcmp(Name, "\".econst\"") || !strcmp(Name, "\".cinit\"") || !strcmp(Name, "\".switch\"")
+		|| !strcmp(Name, "\".const_cla\"") || !strcmp(Name, ".data") || !strncmp(Name, "\".debug", 7);
+}
+
+//---------------------------------------------------------------------------
+// Assembly: "_Name:" at the start of a line of a code section opens a
+// function, "$C$L1:" and other local labels do not; calls take their target
+// as "#name" (asm) or "name" (dis2000)
+//
+static int ParseAssembly(const char *Path){
+	FILE *f = fopen(Path, "r");
+	char Line[512], Token[64], Label[64], *p;
+	int LineNo = 0, Current = -1, Code = 1, n;
+
+	if (!f){
+		perror(Path);
+		return -1;
+	}
+	while (fgets(Line, sizeof(Line), f)){
+		LineNo++;
+		if (sscanf(Line, " %63s", Token) == 1 && (!strcmp(Token, ".text") || !strcmp(Token, ".sect") || !strcmp(Token, ".data"))){
+			if (!strcmp(Token, ".sect") && sscanf(Line, " .sect %63s", Token) != 1) Token[0] = 0;
+			Code = !IsDataSection(Token);
+			if (!Code) Current = -1;
+			continue;
+		}
+		n = (int)strcspn(Line, ":; \t\r\n");
+		if (Line[0] == '_' && Line[n] == ':' && Code){
+			Copy(Label, sizeof(Label), Line, n);
+			Current = FindFunction(CName(Label));
+			if (Current < 0 && FunctionCount < RTS_MAX_FUNCTIONS){
+				struct RTS_FUNCTION *Fn = &Functions[FunctionCount];
+				Copy(Fn->Name, sizeof(Fn->Name), CName(Label), strlen(CName(Label)));
+				Fn->File = Path;
+				Fn->Line = LineNo;
+				Fn->From = -1;
+				Current = FunctionCount++;
+			}
+			continue;
+		}
+		if (Current < 0) continue;
+		// Mnemonic among the first tokens: dis2000 puts the address and opcode first
+		p = Line;
+		for (;;){
+			p += strspn(p, " \t");
+			if (!*p || *p == ';' || sscanf(p, "%63s", Token) != 1) break;
+			p += strlen(Token);
+			if (!IsCall(Token)) continue;
+			p += strspn(p, " \t");
+			n = (int)strcspn(p, " \t\r\n;");
+			Copy(Token, sizeof(Token), p, n);
+			p = strchr(Token, '#') ? strchr(Token, '#')+1 : Token;
+			// Indirect (*XAR7) and numeric targets name no routine
+			if ((isalpha((unsigned char)*p) || *p == '_' || *p == '$') && CallCount < RTS_MAX_CALLS){
+				struct RTS_CALL *c = &Calls[CallCount++];
+				c->Caller = Current;
+				Copy(c->Callee, sizeof(c->Callee), p, strlen(p));
+				c->File = Path;
+				c->Line = LineNo;
+			}
+			break;
+		}
+	}
+	fclose(f);
+	return 0;
+}
+
+static int ReadRules(const char *Path){
+	FILE *f = fopen(Path, "r");
+	char Line[256];
+	int LineNo = 0, Errors = 0, n;
+
+	if (!f){
+		perror(Path);
+		return -1;
+	}
+	while (fgets(Line, sizeof(Line), f)){
+		struct RTS_RULE *r = &Rules[RuleCount];
+		LineNo++;
+		if (Line[strspn(Line, " \t")] == '#' || Line[strspn(Line, " \t\r\n")] == 0) continue;
+		if (RuleCount == RTS_MAX_RULES){
+			fprintf(stderr, "%s:%d: more than %d rules\n", Path, LineNo, RTS_MAX_RULES);
+			Errors++;
+			break;
+		}
+		r->Routine[0] = 0;
+		n = sscanf(Line, "%7s %63s %63s", r->Kind, r->Name, r->Routine);
+		if ((!strcmp(r->Kind, "root") || !strcmp(r->Kind, "forbid")) && n == 2) RuleCount++;
+		else if (!strcmp(r->Kind, "allow") && n == 3) RuleCount++;
+		else {
+			fprintf(stderr, "%s:%d: expected root, forbid or allow\n", Path, LineNo);
+			Errors++;
+		}
+	}
+	fclose(f);
+	return Errors;
+}
+
+//---------------------------------------------------------------------------
+// Checks
+//
+static void MarkHot(int Index, int From){
+	int i, k;
+	if (Functions[Index].Hot) return;
+	Functions[Index].Hot = 1;
+	Functions[Index].From = From;
+	for (i=0; i<CallCount; i++){
+		if (Calls[i].Caller != Index) continue;
+		k = FindFunction(CName(Calls[i].Callee));
+		if (k >= 0) MarkHot(k, Index);
+	}
+}
+
+static int Forbidden(const struct RTS_CALL *c){
+	const char *Caller = Functions[c->Caller].Name;
+	int i, Hit = 0;
+	for (i=0; i<RuleCount; i++){
+		const struct RTS_RULE *r = &Rules[i];
+		if (!strcmp(r->Kind, "forbid") && Match(r->Name, c->Callee)) Hit = 1;
+	}
+	for (i=0; i<RuleCount && Hit; i++){
+		const struct RTS_RULE *r = &Rules[i];
+		if (!strcmp(r->Kind, "allow") && Match(r->Name, Caller) && Match(r->Routine, c->Callee)) Hit = 0;
+	}
+	return Hit;
+}
+
+static const char *Root(int Index){
+	while (Functions[Index].From >= 0) Index = Functions[Index].From;
+	return Functions[Index].Name;
+}
+
+int main(int argc, char **argv){
+	const char *RulesPath = NULL;
+	int a, i, k, Verbose = 0, Files = 0, Hot = 0, Errors = 0, Hit;
+
+	for (a=1; a<argc; a++){
+		if (!strcmp(argv[a], "-r") && a+1<argc) RulesPath = argv[++a];
+		else if (!strcmp(argv[a], "-v")) Verbose = 1;
+		else if (argv[a][0] != '-'){
+			if (ParseAssembly(argv[a])) return 2;
+			Files++;
+		}
+		else {
+			Files = 0;
+			break;
+		}
+	}
+	if (!RulesPath || !Files){
+		fprintf(stderr, "usage: %s -r rules [-v] <file>.asm ...\n", argv[0]);
+		return 2;
+	}
+	Errors = ReadRules(RulesPath);
+	if (Errors < 0) return 2;
+
+	for (i=0; i<RuleCount; i++){
+		if (strcmp(Rules[i].Kind, "root")) continue;
+		Hit = 0;
+		for (k=0; k<FunctionCount; k++){
+			if (!Match(Rules[i].Name, Functions[k].Name)) continue;
+			Hit = 1;
+			MarkHot(k, -1);
+		}
+		if (!Hit) printf("rules: no function matches %s\n", Rules[i].Name);
+	}
+	for (k=0; k<FunctionCount; k++){
+		if (!Functions[k].Hot) continue;
+		Hot++;
+		if (!Verbose) continue;
+		if (Functions[k].From < 0) printf("    %-28s root\n", Functions[k].Name);
+		else printf("    %-28s from %s\n", Functions[k].Name, Functions[Functions[k].From].Name);
+	}
+	printf("%d of %d functions in the control tick\n", Hot, FunctionCount);
+	for (i=0; i<CallCount; i++){
+		const struct RTS_CALL *c = &Calls[i];
+		if (!Functions[c->Caller].Hot || !Forbidden(c)) continue;
+		printf("%s:%d: %s (tick of %s) calls %s\n", c->File, c->Line, Functions[c->Caller].Name, Root(c->Caller), c->Callee);
+		Errors++;
+	}
+	printf("%d error%s\n", Errors, (Errors == 1) ? "" : "s");
+	return Errors ? 1 : 0;
+}
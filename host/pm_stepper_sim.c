@@ -0,0 +1,117 @@
+//###########################################################################
+// FILE:   pm_stepper_sim.c
+// TITLE:  Closed-loop simulation of StepController against the motor model
+//###########################################################################
+
+#include <math.h>
+#include <string.h>
+#include "pm_stepper_sim.h"
+
+#define SIM_PI 3.14159265358979323846
+
+void InitSimConfig(struct SIM_CONFIG *Config){
+	memset(Config, 0, sizeof(*Config));
+	InitPlantParams(&Config->Plant);
+	InitControllerGains(&Config->Gains);
+	Config->Gains.gammaKP = SIM_GAMMA_K;
+	Config->Gains.gammaKA = SIM_GAMMA_K;
+	Config->Tf = CTRL_TF;
+	Config->Substeps = 4;
+	Config->CurrentLoopRatio = 1;
+	Config->Quantize = 1;
+}
+
+// Same conversion as CalcPosition()
+static float SensePosition(const struct SIM_CONFIG *Config, double Theta){
+	long Counts;
+	if (!Config->Quantize) return (float)Theta;
+	Counts = (long)floor(Theta*(SIM_COUNTS_PER_REV/(2*SIM_PI)));
+	return Counts*0.0001570796327f;
+}
+
+// Shunt + ADC: magnitude only, sign restored from the last applied voltage
+static float SenseCurrent(const struct SIM_CONFIG *Config, double I, double V){
+	double Mag;
+	long Code;
+	if (!Config->Quantize) return (float)I;
+	Mag = fabs(I);
+	Code = (long)(Mag*(1/SIM_ADC_LSB));
+	if (Code > SIM_ADC_MAX) Code = SIM_ADC_MAX;
+	Mag = Code*SIM_ADC_LSB;
+	return (float)((V<0) ? -Mag : Mag);
+}
+
+// SetPWMA/SetPWMB: their abs() is the integer one, so the magnitude is cut
+// to whole volts, then clipped to Vmax, and CMPA = TBPRD-|V|*TBPRD/Vmax
+static double ApplyPWM(const struct SIM_CONFIG *Config, double V, int *Saturated){
+	double Mag = fabs(V);
+	if (Config->Quantize) Mag = floor(Mag);
+	*Saturated = 0;
+	if (Mag > CTRL_VMAX){
+		Mag = CTRL_VMAX;
+		*Saturated = 1;
+	}
+	if (Config->Quantize){
+		unsigned Cmpa = (unsigned)(SIM_PWM_TBPRD-Mag*SIM_PWM_TBPRD*(1.0/CTRL_VMAX));
+		Mag = (double)(SIM_PWM_TBPRD-Cmpa)*(1.0/SIM_PWM_TBPRD)*CTRL_VMAX;
+	}
+	Mag = Mag*(Config->Plant.Vbus*(1.0/CTRL_VMAX));
+	return (V>=0) ? Mag : -Mag;
+}
+
+void RunSimulation(const struct SIM_CONFIG *Config, struct SIM_RESULT *Result, SIM_LOGGER Log, void *User){
+	struct CONTROLLER_STATE Ctrl;
+	struct CONTROLLER_INPUTS In;
+	struct CONTROLLER_OUTPUTS Out;
+	struct CURRENT_SETPOINT Setpoint;
+	struct POSITION_STATE Position;
+	struct PLANT_STATE Plant;
+	double Va=0, Vb=0, h, Err, SumErr2=0;
+	long Tick, Ticks;
+	int i, j, Substeps, Ratio, SatA, SatB;
+
+	memset(Result, 0, sizeof(*Result));
+	InitController(&Ctrl);
+	Ctrl.Gains = Config->Gains;
+	InitPlant(&Plant);
+	Ticks = (long)(Config->Tf*CTRL_ITS+0.5);
+	Substeps = (Config->Substeps > 0) ? Config->Substeps : 1;
+	Ratio = (Config->CurrentLoopRatio > 0) ? Config->CurrentLoopRatio : 1;
+	h = CTRL_TS/(Substeps*Ratio);
+	for (Tick=0; Tick<Ticks; Tick++){
+		In.Theta = SensePosition(Config, Plant.Theta);
+		if (Tick == 0) InitPosition(&Position, CalcCounts(In.Theta));
+		else UpdatePosition(&Position, CalcCounts(In.Theta));
+		In.Tooth = Position.Tooth;
+		In.Pole = Position.Pole;
+		In.Ia = SenseCurrent(Config, Plant.Ia, Va);
+		In.Ib = SenseCurrent(Config, Plant.Ib, Vb);
+		StepPositionLoop(&Ctrl, &In, &Setpoint);
+		for (j=0; j<Ratio; j++){
+			if (j > 0){
+				In.Ia = SenseCurrent(Config, Plant.Ia, Va);
+				In.Ib = SenseCurrent(Config, Plant.Ib, Vb);
+			}
+			StepCurrentLoop(&Setpoint, In.Ia, In.Ib, &Out);
+			Va = ApplyPWM(Config, Out.Va, &SatA);
+			Vb = ApplyPWM(Config, Out.Vb, &SatB);
+			for (i=0; i<Substeps; i++){
+				StepPlant(&Config->Plant, &Plant, Va, Vb, h);
+			}
+			if (fabs(Plant.Ia) > Result->PeakCurrent) Result->PeakCurrent = fabs(Plant.Ia);
+			if (fabs(Plant.Ib) > Result->PeakCurrent) Result->PeakCurrent = fabs(Plant.Ib);
+			if (SatA || SatB) Result->SatTime += CTRL_TS/Ratio;
+		}
+		Err = Plant.Theta-Ctrl.ThetaD;
+		if (!isfinite(Err) || !isfinite(Plant.Ia) || !isfinite(Plant.Ib) || !isfinite(Ctrl.Tau)){
+			Result->Diverged = 1;
+			break;
+		}
+		SumErr2 += Err*Err;
+		if (fabs(Err) > Result->MaxThetaErr) Result->MaxThetaErr = fabs(Err);
+		Result->FinalThetaErr = Err;
+		if (Log) Log(User, Tick, &Ctrl, &Plant, Va, Vb);
+	}
+	Result->Steps = Tick;
+	Result->RmsThetaErr = Tick ? sqrt(SumErr2/Tick) : 0;
+}
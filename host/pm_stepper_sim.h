@@ -0,0 +1,66 @@
+//###########################################################################
+// FILE:   pm_stepper_sim.h
+// TITLE:  Closed-loop simulation of StepController against the motor model
+//###########################################################################
+// One simulated tick reproduces what cpu_timer0_isr sees on the board:
+// QPOSCNT quantized to 40000 counts/rev, ADC current magnitudes with the
+// sign taken from the last applied voltage, and Va/Vb cut to whole volts,
+// saturated to Vmax and truncated to ePWM CMPA counts as SetPWMA/SetPWMB
+// do, before they reach the plant.
+// With CurrentLoopRatio > 1 the tick is that of the CONTROL_SPLIT build:
+// StepPositionLoop once, then StepCurrentLoop on fresh current samples
+// CurrentLoopRatio times, each holding the PWM for Ts/CurrentLoopRatio.
+// The simulated law runs the Controller Gains except for the ripple
+// adaptation, SIM_GAMMA_K (InitSimConfig): at the firmware's GammakP/GammakA
+// the model, which has not been checked against the motor, drifts with no
+// ripple to learn.
+//###########################################################################
+
+#ifndef PM_STEPPER_SIM_H
+#define PM_STEPPER_SIM_H
+
+#include "pm_stepper_plant.h"
+#include "pm_stepper_control.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_COUNTS_PER_REV 40000			// eQEP1 counts per revolution
+#define SIM_ADC_LSB 0.000791452315			// Amps per ADC count (adca1_isr)
+#define SIM_ADC_MAX 4095					// 12-bit full scale
+#define SIM_PWM_TBPRD 5000					// EPWM7/EPWM9 period
+#define SIM_MAX_ERR 0.1						// Default limit of max |Theta-ThetaD| for a run to pass (rad)
+#define SIM_GAMMA_K 0.01					// gammaKP and gammaKA of the simulated law
+
+struct SIM_CONFIG {
+	struct PLANT_PARAMS Plant;				// Motor being driven
+	struct CONTROLLER_GAINS Gains;			// Gains loaded into StepController
+	double Tf;								// Run length (s)
+	int Substeps;							// Plant integration steps per current loop step
+	int CurrentLoopRatio;					// Current loop steps per control tick, 1 = StepController
+	int Quantize;							// 1 = encoder, ADC and PWM quantization as on the board
+};
+
+struct SIM_RESULT {
+	long Steps;								// Control ticks executed
+	double MaxThetaErr;						// max |Theta-ThetaD| (rad)
+	double RmsThetaErr;						// rms of Theta-ThetaD (rad)
+	double FinalThetaErr;					// Theta-ThetaD at the last tick (rad)
+	double PeakCurrent;						// max(|Ia|,|Ib|) (A)
+	double SatTime;							// Time with |Va| or |Vb| clipped at Vmax (s)
+	int Diverged;							// 1 if the run was stopped on a non-finite state
+};
+
+// Optional per-tick observer, called after the plant has been advanced
+typedef void (*SIM_LOGGER)(void *User, long Tick, const struct CONTROLLER_STATE *Ctrl,
+						   const struct PLANT_STATE *Plant, double Va, double Vb);
+
+void InitSimConfig(struct SIM_CONFIG *Config);
+void RunSimulation(const struct SIM_CONFIG *Config, struct SIM_RESULT *Result, SIM_LOGGER Log, void *User);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end of PM_STEPPER_SIM_H definition
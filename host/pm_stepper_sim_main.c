@@ -0,0 +1,97 @@
+//###########################################################################
+// FILE:   pm_stepper_sim_main.c
+// TITLE:  Command line front end of the closed-loop simulator
+//###########################################################################
+// Usage: pm_stepper_sim_cli [-t tf] [-s substeps] [-f ratio] [-r repeats] [-i]
+//                           [-k gamma_k] [-e max_err] [-o trace.csv]
+//   -t  run length in seconds (default tf)
+//   -s  plant integration steps per current loop step (default 4)
+//   -f  current loop steps per control tick, as the CONTROL_SPLIT build
+//       (default 1, StepController)
+//   -r  repeat the run to get a stable control steps/s figure
+//   -i  ideal sensors and PWM (no quantization)
+//   -k  gammaKP and gammaKA of the ripple adaptation (default SIM_GAMMA_K;
+//       the firmware's are GammakP/GammakA of pm_stepper_control.c)
+//   -e  limit of max |ThetaT| (default SIM_MAX_ERR); the exit status is 1
+//       if the run diverges or goes past it
+//   -o  write a per-tick trace like the SVArray logs
+//###########################################################################
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pm_stepper_sim.h"
+#include "pm_stepper_trig.h"
+
+static void TraceTick(void *User, long Tick, const struct CONTROLLER_STATE *Ctrl,
+					  const struct PLANT_STATE *Plant, double Va, double Vb){
+	fprintf((FILE *)User, "%.3f,%.6f,%.6f,%.5f,%.5f,%.5f,%.5f,%.4f,%.4f\n",
+			(Tick+1)*CTRL_TS, Plant->Theta, Ctrl->ThetaD, Ctrl->DTheta,
+			Plant->Ia, Plant->Ib, Ctrl->Tau, Va, Vb);
+}
+
+static double Seconds(void){
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec+t.tv_nsec*1e-9;
+}
+
+int main(int argc, char **argv){
+	struct SIM_CONFIG Config;
+	struct SIM_RESULT Result;
+	const char *TracePath = NULL;
+	FILE *Trace = NULL;
+	int Repeats = 1, k;
+	double Start, Elapsed, MaxErr = SIM_MAX_ERR;
+
+	InitTrigTable();
+	InitSimConfig(&Config);
+	for (k=1; k<argc; k++){
+		if (!strcmp(argv[k], "-t") && k+1<argc) Config.Tf = atof(argv[++k]);
+		else if (!strcmp(argv[k], "-s") && k+1<argc) Config.Substeps = atoi(argv[++k]);
+		else if (!strcmp(argv[k], "-f") && k+1<argc) Config.CurrentLoopRatio = atoi(argv[++k]);
+		else if (!strcmp(argv[k], "-r") && k+1<argc) Repeats = atoi(argv[++k]);
+		else if (!strcmp(argv[k], "-i")) Config.Quantize = 0;
+		else if (!strcmp(argv[k], "-k") && k+1<argc) Config.Gains.gammaKP = Config.Gains.gammaKA = atof(argv[++k]);
+		else if (!strcmp(argv[k], "-e") && k+1<argc) MaxErr = atof(argv[++k]);
+		else if (!strcmp(argv[k], "-o") && k+1<argc) TracePath = argv[++k];
+		else {
+			fprintf(stderr, "usage: %s [-t tf] [-s substeps] [-f ratio] [-r repeats] [-i]"
+							" [-k gamma_k] [-e max_err] [-o trace.csv]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (Repeats < 1) Repeats = 1;
+	if (TracePath){
+		Trace = fopen(TracePath, "w");
+		if (!Trace){
+			perror(TracePath);
+			return 1;
+		}
+		fprintf(Trace, "time,Theta,ThetaD,DTheta,Ia,Ib,Tau,Va,Vb\n");
+	}
+
+	Start = Seconds();
+	for (k=0; k<Repeats; k++){
+		RunSimulation(&Config, &Result, (Trace && k==0) ? TraceTick : NULL, Trace);
+	}
+	Elapsed = Seconds()-Start;
+	if (Trace) fclose(Trace);
+
+	printf("steps            %ld%s\n", Result.Steps, Result.Diverged ? " (diverged)" : "");
+	printf("max |ThetaT|     %.6f rad\n", Result.MaxThetaErr);
+	printf("rms ThetaT       %.6f rad\n", Result.RmsThetaErr);
+	printf("final ThetaT     %.6f rad\n", Result.FinalThetaErr);
+	printf("peak current     %.4f A\n", Result.PeakCurrent);
+	printf("saturated        %.3f s\n", Result.SatTime);
+	printf("wall time        %.3f ms per run\n", Elapsed*1e3/Repeats);
+	printf("control rate     %.0f steps/s\n", Elapsed > 0 ? Result.Steps*(double)Repeats/Elapsed : 0);
+	if (Result.Diverged || Result.MaxThetaErr > MaxErr){
+		if (Result.Diverged) printf("FAIL: diverged at step %ld\n", Result.Steps);
+		else printf("FAIL: max |ThetaT| above %g rad\n", MaxErr);
+		return 1;
+	}
+	printf("PASS: max |ThetaT| within %g rad\n", MaxErr);
+	return 0;
+}
@@ -0,0 +1,291 @@
+//###########################################################################
+// FILE:   pm_stepper_trig_bench.c
+// TITLE:  Cost and accuracy of the sin/cos backends of pm_stepper_trig
+//###########################################################################
+// Usage: pm_stepper_trig_bench [-r revolutions] [-k harmonics] [-m ms] [-o results.json]
+// Every backend is built into the host library regardless of TRIG_BACKEND,
+// so they are compared side by side. The angles are those StepController
+// feeds them: Nr*Theta and k*np*Theta in float, for every encoder count
+// within +/- revolutions (default 5) of the origin. The error is against
+// double-precision sin/cos of the same float argument.
+// Then what one tick computes from the encoder position: sin/cos of the
+// tooth angle, and the first -k (default 16) harmonics of np*Theta, built by
+// one TrigSin/TrigCos pair per harmonic or by CalcHarmonics, from float Theta
+// (.trig, .direct, .recurrence) or from the integer tooth/pole phase (.phase),
+// or looked up by phase (TRIG_COUNTS). Here the error is against the exact
+// angle of the count, so it includes rounding Theta and its multiples to float.
+// ns/call is host time and only ranks the backends; the TMU one is a model
+// of the instruction, so only its error carries over to the target.
+//###########################################################################
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pm_stepper_control.h"
+#include "pm_stepper_trig.h"
+
+#define TRIG_COUNTS_PER_REV 40000			// eQEP counts per mechanical turn
+#define TRIG_RAD_PER_COUNT 0.000157079633f	// As in CalcPosition()
+#define TRIG_BENCH_ARGS 4096				// Timing argument set, a power of 2
+#define TRIG_BENCH_ROUNDS 7
+#define TRIG_MAX_HARMONICS 64
+
+struct TRIG_BACKEND_CASE {
+	const char *Name;
+	float (*Sin)(float);
+	float (*Cos)(float);
+};
+
+struct TRIG_RESULT {
+	double Ns;								// ns per sin+cos pair (per tick), best round
+	double MaxErr;							// max |error| over sin and cos
+	double MaxErrAngle;						// Argument (rad) where it occurs
+};
+
+static float RtsSin(float x){ return sinf(x); }
+static float RtsCos(float x){ return cosf(x); }
+static float TmuSin(float x){ return TmuSinPu(x*TRIG_INV_2PI); }
+static float TmuCos(float x){ return TmuCosPu(x*TRIG_INV_2PI); }
+
+static const struct TRIG_BACKEND_CASE Backends[] = {
+	{"rts", RtsSin, RtsCos},
+	{"tmu", TmuSin, TmuCos},
+	{"poly", PolySin, PolyCos},
+	{"table", TableSin, TableCos},
+};
+#define TRIG_BACKENDS ((int)(sizeof(Backends)/sizeof(Backends[0])))
+
+static volatile float Sink;
+static float Args[TRIG_BENCH_ARGS];			// Nr*Theta of ArgPositions
+static struct POSITION_STATE ArgPositions[TRIG_BENCH_ARGS];
+
+static double Now(void){
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec*1e9+t.tv_nsec;
+}
+
+static double RunBackend(const void *Case, long Calls){
+	const struct TRIG_BACKEND_CASE *c = Case;
+	double t0 = Now();
+	float Acc = 0;
+	long k;
+	for (k=0; k<Calls; k++){
+		float x = Args[k & (TRIG_BENCH_ARGS-1)];
+		Acc += c->Sin(x)+c->Cos(x);
+	}
+	Sink = Acc;
+	return Now()-t0;
+}
+
+static void ToothTrig(const struct POSITION_STATE *p, float *S, float *C, int Count){
+	float Theta = CalcPosition(p);
+	(void)Count;
+	S[0] = TrigSin(CTRL_NR*Theta);
+	C[0] = TrigCos(CTRL_NR*Theta);
+}
+
+static void ToothPhase(const struct POSITION_STATE *p, float *S, float *C, int Count){
+	(void)Count;
+	S[0] = TrigSin(p->Tooth*TRIG_TOOTH_RAD);
+	C[0] = TrigCos(p->Tooth*TRIG_TOOTH_RAD);
+}
+
+static void ToothCounts(const struct POSITION_STATE *p, float *S, float *C, int Count){
+	(void)Count;
+	CalcToothSinCos(p->Tooth, S, C);
+}
+
+// The pre-recurrence way: two trig calls per harmonic, same backend
+static void BasisDirect(const struct POSITION_STATE *p, float *S, float *C, int Count){
+	float Theta = CalcPosition(p);
+	int k;
+	for (k=0; k<Count; k++){
+		S[k] = TrigSin((k+1)*CTRL_NP*Theta);
+		C[k] = TrigCos((k+1)*CTRL_NP*Theta);
+	}
+}
+
+static void BasisRecurrence(const struct POSITION_STATE *p, float *S, float *C, int Count){
+	CalcHarmonics(CTRL_NP*CalcPosition(p), S, C, Count);
+}
+
+static void BasisPhase(const struct POSITION_STATE *p, float *S, float *C, int Count){
+	CalcHarmonics(p->Pole*TRIG_POLE_RAD, S, C, Count);
+}
+
+static void BasisCounts(const struct POSITION_STATE *p, float *S, float *C, int Count){
+	CalcPoleHarmonics(p->Pole, S, C, Count);
+}
+
+struct TRIG_TICK_CASE {
+	const char *Name;
+	void (*Calc)(const struct POSITION_STATE *p, float *S, float *C, int Count);
+	int Multiplier;							// Nr or np
+	int Harmonics;							// 0: just the fundamental
+};
+
+static const struct TRIG_TICK_CASE Ticks[] = {
+	{"tooth.trig", ToothTrig, CTRL_NR, 0},
+	{"tooth.phase", ToothPhase, CTRL_NR, 0},
+	{"tooth.counts", ToothCounts, CTRL_NR, 0},
+	{"basis.direct", BasisDirect, CTRL_NP, 1},
+	{"basis.recurrence", BasisRecurrence, CTRL_NP, 1},
+	{"basis.phase", BasisPhase, CTRL_NP, 1},
+	{"basis.counts", BasisCounts, CTRL_NP, 1},
+};
+#define TRIG_TICKS ((int)(sizeof(Ticks)/sizeof(Ticks[0])))
+
+static int Harmonics = 16;
+
+static int TickCount(const struct TRIG_TICK_CASE *c){
+	return c->Harmonics ? Harmonics : 1;
+}
+
+static double RunTick(const void *Case, long Calls){
+	const struct TRIG_TICK_CASE *c = Case;
+	float S[TRIG_MAX_HARMONICS], C[TRIG_MAX_HARMONICS], Acc = 0;
+	int Count = TickCount(c);
+	double t0 = Now();
+	long k;
+	for (k=0; k<Calls; k++){
+		c->Calc(&ArgPositions[k & (TRIG_BENCH_ARGS-1)], S, C, Count);
+		Acc += S[Count-1]+C[0];
+	}
+	Sink = Acc;
+	return Now()-t0;
+}
+
+// Best ns/call over the rounds, each about Ms long
+static double BestNs(double (*Run)(const void *, long), const void *Case, double Ms){
+	long Calls = 1000;
+	double t, Best;
+	int Round;
+
+	for (;;){
+		t = Run(Case, Calls);
+		if (t >= Ms*1e6 || Calls > (1L << 40)) break;
+		Calls = (t > Ms*1e4) ? (long)(Calls*(Ms*1e6/t)) : Calls*10;
+	}
+	Best = t/Calls;
+	for (Round=0; Round<TRIG_BENCH_ROUNDS; Round++){
+		t = Run(Case, Calls)/Calls;
+		if (t < Best) Best = t;
+	}
+	return Best;
+}
+
+static void CheckError(struct TRIG_RESULT *r, double Value, double Exact, double x){
+	double e = fabs(Value-Exact);
+	if (e > r->MaxErr){
+		r->MaxErr = e;
+		r->MaxErrAngle = x;
+	}
+}
+
+static void Measure(const struct TRIG_BACKEND_CASE *c, double Ms, long Revs, struct TRIG_RESULT *r){
+	long Count;
+	float Theta, x;
+	int i;
+
+	r->Ns = BestNs(RunBackend, c, Ms);
+	r->MaxErr = 0;
+	r->MaxErrAngle = 0;
+	for (Count=-Revs*TRIG_COUNTS_PER_REV; Count<=Revs*TRIG_COUNTS_PER_REV; Count++){
+		Theta = Count*TRIG_RAD_PER_COUNT;
+		for (i=-1; i<HARMONIC_COUNT; i++){
+			x = (i < 0) ? CTRL_NR*Theta : (i+1)*CTRL_NP*Theta;
+			CheckError(r, c->Sin(x), sin((double)x), x);
+			CheckError(r, c->Cos(x), cos((double)x), x);
+		}
+	}
+}
+
+static void MeasureTick(const struct TRIG_TICK_CASE *c, double Ms, long Revs, struct TRIG_RESULT *r){
+	float S[TRIG_MAX_HARMONICS], C[TRIG_MAX_HARMONICS];
+	int Count = TickCount(c), k;
+	struct POSITION_STATE p;
+	long Counts;
+	double x;
+
+	r->Ns = BestNs(RunTick, c, Ms);
+	r->MaxErr = 0;
+	r->MaxErrAngle = 0;
+	for (Counts=-Revs*TRIG_COUNTS_PER_REV; Counts<=Revs*TRIG_COUNTS_PER_REV; Counts++){
+		InitPosition(&p, Counts);
+		c->Calc(&p, S, C, Count);
+		for (k=0; k<Count; k++){
+			// Exact: reduce the integer phase before going to radians
+			x = (double)((long long)c->Multiplier*(k+1)*Counts % TRIG_COUNTS_PER_REV)*(2*M_PI/TRIG_COUNTS_PER_REV);
+			CheckError(r, S[k], sin(x), (double)c->Multiplier*(k+1)*Counts*(2*M_PI/TRIG_COUNTS_PER_REV));
+			CheckError(r, C[k], cos(x), (double)c->Multiplier*(k+1)*Counts*(2*M_PI/TRIG_COUNTS_PER_REV));
+		}
+	}
+}
+
+static void WriteJson(FILE *f, long Revs, const char **Names, const struct TRIG_RESULT *r, int Count){
+	int k;
+	fprintf(f, "{\n  \"benchmark\": \"pm_stepper_trig_bench\",\n  \"revolutions\": %ld,\n  \"results\": [\n", Revs);
+	for (k=0; k<Count; k++){
+		fprintf(f, "    {\"name\": \"%s\", \"ns_per_call\": %.3f, \"max_error\": %.3e, \"max_error_angle\": %.4f}%s\n",
+				Names[k], r[k].Ns, r[k].MaxErr, r[k].MaxErrAngle, (k+1 < Count) ? "," : "");
+	}
+	fprintf(f, "  ]\n}\n");
+}
+
+int main(int argc, char **argv){
+	struct TRIG_RESULT Results[TRIG_BACKENDS+TRIG_TICKS];
+	const char *Names[TRIG_BACKENDS+TRIG_TICKS], *OutPath = NULL;
+	char TickNames[TRIG_TICKS][40];
+	double Ms = 20;
+	long Revs = 5;
+	int a, k;
+	FILE *Out;
+
+	for (a=1; a<argc; a++){
+		if (!strcmp(argv[a], "-r") && a+1<argc) Revs = atol(argv[++a]);
+		else if (!strcmp(argv[a], "-k") && a+1<argc) Harmonics = atoi(argv[++a]);
+		else if (!strcmp(argv[a], "-m") && a+1<argc) Ms = atof(argv[++a]);
+		else if (!strcmp(argv[a], "-o") && a+1<argc) OutPath = argv[++a];
+		else Harmonics = 0;
+		if (Harmonics < 1 || Harmonics > TRIG_MAX_HARMONICS){
+			fprintf(stderr, "usage: %s [-r revolutions] [-k harmonics 1..%d] [-m ms] [-o results.json]\n",
+					argv[0], TRIG_MAX_HARMONICS);
+			return 2;
+		}
+	}
+
+	InitTrigTable();
+	for (k=0; k<TRIG_BENCH_ARGS; k++){
+		InitPosition(&ArgPositions[k], (k*7919L % (2*TRIG_COUNTS_PER_REV))-TRIG_COUNTS_PER_REV);
+		Args[k] = CTRL_NR*CalcPosition(&ArgPositions[k]);
+	}
+	printf("backend           ns/call (sin+cos)  max error  at x (rad)   over +/-%ld rev, TRIG_BACKEND %d\n",
+		   Revs, TRIG_BACKEND);
+	for (k=0; k<TRIG_BACKENDS; k++){
+		Measure(&Backends[k], Ms, Revs, &Results[k]);
+		Names[k] = Backends[k].Name;
+		printf("%-17s %18.2f  %9.2e  %10.4f\n", Names[k], Results[k].Ns, Results[k].MaxErr, Results[k].MaxErrAngle);
+	}
+	printf("\nper tick          ns/call            max error  at x (rad)   %d harmonics\n", Harmonics);
+	for (k=0; k<TRIG_TICKS; k++){
+		struct TRIG_RESULT *r = &Results[TRIG_BACKENDS+k];
+		MeasureTick(&Ticks[k], Ms, Revs, r);
+		if (Ticks[k].Harmonics) snprintf(TickNames[k], sizeof(TickNames[k]), "%s.%d", Ticks[k].Name, Harmonics);
+		else snprintf(TickNames[k], sizeof(TickNames[k]), "%s", Ticks[k].Name);
+		Names[TRIG_BACKENDS+k] = TickNames[k];
+		printf("%-17s %18.2f  %9.2e  %10.4f\n", Ticks[k].Name, r->Ns, r->MaxErr, r->MaxErrAngle);
+	}
+
+	if (OutPath){
+		if (!(Out = fopen(OutPath, "w"))){
+			perror(OutPath);
+			return 2;
+		}
+		WriteJson(Out, Revs, Names, Results, TRIG_BACKENDS+TRIG_TICKS);
+		fclose(Out);
+	}
+	return 0;
+}
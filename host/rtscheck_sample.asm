@@ -0,0 +1,182 @@
+;***************************************************************
+;* TMS320C2000 C/C++ Codegen                        PC v6.4.10 *
+;***************************************************************
+; Input file of the rtscheck ctest, laid out as the --keep_asm output of
+; cl2000 6.4 (COFF, --symdebug:dwarf). The tick, cpu_timer0_isr, reaches
+; StepController directly, StepDiff through FFC and CalcGain through LB;
+; the one call CalcGain makes to FS$$DIV is the expected error.
+; InitController divides as well but is not part of the tick.
+	.compiler_opts --abi=coffabi --cla_support=cla1 --float_support=fpu32 --hll_source=on --mem_model:code=flat --mem_model:data=large --object_format=coff --silicon_version=28 --symdebug:dwarf --symdebug:dwarf_version=3 --tmu_support=tmu0 --vcu_support=vcu2
+	.asg	XAR2, FP
+
+$C$DW$CU	.dwtag  DW_TAG_compile_unit
+	.dwattr $C$DW$CU, DW_AT_name("../pm_stepper_sample.c")
+	.dwattr $C$DW$CU, DW_AT_producer("TI TMS320C2000 C/C++ Codegen PC v6.4.10 Copyright (c) 1996-2015 Texas Instruments Incorporated")
+	.global	_DiffGain
+	.sect	".econst"
+	.align	2
+_DiffGain:
+	.xfloat	$strtod("0x1.4p+3")		; _DiffGain @ 0
+
+$C$DW$1	.dwtag  DW_TAG_subprogram, DW_AT_name("FS$$DIV")
+	.dwattr $C$DW$1, DW_AT_TI_symbol_name("FS$$DIV")
+	.dwattr $C$DW$1, DW_AT_declaration
+	.dwattr $C$DW$1, DW_AT_external
+;	C:\ti\ccsv6\tools\compiler\ti-cgt-c2000_6.4.10\bin\opt2000.exe C:\\Users\\AppData\\Local\\Temp\\0540810 C:\\Users\\AppData\\Local\\Temp\\0540812
+;	C:\ti\ccsv6\tools\compiler\ti-cgt-c2000_6.4.10\bin\ac2000.exe -@C:\\Users\\AppData\\Local\\Temp\\0540815
+	.sect	"ramfuncs"
+	.clink
+	.global	_CalcGain
+
+$C$DW$2	.dwtag  DW_TAG_subprogram, DW_AT_name("CalcGain")
+	.dwattr $C$DW$2, DW_AT_low_pc(_CalcGain)
+	.dwattr $C$DW$2, DW_AT_high_pc(0x00)
+	.dwattr $C$DW$2, DW_AT_TI_symbol_name("_CalcGain")
+	.dwattr $C$DW$2, DW_AT_external
+	.dwpsn	file "../pm_stepper_sample.c",line 9,column 1,is_stmt,address _CalcGain,isa 0
+	.dwfde $C$DW$CIE, _CalcGain
+
+;***************************************************************
+;* FNAME: _CalcGain                   FR SIZE:   0             *
+;*                                                             *
+;* FUNCTION ENVIRONMENT                                        *
+;*                                                             *
+;* FUNCTION PROPERTIES                                         *
+;*                            0 Parameter,  0 Auto,  0 SOE     *
+;***************************************************************
+
+_CalcGain:
+	.dwcfi	cfa_offset, -2
+	.dwcfi	save_reg_to_mem, 26, 0
+	.dwpsn	file "../pm_stepper_sample.c",line 10,column 2,is_stmt,isa 0
+        MOVIZ     R1H,#16672            ; [CPU_] |10|
+$C$DW$3	.dwtag  DW_TAG_TI_branch
+	.dwattr $C$DW$3, DW_AT_low_pc(0x00)
+	.dwattr $C$DW$3, DW_AT_name("FS$$DIV")
+	.dwattr $C$DW$3, DW_AT_TI_call
+        LCR       #FS$$DIV              ; [CPU_] |10|
+        ; call occurs [#FS$$DIV] ; [] |10|
+	.dwpsn	file "../pm_stepper_sample.c",line 11,column 1,is_stmt,isa 0
+$C$DW$4	.dwtag  DW_TAG_TI_branch
+	.dwattr $C$DW$4, DW_AT_low_pc(0x00)
+	.dwattr $C$DW$4, DW_AT_TI_return
+        LRETR     ; [CPU_]
+        ; return occurs ; []
+	.dwattr $C$DW$2, DW_AT_TI_end_file("../pm_stepper_sample.c")
+	.dwattr $C$DW$2, DW_AT_TI_end_line(0x0b)
+	.dwattr $C$DW$2, DW_AT_TI_end_column(0x01)
+	.dwendentry
+	.dwendtag $C$DW$2
+
+	.sect	"ramfuncs"
+	.clink
+	.global	_StepDiff
+
+$C$DW$5	.dwtag  DW_TAG_subprogram, DW_AT_name("StepDiff")
+	.dwattr $C$DW$5, DW_AT_low_pc(_StepDiff)
+	.dwattr $C$DW$5, DW_AT_high_pc(0x00)
+	.dwattr $C$DW$5, DW_AT_TI_symbol_name("_StepDiff")
+	.dwattr $C$DW$5, DW_AT_external
+	.dwfde $C$DW$CIE, _StepDiff
+
+;***************************************************************
+;* FNAME: _StepDiff                   FR SIZE:   0             *
+;***************************************************************
+
+_StepDiff:
+	.dwcfi	cfa_offset, -2
+        MPYF32    R0H,R0H,R0H           ; [CPU_] |15|
+        NOP       ; [CPU_]
+$C$DW$6	.dwtag  DW_TAG_TI_branch
+	.dwattr $C$DW$6, DW_AT_low_pc(0x00)
+	.dwattr $C$DW$6, DW_AT_name("_CalcGain")
+	.dwattr $C$DW$6, DW_AT_TI_call
+        LB        #_CalcGain            ; [CPU_] |16|
+        ; branch occurs ; [] |16|
+	.dwendentry
+	.dwendtag $C$DW$5
+
+	.sect	"ramfuncs"
+	.clink
+	.global	_StepController
+
+$C$DW$7	.dwtag  DW_TAG_subprogram, DW_AT_name("StepController")
+	.dwattr $C$DW$7, DW_AT_TI_symbol_name("_StepController")
+	.dwfde $C$DW$CIE, _StepController
+
+;***************************************************************
+;* FNAME: _StepController             FR SIZE:   2             *
+;***************************************************************
+
+_StepController:
+	.dwcfi	cfa_offset, -2
+        ADDB      SP,#2                 ; [CPU_U]
+	.dwcfi	cfa_offset, -4
+$C$L1:
+        MOVL      XAR7,#_StepDiff       ; [CPU_U] |21|
+$C$DW$8	.dwtag  DW_TAG_TI_branch
+	.dwattr $C$DW$8, DW_AT_low_pc(0x00)
+	.dwattr $C$DW$8, DW_AT_name("_StepDiff")
+	.dwattr $C$DW$8, DW_AT_TI_call
+        FFC       XAR7,#_StepDiff       ; [CPU_] |21|
+        ; call occurs [#_StepDiff] ; [] |21|
+$C$DW$9	.dwtag  DW_TAG_TI_branch
+	.dwattr $C$DW$9, DW_AT_low_pc(0x00)
+	.dwattr $C$DW$9, DW_AT_TI_call
+	.dwattr $C$DW$9, DW_AT_TI_indirect
+        LCR       *XAR7                 ; [CPU_] |22|
+        ; call occurs [XAR7] ; [] |22|
+        SUBB      SP,#2                 ; [CPU_U]
+        LRETR     ; [CPU_]
+	.dwendentry
+	.dwendtag $C$DW$7
+
+	.text
+	.global	_cpu_timer0_isr
+
+;***************************************************************
+;* FNAME: _cpu_timer0_isr             FR SIZE:  14             *
+;***************************************************************
+
+_cpu_timer0_isr:
+        ASP       ; [CPU_]
+        PUSH      RB                    ; [CPU_]
+        MOV32     *SP++,STF             ; [CPU_]
+        SPM       0                     ; [CPU_]
+        CLRC      OBJMODE|AMODE         ; [CPU_]
+$C$DW$10	.dwtag  DW_TAG_TI_branch
+	.dwattr $C$DW$10, DW_AT_name("_StepController")
+	.dwattr $C$DW$10, DW_AT_TI_call
+        LCR       #_StepController      ; [CPU_] |30|
+        ; call occurs [#_StepController] ; [] |30|
+        MOV32     STF,*--SP             ; [CPU_]
+        POP       RB                    ; [CPU_]
+        NASP      ; [CPU_]
+        IRET      ; [CPU_]
+
+	.text
+	.global	_InitController
+
+;***************************************************************
+;* FNAME: _InitController             FR SIZE:   0             *
+;***************************************************************
+
+_InitController:
+        LCR       #FS$$DIV              ; [CPU_] |36|
+        ; call occurs [#FS$$DIV] ; [] |36|
+        LRETR     ; [CPU_]
+
+;***************************************************************
+;* UNDEFINED EXTERNAL REFERENCES                               *
+;***************************************************************
+	.global	FS$$DIV
+
+;***************************************************************
+;* DWARF CIE ENTRIES                                           *
+;***************************************************************
+
+$C$DW$CIE	.dwcie 26
+	.dwcfi	cfa_register, 20
+	.dwcfi	cfa_offset, 0
+	.dwcfi	undefined, 0
+	.dwendentry
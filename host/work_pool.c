@@ -0,0 +1,143 @@
+//###########################################################################
+// FILE:   work_pool.c
+// TITLE:  Work-stealing parallel loop for host batch tools
+//###########################################################################
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "work_pool.h"
+
+struct WORK_SLICE {
+	pthread_mutex_t Lock;
+	long Next, End;					// Remaining indices [Next, End)
+};
+
+struct WORK_POOL {
+	struct WORK_SLICE *Slices;
+	int Threads;
+	WORK_FUNC Func;
+	void *Arg;
+};
+
+struct WORK_THREAD {
+	struct WORK_POOL *Pool;
+	int Id;
+};
+
+int WorkPoolDefaultThreads(void){
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return (n > 0) ? (int)n : 1;
+}
+
+// Take one index from the front of our own slice
+static int PopOwn(struct WORK_SLICE *Own, long *Index){
+	int Found = 0;
+	pthread_mutex_lock(&Own->Lock);
+	if (Own->Next < Own->End){
+		*Index = Own->Next++;
+		Found = 1;
+	}
+	pthread_mutex_unlock(&Own->Lock);
+	return Found;
+}
+
+// Move the back half of the largest other slice into our own slice
+static int Steal(struct WORK_POOL *Pool, int Id){
+	struct WORK_SLICE *Own = &Pool->Slices[Id];
+	int k, Victim = -1;
+	long Best = 0, Left, Lo, Hi;
+
+	// The scan is only a hint; the victim is re-checked when it is split
+	for (k=0; k<Pool->Threads; k++){
+		if (k == Id) continue;
+		pthread_mutex_lock(&Pool->Slices[k].Lock);
+		Left = Pool->Slices[k].End-Pool->Slices[k].Next;
+		pthread_mutex_unlock(&Pool->Slices[k].Lock);
+		if (Left > Best){
+			Best = Left;
+			Victim = k;
+		}
+	}
+	if (Victim < 0) return 0;
+
+	pthread_mutex_lock(&Pool->Slices[Victim].Lock);
+	Left = Pool->Slices[Victim].End-Pool->Slices[Victim].Next;
+	if (Left <= 0){
+		pthread_mutex_unlock(&Pool->Slices[Victim].Lock);
+		return 1;	// Lost the race, rescan
+	}
+	Hi = Pool->Slices[Victim].End;
+	Lo = Hi-(Left+1)/2;
+	Pool->Slices[Victim].End = Lo;
+	pthread_mutex_unlock(&Pool->Slices[Victim].Lock);
+
+	pthread_mutex_lock(&Own->Lock);
+	Own->Next = Lo;
+	Own->End = Hi;
+	pthread_mutex_unlock(&Own->Lock);
+	return 1;
+}
+
+static void *WorkerMain(void *p){
+	struct WORK_THREAD *Self = (struct WORK_THREAD *)p;
+	struct WORK_POOL *Pool = Self->Pool;
+	long Index;
+
+	for (;;){
+		while (PopOwn(&Pool->Slices[Self->Id], &Index)){
+			Pool->Func(Pool->Arg, Index);
+		}
+		if (!Steal(Pool, Self->Id)) break;
+	}
+	return NULL;
+}
+
+int RunWorkPool(int Threads, long Count, WORK_FUNC Func, void *Arg){
+	struct WORK_POOL Pool;
+	struct WORK_THREAD *Workers;
+	pthread_t *Ids;
+	int k, Status = 0;
+
+	if (Count <= 0) return 0;
+	if (Threads < 1) Threads = WorkPoolDefaultThreads();
+	if (Threads > Count) Threads = (int)Count;
+
+	Pool.Threads = Threads;
+	Pool.Func = Func;
+	Pool.Arg = Arg;
+	Pool.Slices = calloc(Threads, sizeof(*Pool.Slices));
+	Workers = calloc(Threads, sizeof(*Workers));
+	Ids = calloc(Threads, sizeof(*Ids));
+	if (!Pool.Slices || !Workers || !Ids){
+		free(Pool.Slices);
+		free(Workers);
+		free(Ids);
+		return -1;
+	}
+	for (k=0; k<Threads; k++){
+		pthread_mutex_init(&Pool.Slices[k].Lock, NULL);
+		Pool.Slices[k].Next = Count*k/Threads;
+		Pool.Slices[k].End = Count*(k+1)/Threads;
+		Workers[k].Pool = &Pool;
+		Workers[k].Id = k;
+	}
+	// Worker 0 runs on the calling thread
+	for (k=1; k<Threads; k++){
+		if (pthread_create(&Ids[k], NULL, WorkerMain, &Workers[k]) != 0){
+			Status = -1;
+			Workers[k].Id = -1;
+		}
+	}
+	WorkerMain(&Workers[0]);
+	for (k=1; k<Threads; k++){
+		if (Workers[k].Id >= 0) pthread_join(Ids[k], NULL);
+	}
+	for (k=0; k<Threads; k++){
+		pthread_mutex_destroy(&Pool.Slices[k].Lock);
+	}
+	free(Pool.Slices);
+	free(Workers);
+	free(Ids);
+	return Status;
+}
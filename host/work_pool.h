@@ -0,0 +1,28 @@
+//###########################################################################
+// FILE:   work_pool.h
+// TITLE:  Work-stealing parallel loop for host batch tools
+//###########################################################################
+// RunWorkPool() calls Func(Arg, Index) once for every Index in [0, Count)
+// using Threads worker threads. Each worker starts with an equal slice of
+// the index range and consumes it from the front; a worker that runs dry
+// steals the back half of the busiest remaining slice, so runs that finish
+// early (e.g. diverged simulations) never leave a core idle.
+//###########################################################################
+
+#ifndef WORK_POOL_H
+#define WORK_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*WORK_FUNC)(void *Arg, long Index);
+
+int WorkPoolDefaultThreads(void);
+int RunWorkPool(int Threads, long Count, WORK_FUNC Func, void *Arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end of WORK_POOL_H definition
@@ -0,0 +1,81 @@
+//###########################################################################
+// FILE:   pm_stepper_cla.c
+// TITLE:  C28x side of the CLA build of the control law
+//###########################################################################
+// Message RAM, CLA1 set-up and the trajectory hand-over; see
+// pm_stepper_cla.h.
+//###########################################################################
+
+#include <string.h>
+#include "F28x_Project.h"
+#include "pm_stepper_control.h"
+#include "pm_stepper_cla.h"
+
+#if CLA_BUILD
+
+#ifdef _FLASH
+#pragma CODE_SECTION(PublishTrajectory, "ramfuncs")
+// Load and run addresses of the CLA code and data (28377S_FLASH_lnk.cmd)
+extern Uint16 Cla1funcsLoadStart, Cla1funcsLoadSize, Cla1funcsRunStart;
+extern Uint16 Cla1ConstLoadStart, Cla1ConstLoadSize, Cla1ConstRunStart;
+extern Uint16 CLA1mathTablesLoadStart, CLA1mathTablesLoadSize, CLA1mathTablesRunStart;
+#endif
+
+#pragma DATA_SECTION(ClaInputs, "CpuToCla1MsgRAM")
+#pragma DATA_SECTION(ClaState, "Cla1ToCpuMsgRAM")
+struct CLA_INPUTS ClaInputs;
+struct CLA_STATE ClaState;
+
+// LS4 holds the CLA data (scratchpad, CLAmath tables), LS5 the CLA program;
+// the flash build copies them there first.
+// Task1 starts on ADCAINT1, Task8 is only forced. Returns once Task8 has
+// cleared ClaState at the start position
+void InitCla(const struct CONTROLLER_GAINS *Gains, const struct POSITION_STATE *Position){
+#ifdef _FLASH
+	// While LS4/LS5 still belong to the C28x
+	memcpy(&Cla1funcsRunStart, &Cla1funcsLoadStart, (size_t)&Cla1funcsLoadSize);
+	memcpy(&Cla1ConstRunStart, &Cla1ConstLoadStart, (size_t)&Cla1ConstLoadSize);
+	memcpy(&CLA1mathTablesRunStart, &CLA1mathTablesLoadStart, (size_t)&CLA1mathTablesLoadSize);
+#endif
+	EALLOW;
+	CpuSysRegs.PCLKCR0.bit.CLA1 = 1;
+	MemCfgRegs.MSGxINIT.bit.INIT_CPUTOCLA1 = 1;
+	while (MemCfgRegs.MSGxINITDONE.bit.INITDONE_CPUTOCLA1 != 1) {}
+	MemCfgRegs.MSGxINIT.bit.INIT_CLA1TOCPU = 1;
+	while (MemCfgRegs.MSGxINITDONE.bit.INITDONE_CLA1TOCPU != 1) {}
+	MemCfgRegs.LSxMSEL.bit.MSEL_LS4 = 1;
+	MemCfgRegs.LSxCLAPGM.bit.CLAPGM_LS4 = 0;
+	MemCfgRegs.LSxMSEL.bit.MSEL_LS5 = 1;
+	MemCfgRegs.LSxCLAPGM.bit.CLAPGM_LS5 = 1;
+	Cla1Regs.MVECT1 = (Uint16)((Uint32)&Cla1Task1);
+	Cla1Regs.MVECT8 = (Uint16)((Uint32)&Cla1Task8);
+	Cla1Regs.MCTL.bit.IACKE = 1;
+	Cla1Regs.MIER.all = M_INT1 | M_INT8;
+	DmaClaSrcSelRegs.CLA1TASKSRCSEL1.bit.TASK1 = CLA_TRIG_ADCAINT1;
+	EDIS;
+	ClaInputs.Gains = *Gains;
+	ClaInputs.Raw = Position->Raw;
+	ClaInputs.Tooth = Position->Tooth;
+	ClaInputs.Pole = Position->Pole;
+	InitDiff(&ClaInputs.Speed, CTRL_DIFF_CUTOFF, CTRL_TS);
+	ClaInputs.ThetaD = 0;
+	ClaInputs.DThetaD = 0;
+	ClaInputs.DDThetaD = 0;
+	ClaInputs.DDDThetaD = 0;
+	ClaInputs.Tick = 0;
+	ClaInputs.Stop = 0;
+	Cla1ForceTask8andWait();
+}
+
+// Trajectory of the next tick for Task1, Tick last so that Task1 never takes
+// a new Tick with the previous values
+void PublishTrajectory(struct CONTROLLER_STATE *State){
+	StepTrajectory(State);
+	ClaInputs.ThetaD = State->ThetaD;
+	ClaInputs.DThetaD = State->DThetaD;
+	ClaInputs.DDThetaD = State->DDThetaD;
+	ClaInputs.DDDThetaD = State->DDDThetaD;
+	ClaInputs.Tick = ClaInputs.Tick+1;
+}
+
+#endif
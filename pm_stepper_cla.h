@@ -0,0 +1,95 @@
+//###########################################################################
+// FILE:   pm_stepper_cla.h
+// TITLE:  CLA build of the control law: CLA1 tasks and message RAM
+//###########################################################################
+// Build the firmware with -DCONTROL_MATH=CONTROL_CLA to run the current loop
+// and the adaptive law of StepController() on CLA1 instead of the C28x:
+//  - ePWM1 SOCA converts the ADC_OVERSAMPLING SOCs of ADCA/ADCB every Ts
+//    (CLA_EPWM1_TBPRD), at CTR=0 of ePWM7/ePWM9 since TBCLKSYNC starts all
+//    three together, and the end of the last conversion of ADCA (ADCINT1,
+//    continuous) starts Task1, which
+//    reads the currents and the eQEP count itself, runs the law and writes
+//    EPwm7/EPwm9 CMPA and the GPIO15/GPIO17 directions (pm_stepper_cla.cla).
+//  - The end of Task1 interrupts the C28x (PIE 11.1, cla1_task1_isr), which
+//    logs the tick from ClaState and publishes the trajectory of the next
+//    one in ClaInputs (PublishTrajectory); Timer0 only keeps time.
+// ClaInputs lives in CpuToCla1MsgRAM and only the C28x writes it, ClaState
+// in Cla1ToCpuMsgRAM and only the CLA writes it, so Task8 clears it at
+// start-up (InitCla). Both are shared by two compilers whose int differ in
+// size (16 bits on the C28x, 32 on the CLA): they only hold float and the
+// explicitly sized types.
+// The linker command file places Cla1Prog in RAMLS5, the CLA scratchpad and
+// CLA1mathTables in RAMLS4, and the two message RAM sections; CLAmath
+// (CLAsin/CLAcos) comes from the CLA math library.
+// The host builds the tasks as C (host/pm_stepper_cla_host.c) and
+// pm_stepper_cla_check runs them against StepController().
+//###########################################################################
+
+#ifndef PM_STEPPER_CLA_H
+#define PM_STEPPER_CLA_H
+
+#include "F28x_Project.h"
+#include "pm_stepper_control.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The target only carries the CLA code in the CLA build; the host builds it always
+#if CONTROL_MATH == CONTROL_CLA || !(defined(__TMS320C28XX__) || defined(__TMS320C28XX_CLA__))
+#define CLA_BUILD 1
+#else
+#define CLA_BUILD 0
+#endif
+
+#define CLA_EPWM1_TBPRD 49999			// ePWM1 period of Ts at TBCLK = 50 MHz: one Task1 per tick, 10 ePWM7 periods
+#define CLA_AMPS_PER_CODE CTRL_AMPS_PER_CODE	// Phase current per ADC code, as adca1_isr
+#define CLA_AMPS_PER_SUM CTRL_AMPS_PER_SUM	// Per unit of a sum of ADC_OVERSAMPLING codes, as AdcCurrent
+
+// Written by the C28x, read by Task1
+struct CLA_INPUTS {
+	struct CONTROLLER_GAINS Gains;				// Copied by InitCla
+	int32 Raw, Tooth, Pole;						// Start position (InitPosition) for Task8
+	struct DIFF_STATE Speed;					// Speed differentiator coefficients (InitDiff) for Task8
+	float ThetaD;								// Desired position (rad) at tick Tick
+	float DThetaD, DDThetaD, DDDThetaD;			// Trajectory derivatives at tick Tick
+	Uint32 Tick;								// Tick the trajectory is for, written last
+	Uint16 Stop;								// Nonzero: Task1 drives both phases to 0 V
+};
+
+// Written by the CLA, read by the C28x
+struct CLA_STATE {
+	Uint32 Tick;								// Tick of ClaInputs the last Task1 ran with
+	Uint32 Missed;								// Task1 runs that found no new trajectory
+	int32 Counts, Raw;							// Position (counts, wraps at 32 bits) and last eQEP count
+	int32 Tooth, Pole;							// Phases of Nr*Theta and np*Theta in counts
+	float Theta, DTheta;						// Measured position (rad) and speed estimate
+	float Ia, Ib;								// Phase currents, sign already corrected (A)
+	float Tau;									// Desired torque (N*m)
+	float IaD, IbD;								// Desired currents (A)
+	float Va, Vb;								// Phase voltages (V), not yet saturated to Vmax
+	float Sigma2, Sigma5;						// Current loop adaptive terms
+	float Sigma2Int, Sigma5Int;					// Integrators of Sigma2D/Sigma5D
+	float gammakP[HARMONIC_COUNT], gammakA[HARMONIC_COUNT];	// Torque ripple estimators
+	float gammakPD[HARMONIC_COUNT], gammakAD[HARMONIC_COUNT];	// Derivated torque ripple estimators
+	struct DIFF_STATE Speed;					// Speed differentiator (ClaCalcSpeed)
+};
+
+extern struct CLA_INPUTS ClaInputs;
+extern struct CLA_STATE ClaState;
+
+// CLA tasks (pm_stepper_cla.cla)
+__interrupt void Cla1Task1(void);
+__interrupt void Cla1Task8(void);
+
+#ifndef __TMS320C28XX_CLA__
+// C28x side (pm_stepper_cla.c)
+void InitCla(const struct CONTROLLER_GAINS *Gains, const struct POSITION_STATE *Position);
+void PublishTrajectory(struct CONTROLLER_STATE *State);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end of PM_STEPPER_CLA_H definition
@@ -0,0 +1,291 @@
+//###########################################################################
+// FILE:   pm_stepper_control.c
+// TITLE:  Portable adaptive control law for the PM Stepper Motor
+//###########################################################################
+// StepController() is the body of the former cpu_timer0_isr math. It does
+// not touch any peripheral: the firmware reads the sensors, calls it once per
+// tick and writes Va/Vb to the PWMs. It is StepPositionLoop() followed by
+// StepCurrentLoop(), which the CONTROL_SPLIT build runs at different rates.
+// The electrical angles come in as integer phases within one tooth and one
+// pole pitch, kept by UpdatePosition() from the encoder count, so their
+// sin/cos never see a large argument however far the rotor has turned.
+//###########################################################################
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include "pm_stepper_control.h"
+#include "pm_stepper_trig.h"
+#include "pm_stepper_profile.h"
+
+#if CTRL_NENC != TRIG_TOOTH_COUNTS*CTRL_NR || CTRL_NENC != TRIG_POLE_COUNTS*CTRL_NP
+#error "TRIG_TOOTH_COUNTS and TRIG_POLE_COUNTS do not match CTRL_NENC, CTRL_NR and CTRL_NP"
+#endif
+
+//////////////////////////////////////////////////						//////////////////////////////////////////////////
+//////////////////////////////////////////////////   Controller Gains	//////////////////////////////////////////////////
+//////////////////////////////////////////////////						//////////////////////////////////////////////////
+#define Kp 0.5	 //1
+#define Kd 0.01  //0.01
+#define AlphaA 9 //9
+#define AlphaB 9 //9
+#define Gamma2 1 //1
+#define Gamma5 1 //1
+#define GammakP 0.5 //0.5
+#define GammakA 0.5 //0.5
+#define GammaP 9 //9
+
+// Flash build: the law runs from RAM, copied by InitSysCtrl (28377S_FLASH_lnk.cmd)
+#ifdef _FLASH
+#pragma CODE_SECTION(StepController, "ramfuncs")
+#pragma CODE_SECTION(StepPositionLoop, "ramfuncs")
+#pragma CODE_SECTION(StepCurrentLoop, "ramfuncs")
+#pragma CODE_SECTION(PublishSetpoint, "ramfuncs")
+#pragma CODE_SECTION(PublishCurrents, "ramfuncs")
+#pragma CODE_SECTION(ReadCurrents, "ramfuncs")
+#pragma CODE_SECTION(StepTrajectory, "ramfuncs")
+#pragma CODE_SECTION(StepPhase, "ramfuncs")
+#pragma CODE_SECTION(UpdatePosition, "ramfuncs")
+#pragma CODE_SECTION(CalcPosition, "ramfuncs")
+#pragma CODE_SECTION(CalcCounts, "ramfuncs")
+#pragma CODE_SECTION(CalcPosDesired, "ramfuncs")
+#pragma CODE_SECTION(CalcSpeedDesired, "ramfuncs")
+#endif
+
+// Section boundaries for the cycle profiler, once the firmware has set the hook
+#if PROFILE_ENABLE
+#define MarkSection(Section) if (State->Mark) State->Mark(Section)
+#else
+#define MarkSection(Section)
+#endif
+
+// Reference trajectory t^3*(TRAJ_C3-TRAJ_C4*t+TRAJ_C5*t^2) (rad)
+#define TRAJ_C3 0.314159265358979f
+#define TRAJ_C4 0.047123889803847f
+#define TRAJ_C5 0.001884955592154f
+
+// Bodies of the harmonic loops of StepController, expanded by HARMONICS()
+#define RippleTorque(k) sum = sum+(gammakP[k]*C[k]+gammakA[k]*S[k]);
+#define RippleDerivatives(k) \
+	aux1 = gammakAD[k]*S[k]+gammakA[k]*((k+1)*CTRL_NP)*DTheta*C[k]; \
+	aux2 = gammakPD[k]*C[k]+gammakP[k]*((k+1)*CTRL_NP)*DTheta*S[k]; \
+	aux3 = gammakPD[k]*cose-gammakP[k]*CTRL_NR*DTheta*seno; \
+	sum1 = sum1+(aux1+aux2); \
+	sum2 = sum2+(aux1+aux3);
+#define RippleAdaptation(k) \
+	gammakPD[k] = -G->gammaKP*foo*C[k]; \
+	gammakAD[k] = -G->gammaKA*foo*S[k]; \
+	gammakP[k] = gammakP[k]+gammakPD[k]*CTRL_TS; \
+	gammakA[k] = gammakA[k]+gammakAD[k]*CTRL_TS;
+
+void InitControllerGains(struct CONTROLLER_GAINS *Gains){
+	Gains->kp = Kp;
+	Gains->kd = Kd;
+	Gains->alphaA = AlphaA;
+	Gains->alphaB = AlphaB;
+	Gains->gamma2 = Gamma2;
+	Gains->gamma5 = Gamma5;
+	Gains->gammaKP = GammakP;
+	Gains->gammaKA = GammakA;
+	Gains->gammaP = GammaP;
+}
+
+// Resets the law state only. The trig tables do not depend on it, they are
+// filled once at start-up by InitTrigTable()
+void InitController(struct CONTROLLER_STATE *State){
+	memset(State, 0, sizeof(*State));
+	InitControllerGains(&State->Gains);
+	InitDiff(&State->Speed, CTRL_DIFF_CUTOFF, CTRL_TS);
+	InitDiff(&State->Acel, CTRL_DIFF_CUTOFF, CTRL_TS);
+	InitDiff(&State->DAcel, CTRL_DIFF_CUTOFF, CTRL_TS);
+	InitIntegrator(&State->Sigma2Int, CTRL_TS);
+	InitIntegrator(&State->Sigma5Int, CTRL_TS);
+}
+
+void StepController(struct CONTROLLER_STATE *State, const struct CONTROLLER_INPUTS *In, struct CONTROLLER_OUTPUTS *Out){
+	struct CURRENT_SETPOINT Setpoint;
+	StepPositionLoop(State, In, &Setpoint);
+	StepCurrentLoop(&Setpoint, In->Ia, In->Ib, Out);
+}
+
+// Trajectory, position loop, desired currents and the adaptation, once per
+// Ts. In->Ia/Ib are the latest currents, for the adaptation only
+void StepPositionLoop(struct CONTROLLER_STATE *State, const struct CONTROLLER_INPUTS *In, struct CURRENT_SETPOINT *Setpoint){
+	float Sigma2D=0, Sigma5D=0;							// Integral terms of current loops
+	float ha=0, hb=0;									//
+	float seno=0, cose=0, S[HARMONIC_COUNT], C[HARMONIC_COUNT];	// Sine and cosine
+	float IaT=0, IbT=0; 								// Currents errors
+	float ThetaT=0, DThetaT=0;							// Position and speed errors
+	float foo=0, sum=0, sum1=0, sum2=0, aux1=0, aux2=0, aux3=0;
+	float Theta=0, DTheta=0, Tau=0, IaD=0, IbD=0;
+	float *gammakP=State->gammakP, *gammakA=State->gammakA;
+	float *gammakPD=State->gammakPD, *gammakAD=State->gammakAD;
+	const struct CONTROLLER_GAINS *G=&State->Gains;
+	//////////////////////////////////////////////////						//////////////////////////////////////////////////
+	//////////////////////////////////////////////////		Variables		//////////////////////////////////////////////////
+	//////////////////////////////////////////////////						//////////////////////////////////////////////////
+	StepTrajectory(State);
+	Theta = In->Theta;
+	State->Theta = Theta;
+	DTheta = StepDiff(&State->Speed, Theta);
+	State->DTheta = DTheta;
+	MarkSection(PROFILE_SENSING);
+#if TRIG_BACKEND == TRIG_COUNTS
+	CalcToothSinCos(In->Tooth, &seno, &cose);
+	CalcPoleHarmonics(In->Pole, S, C, HARMONIC_COUNT);
+#else
+	seno = TrigSin(In->Tooth*TRIG_TOOTH_RAD);
+	cose = TrigCos(In->Tooth*TRIG_TOOTH_RAD);
+	CalcHarmonics(In->Pole*TRIG_POLE_RAD, S, C, HARMONIC_COUNT);
+#endif
+	MarkSection(PROFILE_TRIG);
+	//////////////////////////////////////////////////						//////////////////////////////////////////////////
+	//////////////////////////////////////////////////		Controller		//////////////////////////////////////////////////
+	//////////////////////////////////////////////////						//////////////////////////////////////////////////
+	ThetaT = Theta-State->ThetaD;
+	DThetaT = DTheta-State->DThetaD;
+	sum = 0;
+	HARMONICS(RippleTorque)
+	Tau = -G->kp*ThetaT-G->kd*DThetaT+sum+CTRL_J*State->DDThetaD;
+	IaD = -Tau*seno*CTRL_KMI;
+	IbD = Tau*cose*CTRL_KMI;
+	IaT = In->Ia-IaD;
+	IbT = In->Ib-IbD;
+	Sigma2D = -G->gamma2*IaT*Tau*DTheta*cose;
+	Sigma5D = -G->gamma5*IbT*Tau*DTheta*seno;
+	State->Sigma2 = StepIntegrator(&State->Sigma2Int, Sigma2D)*Tau*DTheta;
+	State->Sigma5 = StepIntegrator(&State->Sigma5Int, Sigma5D)*Tau*DTheta;
+	sum1 = 0;
+	sum2 = 0;
+	HARMONICS(RippleDerivatives)
+	ha = -CTRL_LKMI*(sum1+CTRL_J*State->DDDThetaD)*seno;
+	hb = CTRL_LKMI*(sum2+CTRL_J*State->DDDThetaD)*cose;
+	Setpoint->IaD = IaD;
+	Setpoint->IbD = IbD;
+	if (CTRL_TEST == 1){
+		Setpoint->GainA = 0;
+		Setpoint->GainB = 0;
+		Setpoint->Va0 = -TrigSin(100*State->time)*CTRL_VMAX; // 1500
+		Setpoint->Vb0 = TrigCos(100*State->time)*CTRL_VMAX;
+	}
+	else{
+		Setpoint->GainA = G->alphaA;
+		Setpoint->GainB = G->alphaB;
+		Setpoint->Va0 = State->Sigma2*cose+CTRL_R*IaD-CTRL_KM*State->DThetaD*seno+ha;
+		Setpoint->Vb0 = State->Sigma5*seno+CTRL_R*IbD+CTRL_KM*State->DThetaD*cose+hb;
+	}
+	MarkSection(PROFILE_CONTROLLER);
+	foo = G->gammaP*ThetaT+DThetaT-CTRL_LJKMI*G->kd*IaT*seno+CTRL_LJKMI*G->kd*IbT*cose;
+	HARMONICS(RippleAdaptation)
+	State->Tau = Tau;
+	State->IaD = IaD;
+	State->IbD = IbD;
+	MarkSection(PROFILE_ADAPTATION);
+}
+
+// Current loop on the latest sampled currents (A), at any multiple of 1/Ts
+void StepCurrentLoop(const volatile struct CURRENT_SETPOINT *Setpoint, float Ia, float Ib, struct CONTROLLER_OUTPUTS *Out){
+	Out->Va = Setpoint->Va0-Setpoint->GainA*(Ia-Setpoint->IaD);
+	Out->Vb = Setpoint->Vb0-Setpoint->GainB*(Ib-Setpoint->IbD);
+}
+
+// Both buffers at zero current and voltage until the first PublishSetpoint
+void InitSetpointMailbox(struct SETPOINT_MAILBOX *Mailbox){
+	memset((void *)Mailbox, 0, sizeof(*Mailbox));
+}
+
+void PublishSetpoint(struct SETPOINT_MAILBOX *Mailbox, const struct CURRENT_SETPOINT *Setpoint){
+	int Next = Mailbox->Index^1;
+	Mailbox->Buffer[Next] = *Setpoint;
+	Mailbox->Index = Next;
+}
+
+void PublishCurrents(struct CURRENT_SNAPSHOT *Snapshot, float Ia, float Ib){
+	Snapshot->Seq = Snapshot->Seq+1;
+	Snapshot->Ia = Ia;
+	Snapshot->Ib = Ib;
+	Snapshot->Seq = Snapshot->Seq+1;
+}
+
+// Returns the Seq of the pair, which only changes with a new sample
+unsigned ReadCurrents(const struct CURRENT_SNAPSHOT *Snapshot, float *Ia, float *Ib){
+	unsigned Seq;
+	do {
+		Seq = Snapshot->Seq;
+		*Ia = Snapshot->Ia;
+		*Ib = Snapshot->Ib;
+	} while ((Seq & 1) || Seq != Snapshot->Seq);
+	return Seq;
+}
+
+// Reference trajectory and its derivatives at the next tick. The CLA build
+// runs it on the C28x a tick ahead of the law (PublishTrajectory)
+void StepTrajectory(struct CONTROLLER_STATE *State){
+	State->time += CTRL_TS;
+	State->ThetaD = CalcPosDesired(State->time);
+	State->DThetaD = CalcSpeedDesired(State, State->time);
+	State->DDThetaD = StepDiff(&State->Acel, State->DThetaD);
+	State->DDDThetaD = StepDiff(&State->DAcel, State->DDThetaD);
+}
+
+// Phase moved by Delta counts, back in [0, Period): one compare per tick,
+// a division only for a step of a whole period or more
+static int StepPhase(int Phase, long Delta, int Period){
+	long p = Phase+((Delta > -Period && Delta < Period) ? Delta : Delta % Period);
+	if (p >= Period) p = p-Period;
+	else if (p < 0) p = p+Period;
+	return (int)p;
+}
+
+void InitPosition(struct POSITION_STATE *Position, long Raw){
+	Position->Counts = Raw;
+	Position->Raw = Raw;
+	Position->Tooth = StepPhase(0, Raw, TRIG_TOOTH_COUNTS);
+	Position->Pole = StepPhase(0, Raw, TRIG_POLE_COUNTS);
+}
+
+// Raw is the eQEP count, which wraps at 32 bits and may be reset to 0 by the
+// index pulse: the difference is taken modulo 2^32 and then folded to within
+// half a turn, the most the rotor can move in a tick. Nenc is a multiple of
+// both pitches, so the folding never moves the phases.
+void UpdatePosition(struct POSITION_STATE *Position, long Raw){
+	long Delta = (int32_t)((uint32_t)Raw-(uint32_t)Position->Raw);
+	Position->Raw = Raw;
+	if (Delta > CTRL_NENC/2) Delta = Delta-CTRL_NENC;
+	else if (Delta < -CTRL_NENC/2) Delta = Delta+CTRL_NENC;
+	Position->Counts = Position->Counts+Delta;
+	Position->Tooth = StepPhase(Position->Tooth, Delta, TRIG_TOOTH_COUNTS);
+	Position->Pole = StepPhase(Position->Pole, Delta, TRIG_POLE_COUNTS);
+}
+
+// Mechanical position (rad) for the position loop; only float accurate, the
+// commutation does not depend on it
+float CalcPosition(const struct POSITION_STATE *Position){
+	return Position->Counts*0.0001570796327f; // 40000(counts)=2pi(rad)
+}
+
+// Nearest encoder count of a position, for host tools that only have Theta
+long CalcCounts(float Theta){
+	return (long)floor(Theta*(CTRL_NENC/6.283185307179586)+0.5);
+}
+
+float CalcPosDesired(float t){
+	float foo=0, trajectory=0;
+	foo = t*t*t;
+	//trajectory = foo*((0.00037699L*t*t)-(0.0094248L*t)+0.062832L); //Desired Position (trajectory)
+	//trajectory = foo*((0.00075398223686L*t*t)-(0.018849555921539L*t)+0.125663706143592L);
+	trajectory = foo*((TRAJ_C5*t*t)-(TRAJ_C4*t)+TRAJ_C3);
+	return trajectory;
+}
+
+// (CalcPosDesired(t)-CalcPosDesired(u))/Ts, u the time of the last tick. In
+// float the difference of two positions a tick apart keeps a few bits, so
+// it is taken as (t-u), which is exact, times the quotient polynomial
+// (t^n-u^n)/(t-u) of each term
+float CalcSpeedDesired(struct CONTROLLER_STATE *State, float t){
+	float u=State->pastTime, t2=t*t, u2=u*u, tu=t*u, DTrajectory=0;
+	DTrajectory = TRAJ_C5*(t2*t2+tu*(t2+u2)+tu*tu+u2*u2)-TRAJ_C4*(t+u)*(t2+u2)+TRAJ_C3*(t2+tu+u2);
+	DTrajectory = (t-u)*DTrajectory*CTRL_ITS; //Speed in rad/s
+	State->pastTime = t;
+	return DTrajectory;
+}
@@ -0,0 +1,201 @@
+//###########################################################################
+// FILE:   pm_stepper_control.h
+// TITLE:  Portable adaptive control law for the PM Stepper Motor
+//###########################################################################
+// The control law only depends on <math.h>, so the same file is built by CCS
+// for the F28377S and by gcc/clang on the host (see CMakeLists.txt).
+// The CLA compiler only sees the constants and the float-only structs: it
+// has no 64-bit integers and no function pointers.
+//###########################################################################
+
+#ifndef PM_STEPPER_CONTROL_H
+#define PM_STEPPER_CONTROL_H
+
+#include "pm_stepper_filter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//////////////////////////////////////////////////						//////////////////////////////////////////////////
+//////////////////////////////////////////////////   Controller Gains	//////////////////////////////////////////////////
+//////////////////////////////////////////////////						//////////////////////////////////////////////////
+// The gains are the defaults of CONTROLLER_GAINS, in pm_stepper_control.c.
+// This header is included by the firmware and by the host tools, often
+// next to <math.h>, so its names carry a CTRL_ prefix.
+#define CTRL_TEST 0					// 1 = rotating field at Vmax instead of the law
+#define CTRL_DIFF_CUTOFF 10.0f		// Corner of the speed and trajectory differentiators (rad/s)
+#ifndef HARMONIC_COUNT
+#define HARMONIC_COUNT 3			// Torque ripple harmonics, 1..8 (-DHARMONIC_COUNT=<n>)
+#endif
+//////////////////////////////////////////////////						//////////////////////////////////////////////////
+//////////////////////////////////////////////////   System Constants	//////////////////////////////////////////////////
+//////////////////////////////////////////////////						//////////////////////////////////////////////////
+// Typed: a double or long double operand (a literal without f) makes the
+// C28x call the rts2800 software routines, and so does a division, which
+// the FPU does not have. The quotients below are folded by the compiler.
+#define CTRL_R 5.0f					// Phase Winding Resistance (Ohm)
+#define CTRL_L 0.006f				// Phase Winding Inductance (H)
+#define CTRL_KM 0.1f				// Motor Torque Constant (N*m/A) 0.15
+#define CTRL_J 0.0001872f			// Rotor Inertia (kg*m^2)
+#define CTRL_B 0.002f				// Rotor Damping (N*m/(rad/s))
+#define CTRL_NR 50					// Number of teeth
+#define CTRL_NP 8					// Number of poles
+#define CTRL_NENC 40000				// Encoder counts per revolution (eQEP1, x4)
+#define CTRL_TS 0.001f				// Control tick (s)
+#define CTRL_ITS 1000.0f			// Ticks per second, 1/Ts
+#define CTRL_VMAX 12				// Largest phase voltage, the bus (V)
+#define CTRL_TF 10					// Length of the run (s)
+#define CURRENT_LOOP_RATIO 10		// Current loop steps per tick of Ts, one per 10 kHz PWM period (CONTROL_SPLIT)
+#ifndef ADC_OVERSAMPLING
+#define ADC_OVERSAMPLING 4			// Conversions per phase current and trigger, averaged, 1..16 (-DADC_OVERSAMPLING=<n>)
+#endif
+#define CTRL_KMI (1.0f/CTRL_KM)
+#define CTRL_LKMI (CTRL_L/CTRL_KM)					// L/km
+#define CTRL_LJKMI (CTRL_L/(CTRL_J*CTRL_KM))		// L/(J*km)
+#define CTRL_VMAXI (1.0f/CTRL_VMAX)
+#define CTRL_AMPS_PER_CODE 0.000791452315f		// Phase current per ADC code (A)
+#define CTRL_AMPS_PER_SUM (CTRL_AMPS_PER_CODE*(1.0f/ADC_OVERSAMPLING))	// Per unit of a sum of ADC_OVERSAMPLING codes
+
+// HARMONICS(X) is X(0) X(1) ... X(HARMONIC_COUNT-1): the harmonic loops of
+// the control laws unrolled at compile time, with the harmonic index a
+// literal so that (k+1)*np folds into a constant
+#if HARMONIC_COUNT == 1
+#define HARMONICS(X) X(0)
+#elif HARMONIC_COUNT == 2
+#define HARMONICS(X) X(0) X(1)
+#elif HARMONIC_COUNT == 3
+#define HARMONICS(X) X(0) X(1) X(2)
+#elif HARMONIC_COUNT == 4
+#define HARMONICS(X) X(0) X(1) X(2) X(3)
+#elif HARMONIC_COUNT == 5
+#define HARMONICS(X) X(0) X(1) X(2) X(3) X(4)
+#elif HARMONIC_COUNT == 6
+#define HARMONICS(X) X(0) X(1) X(2) X(3) X(4) X(5)
+#elif HARMONIC_COUNT == 7
+#define HARMONICS(X) X(0) X(1) X(2) X(3) X(4) X(5) X(6)
+#elif HARMONIC_COUNT == 8
+#define HARMONICS(X) X(0) X(1) X(2) X(3) X(4) X(5) X(6) X(7)
+#else
+#error "HARMONIC_COUNT must be 1..8"
+#endif
+#if ADC_OVERSAMPLING < 1 || ADC_OVERSAMPLING > 16
+#error "ADC_OVERSAMPLING must be 1..16, one SOC each"
+#endif
+
+// Build of the law the firmware runs, -DCONTROL_MATH=<n>:
+//   CONTROL_FLOAT StepController() from cpu_timer0_isr
+//   CONTROL_IQ    StepControllerIQ() from cpu_timer0_isr (pm_stepper_control_iq.h)
+//   CONTROL_CLA   current loop and adaptation in CLA1 Task1 (pm_stepper_cla.h)
+//   CONTROL_SPLIT StepPositionLoop() from cpu_timer0_isr every Ts and
+//                 StepCurrentLoop() from adca1_isr at every PWM period,
+//                 CURRENT_LOOP_RATIO times per Ts, which preempts it
+#define CONTROL_FLOAT 0
+#define CONTROL_IQ 1
+#define CONTROL_CLA 2
+#define CONTROL_SPLIT 3
+
+#ifndef CONTROL_MATH
+#define CONTROL_MATH CONTROL_FLOAT
+#endif
+
+// Run-time copy of the Controller Gains, so host tools can perturb them
+struct CONTROLLER_GAINS {
+	float kp, kd;					// Kp, Kd: position loop
+	float alphaA, alphaB;			// AlphaA, AlphaB: current loops
+	float gamma2, gamma5;			// Gamma2, Gamma5: current loop adaptation
+	float gammaKP, gammaKA;			// GammakP, GammakA: torque ripple adaptation
+	float gammaP;					// GammaP (gamma): position weight of the adaptation error
+};
+
+#ifndef __TMS320C28XX_CLA__
+
+// Encoder position, accumulated from the wrapping eQEP count (UpdatePosition)
+struct POSITION_STATE {
+	long long Counts;		// Mechanical position (counts), 64-bit so it never wraps
+	long Raw;				// Last eQEP count
+	int Tooth;				// Counts modulo Nenc/Nr: electrical angle of Nr*Theta
+	int Pole;				// Counts modulo Nenc/np: angle of np*Theta
+};
+
+// Everything the control law remembers from one tick to the next
+struct CONTROLLER_STATE {
+	struct CONTROLLER_GAINS Gains;					// Set to the Controller Gains by InitController
+	float time;										// Time since start (s)
+	float Theta, ThetaD;							// Measured and desired position (rad)
+	float DTheta, DThetaD, DDThetaD, DDDThetaD;		// Speed estimate and trajectory derivatives
+	float Tau;										// Desired torque (N*m)
+	float IaD, IbD;									// Desired currents (A)
+	float Sigma2, Sigma5;							// Current loop adaptive terms
+	struct INTEGRATOR_STATE Sigma2Int, Sigma5Int;	// Integrators of Sigma2D/Sigma5D
+	float gammakP[HARMONIC_COUNT], gammakA[HARMONIC_COUNT];	// Torque ripple estimators
+	float gammakPD[HARMONIC_COUNT], gammakAD[HARMONIC_COUNT];	// Derivated torque ripple estimators
+	float pastTime;									// CalcSpeedDesired memory: time of the last tick
+	struct DIFF_STATE Speed, Acel, DAcel;			// Differentiators of Theta, DThetaD and DDThetaD
+	void (*Mark)(int Section);						// Profiler section boundary (ProfileMark), NULL if unused
+};
+
+// Sensed values for one tick
+struct CONTROLLER_INPUTS {
+	float Theta;			// Rotor position (rad)
+	int Tooth, Pole;		// Phases of Nr*Theta and np*Theta in counts (POSITION_STATE)
+	float Ia, Ib;			// Phase currents, sign already corrected (A)
+};
+
+// Phase voltages requested for one tick
+struct CONTROLLER_OUTPUTS {
+	float Va, Vb;			// Phase voltages (V), not yet saturated to Vmax
+};
+
+// What StepCurrentLoop needs from the last StepPositionLoop: the phase
+// voltages are Va0-GainA*(Ia-IaD) and Vb0-GainB*(Ib-IbD)
+struct CURRENT_SETPOINT {
+	float IaD, IbD;			// Desired currents (A)
+	float GainA, GainB;		// Current loop gains alphaA/alphaB, 0 for the TEST voltages (V/A)
+	float Va0, Vb0;			// Voltages at zero current error: resistive, back EMF, L*dI/dt and adaptive terms (V)
+};
+
+// Lock-free handoff of the setpoint from StepPositionLoop to StepCurrentLoop
+// when the current loop runs in an interrupt that preempts the position
+// loop. PublishSetpoint fills the buffer the reader does not use and then
+// flips Index with one store, so a reader that is never itself preempted by
+// the writer always sees a whole setpoint, the last or the one before.
+struct SETPOINT_MAILBOX {
+	volatile struct CURRENT_SETPOINT Buffer[2];
+	volatile int Index;		// Buffer of the last published setpoint
+};
+
+// Phase currents of one conversion, from the acquisition interrupt to the
+// control tick. PublishCurrents makes Seq odd while it writes the pair;
+// ReadCurrents copies it again until Seq is even and the same before and
+// after, so Ia and Ib always come from the same sample. ReadCurrents must
+// not run in an interrupt that preempts PublishCurrents.
+struct CURRENT_SNAPSHOT {
+	volatile unsigned Seq;	// Twice the samples published
+	volatile float Ia, Ib;	// Phase currents, sign already corrected (A)
+};
+
+void InitControllerGains(struct CONTROLLER_GAINS *Gains);
+void InitController(struct CONTROLLER_STATE *State);
+void StepController(struct CONTROLLER_STATE *State, const struct CONTROLLER_INPUTS *In, struct CONTROLLER_OUTPUTS *Out);
+void StepPositionLoop(struct CONTROLLER_STATE *State, const struct CONTROLLER_INPUTS *In, struct CURRENT_SETPOINT *Setpoint);
+void StepCurrentLoop(const volatile struct CURRENT_SETPOINT *Setpoint, float Ia, float Ib, struct CONTROLLER_OUTPUTS *Out);
+void InitSetpointMailbox(struct SETPOINT_MAILBOX *Mailbox);
+void PublishSetpoint(struct SETPOINT_MAILBOX *Mailbox, const struct CURRENT_SETPOINT *Setpoint);
+void PublishCurrents(struct CURRENT_SNAPSHOT *Snapshot, float Ia, float Ib);
+unsigned ReadCurrents(const struct CURRENT_SNAPSHOT *Snapshot, float *Ia, float *Ib);
+void StepTrajectory(struct CONTROLLER_STATE *State);
+void InitPosition(struct POSITION_STATE *Position, long Raw);
+void UpdatePosition(struct POSITION_STATE *Position, long Raw);
+float CalcPosition(const struct POSITION_STATE *Position);
+long CalcCounts(float Theta);
+float CalcPosDesired(float t);
+float CalcSpeedDesired(struct CONTROLLER_STATE *State, float t);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end of PM_STEPPER_CONTROL_H definition
@@ -0,0 +1,199 @@
+//###########################################################################
+// FILE:   pm_stepper_control_iq.c
+// TITLE:  IQmath fixed-point build of the adaptive control law
+//###########################################################################
+// Line by line the same law as StepController(); see
+// pm_stepper_control_iq.h for the Q formats.
+//###########################################################################
+
+#include <string.h>
+#include "pm_stepper_control_iq.h"
+#include "pm_stepper_trig.h"
+#include "pm_stepper_profile.h"
+
+// The target only carries the law it runs; the host builds both
+#if CONTROL_MATH == CONTROL_IQ || !defined(__TMS320C28XX__)
+
+// Flash build: the law runs from RAM, copied by InitSysCtrl (28377S_FLASH_lnk.cmd)
+#ifdef _FLASH
+#pragma CODE_SECTION(StepControllerIQ, "ramfuncs")
+#pragma CODE_SECTION(CalcPositionIQ, "ramfuncs")
+#pragma CODE_SECTION(CalcPosDesiredIQ, "ramfuncs")
+#pragma CODE_SECTION(CalcDiffIQ, "ramfuncs")
+#pragma CODE_SECTION(LimitIQ, "ramfuncs")
+#endif
+
+#if PROFILE_ENABLE
+#define MarkSection(Section) if (State->Mark) State->Mark(Section)
+#else
+#define MarkSection(Section)
+#endif
+
+#define IQ_RAD_PER_COUNT ((long long)(6.283185307179586L/CTRL_NENC*1099511627776.0L+0.5L))	// Q40
+#define IQ_TICKS_PER_S ((long)(CTRL_ITS+0.5f))
+#define IQ_S_PER_TICK _IQ30(CTRL_TS/CTRL_TF)						// Normalized trajectory time per tick
+#define IQ_TRAJ_C3 _IQ20(0.314159265358979L*CTRL_TF*CTRL_TF*CTRL_TF)	// CalcPosDesired() in s = t/tf
+#define IQ_TRAJ_C4 _IQ20(-0.047123889803847L*CTRL_TF*CTRL_TF*CTRL_TF*CTRL_TF)
+#define IQ_TRAJ_C5 _IQ20(0.001884955592154L*CTRL_TF*CTRL_TF*CTRL_TF*CTRL_TF*CTRL_TF)
+#define IQ_TS _IQ30(CTRL_TS)
+#define IQ_J _IQ30(CTRL_J)
+#define IQ_KMI _IQ(CTRL_KMI)
+#define IQ_KM _IQ(CTRL_KM)
+#define IQ_R _IQ(CTRL_R)
+#define IQ_LKMI _IQ30(CTRL_LKMI)
+#define IQ_LJKMI _IQ20(CTRL_LJKMI)
+#define IQ_TOOTH_RAD ((long)(6.283185307179586L/TRIG_TOOTH_COUNTS*268435456.0L+0.5L))	// Q28
+#define IQ_POLE_RAD ((long)(6.283185307179586L/TRIG_POLE_COUNTS*268435456.0L+0.5L))		// Q28
+#define IQ_2PI _IQ(6.283185307179586L)
+
+// Coefficients of InitDiff, memory at rest
+static void InitDiffIQ(struct DIFF_IQ_STATE *Diff){
+	struct DIFF_STATE Float;
+	InitDiff(&Float, CTRL_DIFF_CUTOFF, CTRL_TS);
+	Diff->Pole = _IQ30(Float.Pole);
+	Diff->Gain = _IQ(Float.Gain);
+	Diff->x_1 = 0;
+	Diff->y_1 = 0;
+}
+
+void InitControllerIQ(struct CONTROLLER_IQ_STATE *State, const struct CONTROLLER_GAINS *Gains){
+	memset(State, 0, sizeof(*State));
+	State->kp = _IQ(Gains->kp);
+	State->kd = _IQ(Gains->kd);
+	State->alphaA = _IQ(Gains->alphaA);
+	State->alphaB = _IQ(Gains->alphaB);
+	State->gamma2 = _IQ(Gains->gamma2);
+	State->gamma5 = _IQ(Gains->gamma5);
+	State->gammaKP = _IQ(Gains->gammaKP);
+	State->gammaKA = _IQ(Gains->gammaKA);
+	State->gammaP = _IQ(Gains->gammaP);
+	InitDiffIQ(&State->Speed);
+	InitDiffIQ(&State->Acel);
+	InitDiffIQ(&State->DAcel);
+}
+
+// Rotor position (rad) in Q20 from the 64-bit count, good to +/-2048 rad
+_iq20 CalcPositionIQ(const struct POSITION_STATE *Position){
+	return (_iq20)((Position->Counts*IQ_RAD_PER_COUNT) >> 20);
+}
+
+// s^3*(C3+s*(C4+s*C5)): a Q30 factor keeps the Q20 of the other. s is Q30,
+// so Tick must stay below 2*tf/Ts
+_iq20 CalcPosDesiredIQ(long Tick){
+	_iq30 s = _IQmpyI32(IQ_S_PER_TICK, Tick);
+	_iq20 p;
+	p = IQ_TRAJ_C4+_IQ30mpy(IQ_TRAJ_C5, s);
+	p = IQ_TRAJ_C3+_IQ30mpy(p, s);
+	return _IQ30mpy(_IQ30mpy(_IQ30mpy(p, s), s), s);
+}
+
+// Integrators and the filter round to nearest: truncation would add a
+// one-LSB bias every tick
+static _iq20 CalcDiffIQ(struct DIFF_IQ_STATE *Diff, _iq20 x){
+	_iq20 y = _IQ30rmpy(Diff->y_1, Diff->Pole)+_IQrmpy(x-Diff->x_1, Diff->Gain);
+	Diff->x_1 = x;
+	Diff->y_1 = y;
+	return y;
+}
+
+// Q20 to Q24, clamped to +/-Max
+static _iq LimitIQ(_iq20 x, long Max){
+	return _IQ20toIQ(_IQsat(x, Max << IQ_POS, -(Max << IQ_POS)));
+}
+
+// Bodies of the harmonic loops of StepControllerIQ, expanded by HARMONICS()
+#define RippleTorqueIQ(k) sum = sum+(_IQmpy(gammakP[k], C[k])+_IQmpy(gammakA[k], S[k]));
+#define RippleDerivativesIQ(k) \
+	aux1 = _IQmpy(gammakAD[k], S[k])+_IQmpy(_IQmpy(gammakA[k], DTheta), C[k])*((k+1)*CTRL_NP); \
+	aux2 = _IQmpy(gammakPD[k], C[k])+_IQmpy(_IQmpy(gammakP[k], DTheta), S[k])*((k+1)*CTRL_NP); \
+	aux3 = _IQmpy(gammakPD[k], cose)-_IQmpy(_IQmpy(gammakP[k], DTheta), seno)*CTRL_NR; \
+	sum1 = sum1+(aux1+aux2); \
+	sum2 = sum2+(aux1+aux3);
+#define RippleAdaptationIQ(k) \
+	gammakPD[k] = -_IQmpy(_IQmpy(State->gammaKP, foo), C[k]); \
+	gammakAD[k] = -_IQmpy(_IQmpy(State->gammaKA, foo), S[k]); \
+	gammakP[k] = gammakP[k]+_IQ30rmpy(gammakPD[k], IQ_TS); \
+	gammakA[k] = gammakA[k]+_IQ30rmpy(gammakAD[k], IQ_TS);
+
+void StepControllerIQ(struct CONTROLLER_IQ_STATE *State, const struct CONTROLLER_IQ_INPUTS *In, struct CONTROLLER_IQ_OUTPUTS *Out){
+	_iq Sigma2D, Sigma5D;
+	_iq ha, hb;
+	_iq seno, cose, S[HARMONIC_COUNT], C[HARMONIC_COUNT];
+	_iq IaT, IbT;
+	_iq ThetaT, DThetaT;
+	_iq foo, sum, sum1, sum2, aux1, aux2, aux3;
+	_iq DTheta, DThetaD, DDThetaD, DDDThetaD, Tau, IaD, IbD, x;
+	_iq *gammakP=State->gammakP, *gammakA=State->gammakA;
+	_iq *gammakPD=State->gammakPD, *gammakAD=State->gammakAD;
+	int i;
+	//////////////////////////////////////////////////						//////////////////////////////////////////////////
+	//////////////////////////////////////////////////		Variables		//////////////////////////////////////////////////
+	//////////////////////////////////////////////////						//////////////////////////////////////////////////
+	State->Tick++;
+	State->Theta = In->Theta;
+	State->ThetaD = CalcPosDesiredIQ(State->Tick);
+	State->DTheta = CalcDiffIQ(&State->Speed, In->Theta);
+	State->DThetaD = (State->ThetaD-State->pastTrajectory)*IQ_TICKS_PER_S;
+	State->pastTrajectory = State->ThetaD;
+	State->DDThetaD = CalcDiffIQ(&State->Acel, State->DThetaD);
+	State->DDDThetaD = CalcDiffIQ(&State->DAcel, State->DDThetaD);
+	DTheta = LimitIQ(State->DTheta, IQ_SPEED_MAX);
+	DThetaD = LimitIQ(State->DThetaD, IQ_SPEED_MAX);
+	DDThetaD = LimitIQ(State->DDThetaD, IQ_SPEED_MAX);
+	DDDThetaD = LimitIQ(State->DDDThetaD, IQ_SPEED_MAX);
+	MarkSection(PROFILE_SENSING);
+	x = (IQ_TOOTH_RAD*In->Tooth) >> 4;
+	seno = _IQsin(x);
+	cose = _IQcos(x);
+	x = (IQ_POLE_RAD*In->Pole) >> 4;
+	S[0] = _IQsin(x);
+	C[0] = _IQcos(x);
+	for (i=1; i<HARMONIC_COUNT; i++){
+		S[i] = _IQmpy(S[i-1], C[0])+_IQmpy(C[i-1], S[0]);
+		C[i] = _IQmpy(C[i-1], C[0])-_IQmpy(S[i-1], S[0]);
+	}
+	MarkSection(PROFILE_TRIG);
+	//////////////////////////////////////////////////						//////////////////////////////////////////////////
+	//////////////////////////////////////////////////		Controller		//////////////////////////////////////////////////
+	//////////////////////////////////////////////////						//////////////////////////////////////////////////
+	ThetaT = LimitIQ(State->Theta-State->ThetaD, IQ_ERR_MAX);
+	DThetaT = LimitIQ(State->DTheta-State->DThetaD, IQ_ERR_MAX);
+	sum = 0;
+	HARMONICS(RippleTorqueIQ)
+	Tau = -_IQmpy(State->kp, ThetaT)-_IQmpy(State->kd, DThetaT)+sum+_IQ30mpy(DDThetaD, IQ_J);
+	IaD = -_IQmpy(_IQmpy(Tau, seno), IQ_KMI);
+	IbD = _IQmpy(_IQmpy(Tau, cose), IQ_KMI);
+	IaT = In->Ia-IaD;
+	IbT = In->Ib-IbD;
+	Sigma2D = -_IQmpy(_IQmpy(_IQmpy(_IQmpy(State->gamma2, IaT), Tau), DTheta), cose);
+	Sigma5D = -_IQmpy(_IQmpy(_IQmpy(_IQmpy(State->gamma5, IbT), Tau), DTheta), seno);
+	State->Sigma2Int = State->Sigma2Int+_IQ30rmpy(Sigma2D, IQ_TS);
+	State->Sigma5Int = State->Sigma5Int+_IQ30rmpy(Sigma5D, IQ_TS);
+	State->Sigma2 = _IQmpy(_IQmpy(State->Sigma2Int, Tau), DTheta);
+	State->Sigma5 = _IQmpy(_IQmpy(State->Sigma5Int, Tau), DTheta);
+	sum1 = 0;
+	sum2 = 0;
+	HARMONICS(RippleDerivativesIQ)
+	ha = -_IQmpy(_IQ30mpy(sum1+_IQ30mpy(DDDThetaD, IQ_J), IQ_LKMI), seno);
+	hb = _IQmpy(_IQ30mpy(sum2+_IQ30mpy(DDDThetaD, IQ_J), IQ_LKMI), cose);
+	if (CTRL_TEST == 1){
+		State->TestAngle = State->TestAngle+_IQ(100*CTRL_TS);
+		if (State->TestAngle >= IQ_2PI) State->TestAngle = State->TestAngle-IQ_2PI;
+		Out->Va = -_IQsin(State->TestAngle)*CTRL_VMAX;
+		Out->Vb = _IQcos(State->TestAngle)*CTRL_VMAX;
+	}
+	else{
+		Out->Va = -_IQmpy(State->alphaA, IaT)+_IQmpy(State->Sigma2, cose)+_IQmpy(IQ_R, IaD)-_IQmpy(_IQmpy(IQ_KM, DThetaD), seno)+ha;
+		Out->Vb = -_IQmpy(State->alphaB, IbT)+_IQmpy(State->Sigma5, seno)+_IQmpy(IQ_R, IbD)+_IQmpy(_IQmpy(IQ_KM, DThetaD), cose)+hb;
+	}
+	MarkSection(PROFILE_CONTROLLER);
+	foo = _IQmpy(State->gammaP, ThetaT)+DThetaT-_IQ20mpy(_IQmpy(_IQmpy(State->kd, IaT), seno), IQ_LJKMI)
+		+_IQ20mpy(_IQmpy(_IQmpy(State->kd, IbT), cose), IQ_LJKMI);
+	HARMONICS(RippleAdaptationIQ)
+	State->Tau = Tau;
+	State->IaD = IaD;
+	State->IbD = IbD;
+	MarkSection(PROFILE_ADAPTATION);
+}
+
+#endif
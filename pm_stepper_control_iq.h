@@ -0,0 +1,89 @@
+//###########################################################################
+// FILE:   pm_stepper_control_iq.h
+// TITLE:  IQmath fixed-point build of the adaptive control law
+//###########################################################################
+// StepControllerIQ() is StepController() in 32-bit fixed point (IQmath), so
+// the tick runs in the same number of cycles whatever the data and does not
+// need the FPU. Build the firmware with -DCONTROL_MATH=CONTROL_IQ to run it
+// from cpu_timer0_isr; the host builds both and pm_stepper_iq_check runs
+// them side by side.
+// Q formats, per signal:
+//   Q20 (IQ_POS) position, speed and trajectory derivatives, +/-2048 rad...
+//   Q24 (GLOBAL_Q) torque, currents, voltages, sin/cos, gains, adaptive
+//       terms, +/-128
+//   Q30 the normalized time of the trajectory and small constants (J, L*kmI)
+// Position and speed errors are clamped to +/-IQ_ERR_MAX, and speeds and
+// trajectory derivatives to +/-IQ_SPEED_MAX, before the Q24 law so that no
+// product overflows; the float law has no such limit, but only reaches it
+// once tracking is already lost.
+// The trajectory is CalcPosDesired() in normalized time s = t/tf, and the
+// differentiators are StepDiff() with the coefficients of InitDiff().
+// Inputs and outputs are in fixed point as well; the firmware converts the
+// float ADC currents and Va/Vb at the ISR boundary.
+//###########################################################################
+
+#ifndef PM_STEPPER_CONTROL_IQ_H
+#define PM_STEPPER_CONTROL_IQ_H
+
+#define GLOBAL_Q 24
+#include "IQmathLib.h"
+#include "pm_stepper_control.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IQ_POS 20					// Q of position, speed and trajectory derivatives
+#define IQ_ERR_MAX 8				// Limit of the position (rad) and speed (rad/s) errors
+#define IQ_SPEED_MAX 64				// Limit of the speeds (rad/s) and trajectory derivatives
+
+// Float to Q24 in one FPU multiply; _IQ() of a variable goes through the
+// 64-bit long double of its constant
+#define FloatToIQ(A) ((_iq)((A)*16777216.0f))
+
+// Differentiator, y = Pole*y_1+Gain*(x-x_1) (Q20), as StepDiff
+struct DIFF_IQ_STATE {
+	_iq30 Pole;
+	_iq Gain;
+	_iq20 x_1;
+	_iq20 y_1;
+};
+
+struct CONTROLLER_IQ_STATE {
+	_iq kp, kd, alphaA, alphaB;						// Controller Gains, from CONTROLLER_GAINS
+	_iq gamma2, gamma5, gammaKP, gammaKA, gammaP;
+	long Tick;										// Ticks since start, time = Tick*Ts
+	_iq20 Theta, ThetaD;							// Measured and desired position (rad)
+	_iq20 DTheta, DThetaD, DDThetaD, DDDThetaD;		// Speed estimate and trajectory derivatives
+	_iq Tau;										// Desired torque (N*m)
+	_iq IaD, IbD;									// Desired currents (A)
+	_iq Sigma2, Sigma5;								// Current loop adaptive terms
+	_iq Sigma2Int, Sigma5Int;						// Integrators of Sigma2D/Sigma5D
+	_iq gammakP[HARMONIC_COUNT], gammakA[HARMONIC_COUNT];	// Torque ripple estimators
+	_iq gammakPD[HARMONIC_COUNT], gammakAD[HARMONIC_COUNT];	// Derivated torque ripple estimators
+	_iq20 pastTrajectory;							// Previous ThetaD
+	_iq TestAngle;									// 100*time modulo 2*pi, for CTRL_TEST == 1
+	struct DIFF_IQ_STATE Speed, Acel, DAcel;
+	void (*Mark)(int Section);						// Profiler section boundary (ProfileMark), NULL if unused
+};
+
+struct CONTROLLER_IQ_INPUTS {
+	_iq20 Theta;			// Rotor position (rad), CalcPositionIQ
+	int Tooth, Pole;		// Phases of Nr*Theta and np*Theta in counts (POSITION_STATE)
+	_iq Ia, Ib;				// Phase currents, sign already corrected (A)
+};
+
+struct CONTROLLER_IQ_OUTPUTS {
+	_iq Va, Vb;				// Phase voltages (V), not yet saturated to Vmax
+};
+
+void InitControllerIQ(struct CONTROLLER_IQ_STATE *State, const struct CONTROLLER_GAINS *Gains);
+void StepControllerIQ(struct CONTROLLER_IQ_STATE *State, const struct CONTROLLER_IQ_INPUTS *In, struct CONTROLLER_IQ_OUTPUTS *Out);
+_iq20 CalcPositionIQ(const struct POSITION_STATE *Position);
+_iq20 CalcPosDesiredIQ(long Tick);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end of PM_STEPPER_CONTROL_IQ_H definition
@@ -0,0 +1,50 @@
+//###########################################################################
+// FILE:   pm_stepper_filter.c
+// TITLE:  Discrete differentiator and integrator of the control law
+//###########################################################################
+
+#include <math.h>
+#include "pm_stepper_filter.h"
+
+// Flash build: the tick's filters run from RAM (28377S_FLASH_lnk.cmd)
+#ifdef _FLASH
+#pragma CODE_SECTION(StepDiff, "ramfuncs")
+#pragma CODE_SECTION(StepIntegrator, "ramfuncs")
+#endif
+
+// Cutoff in rad/s, Period in s; the memory starts at rest
+void InitDiff(struct DIFF_STATE *Diff, float Cutoff, float Period){
+	Diff->Pole = (float)exp(-(double)Cutoff*Period);
+	Diff->Gain = (1-Diff->Pole)/Period;
+	Diff->x_1 = 0;
+	Diff->y_1 = 0;
+}
+
+float StepDiff(struct DIFF_STATE *Diff, float x){
+	float y = Diff->Pole*Diff->y_1+Diff->Gain*(x-Diff->x_1);
+	Diff->x_1 = x;
+	Diff->y_1 = y;
+	return y;
+}
+
+// y may be x
+void StepDiffBatch(struct DIFF_STATE *Diff, const float *x, float *y, int Count){
+	int k;
+	for (k=0; k<Count; k++) y[k] = StepDiff(Diff, x[k]);
+}
+
+void InitIntegrator(struct INTEGRATOR_STATE *Int, float Period){
+	Int->Gain = Period;
+	Int->y = 0;
+}
+
+float StepIntegrator(struct INTEGRATOR_STATE *Int, float x){
+	Int->y = Int->y+x*Int->Gain;
+	return Int->y;
+}
+
+// y may be x
+void StepIntegratorBatch(struct INTEGRATOR_STATE *Int, const float *x, float *y, int Count){
+	int k;
+	for (k=0; k<Count; k++) y[k] = StepIntegrator(Int, x[k]);
+}
@@ -0,0 +1,56 @@
+//###########################################################################
+// FILE:   pm_stepper_filter.h
+// TITLE:  Discrete differentiator and integrator of the control law
+//###########################################################################
+// The speed estimate and the trajectory derivatives come from the same
+// filtered differentiator, and the adaptive terms from the same integrator.
+// Each object keeps its coefficients with its memory, computed once by
+// InitDiff/InitIntegrator from the sample period and the cutoff, so the
+// law follows a change of Ts.
+// StepDiff is the derivative of x through a first order low-pass, with the
+// pole matched, exp(-Cutoff*Period), and unit gain on a ramp:
+//     y = Pole*y_1+Gain*(x-x_1), Gain = (1-Pole)/Period
+// At Ts = 1 ms and a 10 rad/s cutoff this replaces the former second
+// order 10*(1-1/z)^2/((1-1/z)*(1-0.99/z)), whose common (1-1/z) was a pole
+// on the unit circle that float rounding turned into drift. It is not the
+// same filter: the matched pole is 0.99005 instead of 0.99 and the gain
+// 9.95 instead of 10, so the response changes slightly, and captures made
+// with the former filter do not replay bit-exact.
+// StepIntegrator is forward Euler, y = y_1+Gain*x with Gain = Period.
+// The *Batch forms run a whole sample sequence, for host simulation.
+// The CLA and IQmath builds take the coefficients of InitDiff and run the
+// same recurrences inline.
+//###########################################################################
+
+#ifndef PM_STEPPER_FILTER_H
+#define PM_STEPPER_FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct DIFF_STATE {
+	float Pole, Gain;		// Coefficients (InitDiff)
+	float x_1;				// Past input
+	float y_1;				// Past output
+};
+
+struct INTEGRATOR_STATE {
+	float Gain;				// Sample period (InitIntegrator)
+	float y;				// Integral
+};
+
+#ifndef __TMS320C28XX_CLA__
+void InitDiff(struct DIFF_STATE *Diff, float Cutoff, float Period);
+float StepDiff(struct DIFF_STATE *Diff, float x);
+void StepDiffBatch(struct DIFF_STATE *Diff, const float *x, float *y, int Count);
+void InitIntegrator(struct INTEGRATOR_STATE *Int, float Period);
+float StepIntegrator(struct INTEGRATOR_STATE *Int, float x);
+void StepIntegratorBatch(struct INTEGRATOR_STATE *Int, const float *x, float *y, int Count);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end of PM_STEPPER_FILTER_H definition
@@ -0,0 +1,60 @@
+//###########################################################################
+// FILE:   pm_stepper_isr.h
+// TITLE:  Per-tick state of the control interrupts
+//###########################################################################
+// Everything the control ISRs keep from one tick to the next is in the
+// global Isr, one block in the IsrState section aligned to a 64-word data
+// page. The C28x reaches a global through the data page pointer, and every
+// access to a variable on another page reloads DP. Here the scalars the
+// ISRs use directly share the first page with Position. StepController and
+// StepControllerIQ reach Controller through a pointer (XAR), which needs no
+// DP reload.
+// Both linker command files place IsrState in GS RAM on a 64-word
+// boundary (28377S_RAM_lnk.cmd, 28377S_FLASH_lnk.cmd).
+//###########################################################################
+
+#ifndef PM_STEPPER_ISR_H
+#define PM_STEPPER_ISR_H
+
+#include "pm_stepper_control.h"
+#include "pm_stepper_control_iq.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ADC_DMA: DMA CH1 and CH2 move the phase currents into AdcDma and the CPU
+// takes no ADC interrupt (ConfigureDMA). The CLA and CONTROL_SPLIT builds
+// run Task1 and the current loop on ADCAINT1 instead
+#ifndef ADC_DMA
+#define ADC_DMA (CONTROL_MATH == CONTROL_FLOAT || CONTROL_MATH == CONTROL_IQ)
+#endif
+#if ADC_DMA && (CONTROL_MATH == CONTROL_CLA || CONTROL_MATH == CONTROL_SPLIT)
+#error "ADC_DMA needs CONTROL_FLOAT or CONTROL_IQ"
+#endif
+
+struct ISR_STATE {
+	float Va, Vb;								// Phase voltages of the last tick (V), sign the next currents
+	float Ia, Ib;								// Phase currents of the tick (A), from AdcDma or Currents
+	float Theta;								// Measured position (rad)
+#if !ADC_DMA
+	struct CURRENT_SNAPSHOT Currents;			// Last conversion, published by adca1_isr
+#endif
+	int index, load;							// SVArray sample and decimation counters (LogSample)
+	struct POSITION_STATE Position;				// Encoder position (UpdatePosition)
+#if CONTROL_MATH == CONTROL_SPLIT
+	struct SETPOINT_MAILBOX Setpoint;			// Position loop to current loop (adca1_isr)
+#endif
+	struct CONTROLLER_STATE Controller;			// Float law, and the trajectory of the CLA build
+#if CONTROL_MATH == CONTROL_IQ
+	struct CONTROLLER_IQ_STATE ControllerIQ;	// Fixed-point law
+#endif
+};
+
+extern struct ISR_STATE Isr;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end of PM_STEPPER_ISR_H definition
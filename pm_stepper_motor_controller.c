@@ -10,6 +10,12 @@
 
 #include "F28x_Project.h"     // Device Headerfile and Examples Include File
 #include <math.h>
+#include "pm_stepper_control.h"
+#include "pm_stepper_control_iq.h"
+#include "pm_stepper_trig.h"
+#include "pm_stepper_cla.h"
+#include "pm_stepper_profile.h"
+#include "pm_stepper_isr.h"
 
 void SelectGPIO(void);
 void ConfigureADC(void);
@@ -18,60 +24,50 @@ void ConfigureEPWM7(void);
 void ConfigureEPWM9(void);
 void ConfigureEQEP1(void);
 void SetupADCEpwm(Uint16 channel);
+void ConfigureDMA(void);
 void SetPWMA(float);
 void SetPWMB(float);
-float CalcSpeed(float);
-float CalcPosition(void);
-float CalcPosDesired(float);
-float CalcSpeedDesired(float);
-float CalcAcelDesired(float);
-float CalcDAcelDesired(float);
-float CalcIntSigma2(float);
-float CalcIntSigma5(float);
+void LogSample(void);
+float AdcCurrent(const volatile Uint16 *Codes);
+void ReadAdcDma(void);
 __interrupt void adca1_isr(void);
-__interrupt void adcb1_isr(void);
 __interrupt void cpu_timer0_isr(void);
-//////////////////////////////////////////////////						//////////////////////////////////////////////////
-//////////////////////////////////////////////////   Controller Gains	//////////////////////////////////////////////////
-//////////////////////////////////////////////////						//////////////////////////////////////////////////
-#define TEST 0
-#define Kp 0.5	 //1
-#define Kd 0.01  //0.01
-#define AlphaA 9 //9
-#define AlphaB 9 //9
-#define Gamma2 1 //1
-#define Gamma5 1 //1
-#define GammakP 0.5 //0.5
-#define GammakA 0.5 //0.5
-#define gamma 9		//9
-#define N 3
-//////////////////////////////////////////////////						//////////////////////////////////////////////////
-//////////////////////////////////////////////////   System Constants	//////////////////////////////////////////////////
-//////////////////////////////////////////////////						//////////////////////////////////////////////////
-#define R 5.0					// Phase Winding Resistance (Ohm)
-#define L 0.006					// Phase Winding Inductance (H)
-#define km 0.1  				// Motor Torque Constant (N*m/A) 0.15
-#define J 0.0001872				// Rotor Inertia (kg*m^2)
-#define b 0.002					// Rotor Damping (N*m/(rad/s))
-#define Nr 50					// Number of teeth
-#define np 8					// Number of poles
-#define Ts 0.001
-#define iTs 1/Ts
-#define Vmax 12
-#define tf 10
-#define JkmI 1/(J*km)
-#define kmI 1/km
-#define VmaxI 1/(Vmax) //+0.5
+__interrupt void cla1_task1_isr(void);
+#ifdef _FLASH
+// Flash build: the per-tick code is copied to RAM by InitSysCtrl (28377S_FLASH_lnk.cmd)
+#pragma CODE_SECTION(SetPWMA, "ramfuncs")
+#pragma CODE_SECTION(SetPWMB, "ramfuncs")
+#pragma CODE_SECTION(LogSample, "ramfuncs")
+#pragma CODE_SECTION(AdcCurrent, "ramfuncs")
+#if ADC_DMA
+#pragma CODE_SECTION(ReadAdcDma, "ramfuncs")
+#else
+#pragma CODE_SECTION(adca1_isr, "ramfuncs")
+#endif
+#pragma CODE_SECTION(cpu_timer0_isr, "ramfuncs")
+#if CONTROL_MATH == CONTROL_CLA
+#pragma CODE_SECTION(cla1_task1_isr, "ramfuncs")
+#endif
+#endif
 //////////////////////////////////////////////////						//////////////////////////////////////////////////
 //////////////////////////////////////////////////     uC Constants	    //////////////////////////////////////////////////
 //////////////////////////////////////////////////						//////////////////////////////////////////////////
-#define EPWM7_TIMER_TBPRD  5000	// Period Register 10kHz
+#define EPWM7_TIMER_TBPRD  5000	// Period Register 10kHz, CURRENT_LOOP_RATIO periods per Ts
 #define EPWM7_CMPA     5000	    // 0 = 100% Duty Cycle; TBPRD = 0% Duty Cycle
 #define EPWM7_DB   0x007F		// PWM Dead Band
 #define EPWM9_TIMER_TBPRD  5000 // Period Register 10kHz
 #define EPWM9_CMPA     5000		// 0 = 100% Duty Cycle; TBPRD = 0% Duty Cycle
 #define EPWM9_DB   0x007F		// PWM Dead Band
+#ifndef ADC_ACQPS
+#define ADC_ACQPS 0				// S/H window of every SOC, SYSCLK cycles less one; at least the minimum of the resolution (-DADC_ACQPS=<n>)
+#endif
+#if ADC_ACQPS < 0 || ADC_ACQPS > 511
+#error "ADC_ACQPS must fit the 9-bit ACQPS field of ADCSOCxCTL"
+#endif
 #define RESULTS_BUFFER_SIZE 5000
+#ifndef RESULTS_DECIMATION
+#define RESULTS_DECIMATION 1	// Control ticks per logged sample; pm_stepper_replay needs 1
+#endif
 //////////////////////////////////////////////////						//////////////////////////////////////////////////
 //////////////////////////////////////////////////  System Variables    //////////////////////////////////////////////////
 //////////////////////////////////////////////////						//////////////////////////////////////////////////
@@ -83,12 +79,26 @@ __interrupt void cpu_timer0_isr(void);
 #pragma DATA_SECTION(VbArray, "SVArray")
 float ThetaArray[RESULTS_BUFFER_SIZE], DThetaArray[RESULTS_BUFFER_SIZE], IaArray[RESULTS_BUFFER_SIZE];
 float IbArray[RESULTS_BUFFER_SIZE], VaArray[RESULTS_BUFFER_SIZE], VbArray[RESULTS_BUFFER_SIZE];
-float time=0;
-float Va=0, Vb=0, Ia=0, Ib=0, IaD=0, IbD=0;
-float Theta=0, ThetaD=0, DTheta=0, DThetaD=0, DDThetaD=0, DDDThetaD=0, Tau=0;
-float Sigma2=0, Sigma5=0;
-static float gammakP[N]={0,0,0}, gammakA[N]={0,0,0};
-int index=0, load=0;
+#pragma DATA_SECTION(Isr, "IsrState")
+#pragma DATA_ALIGN(Isr, 64)
+struct ISR_STATE Isr;
+#if ADC_DMA
+// The ADC_OVERSAMPLING results of ADCA (AdcDma[0]) and ADCB (AdcDma[1]),
+// written by DMA CH1 and CH2 in the two halves in turn; the DMA reaches GS
+// RAM but not LS RAM
+#pragma DATA_SECTION(AdcDma, "AdcDma")
+Uint16 AdcDma[2][2][ADC_OVERSAMPLING];
+#endif
+#if CONTROL_MATH == CONTROL_IQ
+#define ControllerTime() (Isr.ControllerIQ.Tick*CTRL_TS)
+#define ControllerDTheta() _IQ20toF(Isr.ControllerIQ.DTheta)
+#elif CONTROL_MATH == CONTROL_CLA
+#define ControllerTime() Isr.Controller.time
+#define ControllerDTheta() ClaState.DTheta
+#else
+#define ControllerTime() Isr.Controller.time
+#define ControllerDTheta() Isr.Controller.DTheta
+#endif
 
 void main(void){
 	// Initialize System Control: PLL, WatchDog, enable Peripheral Clocks.
@@ -114,12 +124,18 @@ void main(void){
     InitPieVectTable();
     // Map ISR functions
     EALLOW;
+#if !ADC_DMA
     PieVectTable.ADCA1_INT = &adca1_isr; // Function for ADCA interrupt 1
-    PieVectTable.ADCB1_INT = &adcb1_isr; // Function for ADCB interrupt 1
+#endif
     PieVectTable.TIMER0_INT = &cpu_timer0_isr; // Function for Timer0 Interrupt
+#if CONTROL_MATH == CONTROL_CLA
+    PieVectTable.CLA1_1_INT = &cla1_task1_isr; // End of CLA1 Task1
+#endif
+    // Time bases stopped until all of them are configured
+    CpuSysRegs.PCLKCR0.bit.TBCLKSYNC = 0;
     EDIS;
     InitCpuTimers(); // Basic setup CPU Timer0, 1 and 2
-    ConfigCpuTimer(&CpuTimer0, 200, iTs); // CPU - Timer0 at 1 milisecond
+    ConfigCpuTimer(&CpuTimer0, 200, CTRL_ITS); // CPU - Timer0 at 1 milisecond
     StopCpuTimer0();
     ConfigureADC();
     ConfigureEPWM();
@@ -127,32 +143,59 @@ void main(void){
     ConfigureEPWM9();
     ConfigureEQEP1();
     SetupADCEpwm(0);// Setup the ADC for ePWM triggered conversions on channel 0
+#if ADC_DMA
+    ConfigureDMA();
+#endif
     // Enable global Interrupts and higher priority real-time debug events:
     IER |= M_INT1; // Enable group 1 interrupts
+#if CONTROL_MATH == CONTROL_CLA
+    IER |= M_INT11; // Enable group 11 interrupts (CLA1)
+#endif
     EINT;  // Enable Global interrupt INTM
     //ERTM;  // Enable Global realtime interrupt DBGM
     //Initialize results buffer
-	for(index = 0; index < RESULTS_BUFFER_SIZE; index++)
+	for(Isr.index = 0; Isr.index < RESULTS_BUFFER_SIZE; Isr.index++)
 	{
-		ThetaArray[index] = 0;
-		DThetaArray[index] = 0;
-		IaArray[index] = 0;
-		IbArray[index] = 0;
-		VaArray[index] = 0;
-		VbArray[index] = 0;
+		ThetaArray[Isr.index] = 0;
+		DThetaArray[Isr.index] = 0;
+		IaArray[Isr.index] = 0;
+		IbArray[Isr.index] = 0;
+		VaArray[Isr.index] = 0;
+		VbArray[Isr.index] = 0;
 	}
-	index = 0;
+	Isr.index = 0;
+	InitTrigTable();
+	InitController(&Isr.Controller);
+	InitPosition(&Isr.Position, -(long)EQep1Regs.QPOSCNT);
+#if CONTROL_MATH == CONTROL_IQ
+	InitControllerIQ(&Isr.ControllerIQ, &Isr.Controller.Gains);
+#elif CONTROL_MATH == CONTROL_SPLIT
+	InitSetpointMailbox(&Isr.Setpoint);
+#elif CONTROL_MATH == CONTROL_CLA
+	InitCla(&Isr.Controller.Gains, &Isr.Position);
+	PublishTrajectory(&Isr.Controller);
+#endif
+#if PROFILE_ENABLE
+	InitProfile();
+	Isr.Controller.Mark = ProfileMark;
+#if CONTROL_MATH == CONTROL_IQ
+	Isr.ControllerIQ.Mark = ProfileMark;
+#endif
+#endif
 	// Enable PIE interrupt
-	PieCtrlRegs.PIEIER1.bit.INTx1 = 1; // ADC A Interrupt
-	PieCtrlRegs.PIEIER1.bit.INTx2 = 1; // ADC B Interrupt
-	PieCtrlRegs.PIEIER1.bit.INTx7 = 1; // Timer 0 Interrupt
-	// Sync ePWM
+#if CONTROL_MATH == CONTROL_CLA
+	PieCtrlRegs.PIEIER11.bit.INTx1 = 1; // CLA1 Task1 end; the ADCs trigger the CLA and Timer0 only keeps time
+#elif CONTROL_MATH == CONTROL_SPLIT
+	PieCtrlRegs.PIEIER1.bit.INTx1 = 1; // ADC A and B Interrupt: current loop at every ePWM7 period
+	PieCtrlRegs.PIEIER1.bit.INTx7 = 1; // Timer 0 Interrupt: position loop
+#else
+	PieCtrlRegs.PIEIER1.bit.INTx7 = 1; // Timer 0 Interrupt; the DMA takes the ADC results
+#endif
+	// Sync ePWM: ePWM1 (CLA build), ePWM7 and ePWM9 count from 0 on the same
+	// TBCLK edge, and Timer0 (SYSCLK, 10 ePWM7 periods) keeps a fixed phase to them
     EALLOW;
     CpuSysRegs.PCLKCR0.bit.TBCLKSYNC = 1;
     StartCpuTimer0(); // CpuTimer0Regs.TCR.bit.TSS = 0; // Start timer0
-    // Start ePWM
-    EPwm1Regs.ETSEL.bit.SOCAEN = 1;  // Enable SOCA
-	EPwm1Regs.TBCTL.bit.CTRMODE = 0; // Unfreeze, and enter up count mode
 	EDIS;
     do{
     	asm(" NOP");
@@ -167,11 +210,19 @@ void SelectGPIO(void){
 	GPIO_SetupPinOptions(13, GPIO_OUTPUT, GPIO_ASYNC);
 	GPIO_SetupPinMux(12, GPIO_MUX_CPU1, 1); //PWM7A
 	GPIO_SetupPinOptions(12, GPIO_OUTPUT, GPIO_ASYNC);
+#if CONTROL_MATH == CONTROL_CLA
+	GPIO_SetupPinMux(15, GPIO_MUX_CPU1CLA, 0); //GPIO15-DirectionA, written by CLA1 Task1
+#else
 	GPIO_SetupPinMux(15, GPIO_MUX_CPU1, 0); //GPIO15-DirectionA
+#endif
 	GPIO_SetupPinOptions(15, GPIO_OUTPUT, GPIO_ASYNC);
 	GPIO_SetupPinMux(16, GPIO_MUX_CPU1, 5); //PWM9A
 	GPIO_SetupPinOptions(16, GPIO_OUTPUT, GPIO_ASYNC);
+#if CONTROL_MATH == CONTROL_CLA
+	GPIO_SetupPinMux(17, GPIO_MUX_CPU1CLA, 0); //GPIO17-DirectionB, written by CLA1 Task1
+#else
 	GPIO_SetupPinMux(17, GPIO_MUX_CPU1, 0); //GPIO17-DirectionB
+#endif
 	GPIO_SetupPinOptions(17, GPIO_OUTPUT, GPIO_ASYNC);
 	//GpioDataRegs.GPATOGGLE.bit.GPIO13 = 1;
 	GpioDataRegs.GPACLEAR.bit.GPIO13 = 1;
@@ -195,15 +246,24 @@ void ConfigureADC(){
 	EDIS;
 }
 
+// ePWM1 only times the CLA build, one Task1 per Ts; the other builds
+// sample the currents on ePWM7/ePWM9 (ConfigureEPWM7/ConfigureEPWM9)
 void ConfigureEPWM(){
 	EALLOW;
 	// Assumes ePWM clock is already enabled
 	EPwm1Regs.ETSEL.bit.SOCAEN	= 0;	        // Disable SOC on A group
-	EPwm1Regs.ETSEL.bit.SOCASEL	= 4;	        // Select SOC on up-count
-	EPwm1Regs.ETPS.bit.SOCAPRD = 1;		        // Generate pulse on 1st event
-	EPwm1Regs.CMPA.bit.CMPA = 0x6096;           // Set compare A value to 2048 counts 0x0800
-	EPwm1Regs.TBPRD = 0xC12C;			        // Set period to 4096 counts 0x1000
-	EPwm1Regs.TBCTL.bit.CTRMODE = 3;            // freeze counter
+#if CONTROL_MATH == CONTROL_CLA
+	EPwm1Regs.ETSEL.bit.SOCASEL	= ET_CTR_ZERO;  // SOC at CTR=0, which every 10th time is CTR=0 of ePWM7/ePWM9
+	EPwm1Regs.ETPS.bit.SOCAPRD = ET_1ST;        // Generate pulse on 1st event
+	EPwm1Regs.TBPRD = CLA_EPWM1_TBPRD;	        // SOCA every Ts: each conversion runs one CLA tick
+	EPwm1Regs.TBCTR = 0x0000;                   // Clear counter
+	EPwm1Regs.TBCTL.bit.HSPCLKDIV = TB_DIV2;    // TBCLK = EPWMCLK/2 = 50 MHz, as out of reset
+	EPwm1Regs.TBCTL.bit.CLKDIV = TB_DIV1;
+	EPwm1Regs.TBCTL.bit.CTRMODE = TB_COUNT_UP;  // Counts from TBCLKSYNC
+	EPwm1Regs.ETSEL.bit.SOCAEN = 1;             // Enable SOCA
+#else
+	EPwm1Regs.TBCTL.bit.CTRMODE = TB_FREEZE;    // freeze counter
+#endif
 	EDIS;
 }
 
@@ -225,6 +285,14 @@ void ConfigureEPWM7(){
 	EPwm7Regs.DBCTL.bit.IN_MODE = DBA_ALL;
 	EPwm7Regs.DBRED.bit.DBRED = EPWM7_DB;
 	EPwm7Regs.DBFED.bit.DBFED = EPWM7_DB;
+#if CONTROL_MATH != CONTROL_CLA
+	// ADCA and ADCB SOCs at CTR=PRD, the middle of the on time of both
+	// phases: the mean of the current ripple. CMPA loads at CTR=0, half a
+	// period later
+	EPwm7Regs.ETSEL.bit.SOCASEL = ET_CTR_PRD;
+	EPwm7Regs.ETPS.bit.SOCAPRD = ET_1ST;
+	EPwm7Regs.ETSEL.bit.SOCAEN = 1;
+#endif
 	EDIS;
 }
 
@@ -265,8 +333,13 @@ void ConfigureEQEP1(){
     EDIS;
 }
 
+// SOC0..SOC(ADC_OVERSAMPLING-1) of each ADC convert the same pin on the same
+// trigger; the round-robin takes them in order, and INT1 comes at the end
+// of the last one, when all the results of the pair are in
 void SetupADCEpwm(Uint16 channel){
-	Uint16 acqps;
+	volatile union ADCSOCxCTL_REG *SocA = &AdcaRegs.ADCSOC0CTL, *SocB = &AdcbRegs.ADCSOC0CTL;
+	Uint16 acqps, trigsel;
+	int k;
 	//determine minimum acquisition window (in SYSCLKS) based on resolution
 	if(ADC_RESOLUTION_12BIT == AdcaRegs.ADCCTL2.bit.RESOLUTION){
 		acqps = 14; //75ns
@@ -274,29 +347,91 @@ void SetupADCEpwm(Uint16 channel){
 	else { //resolution is 16-bit
 		acqps = 63; //320ns
 	}
+#if ADC_ACQPS
+	if (ADC_ACQPS > acqps) acqps = ADC_ACQPS;
+#endif
+#if CONTROL_MATH == CONTROL_CLA
+	trigsel = 5; //trigger on ePWM1 SOCA/C. 01h ADCTRIG1 - CPU1 Timer 0, TINT0n
+#else
+	trigsel = 17; //trigger on ePWM7 SOCA/C: both phases sampled at once
+#endif
 	//Select the channels to convert and end of conversion flag
 	EALLOW;
-	AdcaRegs.ADCSOC0CTL.bit.CHSEL = channel;  //SOC0 will convert pin A0
-	AdcaRegs.ADCSOC0CTL.bit.ACQPS = acqps; //sample window is 100 SYSCLK cycles
-	AdcbRegs.ADCSOC0CTL.bit.CHSEL = channel;  //SOC0 will convert pin B0
-	AdcbRegs.ADCSOC0CTL.bit.ACQPS = acqps; //sample window is acqps + 1 SYSCLK cycles
-	AdcaRegs.ADCSOC0CTL.bit.TRIGSEL = 5; //trigger on ePWM1 SOCA/C. 01h ADCTRIG1 - CPU1 Timer 0, TINT0n
-	AdcbRegs.ADCSOC0CTL.bit.TRIGSEL = 5; //trigger on ePWM1 SOCA/C
-	AdcaRegs.ADCINTSEL1N2.bit.INT1SEL = 0; //end of SOC0 will set INT1 flag
+	for (k=0; k<ADC_OVERSAMPLING; k++){
+		SocA[k].bit.CHSEL = channel;  //SOCk will convert pin A0
+		SocA[k].bit.ACQPS = acqps; //sample window is acqps + 1 SYSCLK cycles
+		SocA[k].bit.TRIGSEL = trigsel;
+		SocB[k].bit.CHSEL = channel;  //SOCk will convert pin B0
+		SocB[k].bit.ACQPS = acqps;
+		SocB[k].bit.TRIGSEL = trigsel;
+	}
+	AdcaRegs.ADCINTSEL1N2.bit.INT1SEL = ADC_OVERSAMPLING-1; //end of the last SOC will set INT1 flag
 	AdcaRegs.ADCINTSEL1N2.bit.INT1E = 1;   //enable INT1 flag
+#if CONTROL_MATH == CONTROL_CLA || ADC_DMA
+	AdcaRegs.ADCINTSEL1N2.bit.INT1CONT = 1; //INT1 pulses every EOC: no ISR clears the flag for the CLA or DMA trigger
+#endif
 	AdcaRegs.ADCINTFLGCLR.bit.ADCINT1 = 1; //make sure INT1 flag is cleared
-	AdcbRegs.ADCINTSEL1N2.bit.INT1SEL = 0; //end of SOC0 will set INT1 flag
-	AdcbRegs.ADCINTSEL1N2.bit.INT1E = 1;   //enable INT1 flag
+	AdcbRegs.ADCINTSEL1N2.bit.INT1SEL = ADC_OVERSAMPLING-1; //end of the last SOC will set INT1 flag
+#if ADC_DMA
+	AdcbRegs.ADCINTSEL1N2.bit.INT1E = 1;   //INT1 triggers DMA CH2
+	AdcbRegs.ADCINTSEL1N2.bit.INT1CONT = 1;
+#else
+	AdcbRegs.ADCINTSEL1N2.bit.INT1E = 0;   //no INT1: adca1_isr (or CLA1 Task1) reads ADC B
+#endif
 	AdcbRegs.ADCINTFLGCLR.bit.ADCINT1 = 1; //make sure INT1 flag is cleared
 	EDIS;
 }
 
+#if ADC_DMA
+// DMA CH1 (ADCAINT1) and CH2 (ADCBINT1) copy the results of their ADC into
+// AdcDma at every trigger: one burst of ADC_OVERSAMPLING words per half,
+// two bursts per transfer, and the transfer restarts on its own
+// (continuous). No channel interrupt: cpu_timer0_isr reads the half the DMA
+// wrote last
+static void ConfigureDmaChannel(volatile struct CH_REGS *Ch, Uint16 Channel, volatile Uint16 *Result, Uint16 *Buffer){
+	Ch->SRC_BEG_ADDR_SHADOW = (Uint32)Result;
+	Ch->SRC_ADDR_SHADOW = (Uint32)Result;
+	Ch->DST_BEG_ADDR_SHADOW = (Uint32)Buffer;
+	Ch->DST_ADDR_SHADOW = (Uint32)Buffer;
+	Ch->BURST_SIZE = ADC_OVERSAMPLING-1;	// ADC_OVERSAMPLING words per burst
+	Ch->SRC_BURST_STEP = 1;
+	Ch->DST_BURST_STEP = 1;
+	Ch->TRANSFER_SIZE = 1;				// 2 bursts per transfer
+	Ch->SRC_TRANSFER_STEP = -(ADC_OVERSAMPLING-1);	// Back to ADCRESULT0
+	Ch->DST_TRANSFER_STEP = 1;			// Next half
+	Ch->SRC_WRAP_SIZE = 0xFFFF;			// No wrap within a transfer
+	Ch->SRC_WRAP_STEP = 0;
+	Ch->DST_WRAP_SIZE = 0xFFFF;
+	Ch->DST_WRAP_STEP = 0;
+	Ch->MODE.bit.PERINTSEL = Channel;	// DMACHSRCSEL picks the trigger
+	Ch->MODE.bit.PERINTE = 1;
+	Ch->MODE.bit.ONESHOT = 0;
+	Ch->MODE.bit.CONTINUOUS = 1;
+	Ch->MODE.bit.DATASIZE = 0;			// 16-bit
+	Ch->MODE.bit.OVRINTE = 0;
+	Ch->MODE.bit.CHINTE = 0;
+	Ch->CONTROL.bit.PERINTCLR = 1;
+	Ch->CONTROL.bit.ERRCLR = 1;
+	Ch->CONTROL.bit.RUN = 1;
+}
+
+void ConfigureDMA(){
+	EALLOW;
+	DmaRegs.DEBUGCTRL.bit.FREE = 1;		// Keep moving results at a breakpoint
+	DmaClaSrcSelRegs.DMACHSRCSEL1.bit.CH1 = DMA_ADCAINT1;
+	DmaClaSrcSelRegs.DMACHSRCSEL1.bit.CH2 = DMA_ADCBINT1;
+	ConfigureDmaChannel(&DmaRegs.CH1, 1, &AdcaResultRegs.ADCRESULT0, AdcDma[0][0]);
+	ConfigureDmaChannel(&DmaRegs.CH2, 2, &AdcbResultRegs.ADCRESULT0, AdcDma[1][0]);
+	EDIS;
+}
+#endif
+
 void SetPWMA(float V){
 	if (V>=0){GpioDataRegs.GPASET.bit.GPIO15 = 1;}
 	else{GpioDataRegs.GPACLEAR.bit.GPIO15 = 1;}
 	V = abs(V);
-	if (V>Vmax) {V=Vmax;}
-	V = V*EPwm7Regs.TBPRD*VmaxI;
+	if (V>CTRL_VMAX) {V=CTRL_VMAX;}
+	V = V*EPwm7Regs.TBPRD*CTRL_VMAXI;
 	EPwm7Regs.CMPA.bit.CMPA = EPwm7Regs.TBPRD-V;
 }
 
@@ -304,98 +439,134 @@ void SetPWMB(float V){
 	if (V>=0){GpioDataRegs.GPASET.bit.GPIO17 = 1;}
 	else{GpioDataRegs.GPACLEAR.bit.GPIO17 = 1;}
 	V = abs(V);
-	if (V>Vmax) {V=Vmax;}
-	V = V*EPwm9Regs.TBPRD*VmaxI;
+	if (V>CTRL_VMAX) {V=CTRL_VMAX;}
+	V = V*EPwm9Regs.TBPRD*CTRL_VMAXI;
 	EPwm9Regs.CMPA.bit.CMPA = EPwm9Regs.TBPRD-V;
 }
 
-__interrupt void adca1_isr(void){
-	Ia = AdcaResultRegs.ADCRESULT0*0.000791452315L; //0.002137 R=1k
-	AdcaRegs.ADCINTFLGCLR.bit.ADCINT1 = 1; //clear INT1 flag
-	PieCtrlRegs.PIEACK.all = PIEACK_GROUP1;
+// Magnitude of a phase current from the ADC_OVERSAMPLING codes of one
+// trigger: one pass to sum them, one multiply to scale the mean
+float AdcCurrent(const volatile Uint16 *Codes){
+	Uint32 Sum = 0;
+	int k;
+	for (k=0; k<ADC_OVERSAMPLING; k++) Sum += Codes[k];
+	return Sum*CTRL_AMPS_PER_SUM;
 }
 
-__interrupt void adcb1_isr(void){
-	Ib = AdcbResultRegs.ADCRESULT0*0.000791452315L;
-	AdcbRegs.ADCINTFLGCLR.bit.ADCINT1 = 1; //clear INT1 flag
+#if ADC_DMA
+// Phase currents of the tick from the last conversion in AdcDma. A transfer
+// of DMA CH2 starts with the burst into half 0 and ends with the one into
+// half 1, so TRANSFERSTS tells which half it wrote last. CH1 has the same
+// trigger instant and the round-robin serves it first, so its half is
+// complete too. The bursts come half an ePWM7 period before the tick, so
+// the tick never meets one. The currents take the sign of the voltages
+// applied since the last tick
+void ReadAdcDma(void){
+	int Half = DmaRegs.CH2.CONTROL.bit.TRANSFERSTS ? 0 : 1;
+	Isr.Ia = AdcCurrent(AdcDma[0][Half]);
+	Isr.Ib = AdcCurrent(AdcDma[1][Half]);
+	if (Isr.Va<0) Isr.Ia = -Isr.Ia;
+	if (Isr.Vb<0) Isr.Ib = -Isr.Ib;
+}
+#else
+// Both phase currents at every ePWM7 period. ADCA and ADCB convert on the
+// same trigger with the same window, so ADCB is done at ADCA's end of
+// conversion. The currents take the sign of the voltages applied last and
+// go to cpu_timer0_isr as one pair (Currents); the CONTROL_SPLIT build also
+// runs its current loop here, on the last setpoint of cpu_timer0_isr
+__interrupt void adca1_isr(void){
+	float Ia, Ib;
+#if CONTROL_MATH == CONTROL_SPLIT
+	struct CONTROLLER_OUTPUTS Out;
+#endif
+	Ia = AdcCurrent(&AdcaResultRegs.ADCRESULT0); //0.002137 R=1k
+	Ib = AdcCurrent(&AdcbResultRegs.ADCRESULT0);
+	if (Isr.Va<0) Ia = -Ia;
+	if (Isr.Vb<0) Ib = -Ib;
+	PublishCurrents(&Isr.Currents, Ia, Ib);
+#if CONTROL_MATH == CONTROL_SPLIT
+	StepCurrentLoop(&Isr.Setpoint.Buffer[Isr.Setpoint.Index], Ia, Ib, &Out);
+	Isr.Va = Out.Va;
+	Isr.Vb = Out.Vb;
+	SetPWMA(Isr.Va);
+	SetPWMB(Isr.Vb);
+#endif
+	AdcaRegs.ADCINTFLGCLR.bit.ADCINT1 = 1; //clear INT1 flag
 	PieCtrlRegs.PIEACK.all = PIEACK_GROUP1;
 }
+#endif
 
 __interrupt void cpu_timer0_isr(void){
-	static float Sigma2D=0, Sigma5D=0;						// Integral terms of current loops
-	static float ha=0, hb=0;								//
-	static float gammakPD[N]={0,0,0}, gammakAD[N]={0,0,0}; 	// Derivated torque ripple estimators
-	static float seno=0, cose=0, S[N]={0,0,0}, C[N]={0,0,0};// Sine and cosine
-	static float IaT=0, IbT=0; 								// Currents errors
-	static float ThetaT=0, DThetaT=0;						// Position and speed errors
-	float foo=0, sum=0, sum1=0, sum2=0, aux1=0, aux2=0, aux3=0;
-	int i=0;
+#if CONTROL_MATH == CONTROL_IQ
+	struct CONTROLLER_IQ_INPUTS In;
+	struct CONTROLLER_IQ_OUTPUTS Out;
+#elif CONTROL_MATH == CONTROL_SPLIT
+	struct CONTROLLER_INPUTS In;
+	struct CURRENT_SETPOINT Setpoint;
+	Uint16 SavedPIEIER1;
+#else
+	struct CONTROLLER_INPUTS In;
+	struct CONTROLLER_OUTPUTS Out;
+#endif
 	//////////////////////////////////////////////////						//////////////////////////////////////////////////
 	//////////////////////////////////////////////////		Variables		//////////////////////////////////////////////////
 	//////////////////////////////////////////////////						//////////////////////////////////////////////////
-	if (Va<0) Ia = -Ia;
-	if (Vb<0) Ib = -Ib;
-	time += Ts;
-	Theta = CalcPosition();
-	ThetaD = CalcPosDesired(time);
-	DTheta = CalcSpeed(Theta);
-	DThetaD = CalcSpeedDesired(ThetaD);
-	DDThetaD = CalcAcelDesired(DThetaD);
-	DDDThetaD = CalcDAcelDesired(DDThetaD);
-	seno = sin(Nr*Theta);
-	cose = cos(Nr*Theta);
-	for (i=0; i<N; i++){
-		S[i] = sin((i+1)*np*Theta);
-		C[i] = cos((i+1)*np*Theta);
-	}
+	PROFILE_START();
+#if CONTROL_MATH == CONTROL_SPLIT
+	// Only adca1_isr (INTx1) may preempt the position loop
+	SavedPIEIER1 = PieCtrlRegs.PIEIER1.all;
+	IER |= M_INT1;
+	IER &= M_INT1;
+	PieCtrlRegs.PIEIER1.all &= 0x0001;
+	PieCtrlRegs.PIEACK.all = PIEACK_GROUP1;
+	asm(" NOP");
+	EINT;
+#endif
+#if ADC_DMA
+	ReadAdcDma();
+#else
+	ReadCurrents(&Isr.Currents, &Isr.Ia, &Isr.Ib);
+#endif
+	UpdatePosition(&Isr.Position, -(long)EQep1Regs.QPOSCNT); // Position in Counts 40000(counts)=2pi(rad)
+	Isr.Theta = CalcPosition(&Isr.Position);
 	//////////////////////////////////////////////////						//////////////////////////////////////////////////
 	//////////////////////////////////////////////////		Controller		//////////////////////////////////////////////////
 	//////////////////////////////////////////////////						//////////////////////////////////////////////////
-	ThetaT = Theta-ThetaD;
-	DThetaT = DTheta-DThetaD;
-	sum = 0;
-	for (i=0; i<N; i++){
-		sum = sum+(gammakP[i]*C[i]+gammakA[i]*S[i]);
-	}
-	Tau = -Kp*ThetaT-Kd*DThetaT+sum+J*DDThetaD;
-	IaD = -Tau*seno*kmI;
-	IbD = Tau*cose*kmI;
-	IaT = Ia-IaD;
-	IbT = Ib-IbD;
-	Sigma2D = -Gamma2*IaT*Tau*DTheta*cose;
-	Sigma5D = -Gamma5*IbT*Tau*DTheta*seno;
-	Sigma2 = CalcIntSigma2(Sigma2D)*Tau*DTheta;
-	Sigma5 = CalcIntSigma5(Sigma5D)*Tau*DTheta;
-	sum1 = 0;
-	sum2 = 0;
-	for (i=0; i<N; i++){
-		aux1 = gammakAD[i]*S[i]+gammakA[i]*(i+1)*np*DTheta*C[i];
-		aux2 = gammakPD[i]*C[i]+gammakP[i]*(i+1)*np*DTheta*S[i];
-		aux3 = gammakPD[i]*cose-gammakP[i]*Nr*DTheta*seno;
-		sum1 = sum1+(aux1+aux2);
-		sum2 = sum2+(aux1+aux3);
-	}
-	ha = -L*kmI*(sum1+J*DDDThetaD)*seno;
-	hb = L*kmI*(sum2+J*DDDThetaD)*cose;
-	if (TEST == 1){
-		Va = -sin(100*time)*Vmax; // 1500
-		Vb = cos(100*time)*Vmax;
-	}
-	else{
-		Va = -AlphaA*IaT+Sigma2*cose+R*IaD-km*DThetaD*seno+ha;
-		Vb = -AlphaB*IbT+Sigma5*seno+R*IbD+km*DThetaD*cose+hb;
-	}
-	foo = gamma*ThetaT+DThetaT-L*Kd*JkmI*IaT*seno+L*Kd*JkmI*IbT*cose;
-	for (i=0; i<N; i++){
-		gammakPD[i] = -GammakP*foo*C[i];
-		gammakAD[i] = -GammakA*foo*S[i];
-		gammakP[i] = gammakP[i]+gammakPD[i]*Ts;
-		gammakA[i] = gammakA[i]+gammakAD[i]*Ts;
-	}
+	In.Tooth = Isr.Position.Tooth;
+	In.Pole = Isr.Position.Pole;
+#if CONTROL_MATH == CONTROL_IQ
+	In.Theta = CalcPositionIQ(&Isr.Position);
+	In.Ia = FloatToIQ(Isr.Ia);
+	In.Ib = FloatToIQ(Isr.Ib);
+	StepControllerIQ(&Isr.ControllerIQ, &In, &Out);
+	Isr.Va = _IQtoF(Out.Va);
+	Isr.Vb = _IQtoF(Out.Vb);
+#elif CONTROL_MATH == CONTROL_SPLIT
+	In.Theta = Isr.Theta;
+	In.Ia = Isr.Ia;
+	In.Ib = Isr.Ib;
+	StepPositionLoop(&Isr.Controller, &In, &Setpoint);
+	PublishSetpoint(&Isr.Setpoint, &Setpoint);
+	DINT;
+	PieCtrlRegs.PIEIER1.all = SavedPIEIER1;
+#else
+	In.Theta = Isr.Theta;
+	In.Ia = Isr.Ia;
+	In.Ib = Isr.Ib;
+	StepController(&Isr.Controller, &In, &Out);
+	Isr.Va = Out.Va;
+	Isr.Vb = Out.Vb;
+#endif
 	//////////////////////////////////////////////////						//////////////////////////////////////////////////
 	//////////////////////////////////////////////////  Controller Output   //////////////////////////////////////////////////
 	//////////////////////////////////////////////////						//////////////////////////////////////////////////
-	if (time>=tf){
+	if (ControllerTime()>=CTRL_TF){
+#if CONTROL_MATH == CONTROL_SPLIT
+		PieCtrlRegs.PIEIER1.bit.INTx1 = 0; // The current loop stops writing the PWMs
+		EALLOW;
+		EPwm7Regs.ETSEL.bit.SOCAEN = 0;
+		EDIS;
+#endif
 		GpioDataRegs.GPASET.bit.GPIO15 = 1;
 		GpioDataRegs.GPASET.bit.GPIO17 = 1;
 		SetPWMA(0);
@@ -404,95 +575,61 @@ __interrupt void cpu_timer0_isr(void){
 		StopCpuTimer0();
 		asm(" ESTOP0");
 	}
+#if CONTROL_MATH != CONTROL_SPLIT
 	else{
-		SetPWMA(Va);
-		SetPWMB(Vb);
+		SetPWMA(Isr.Va);
+		SetPWMB(Isr.Vb);
 	}
+#endif
+	PROFILE_MARK(PROFILE_PWM);
 	//////////////////////////////////////////////////						//////////////////////////////////////////////////
 	//////////////////////////////////////////////////     Data Arrays	    //////////////////////////////////////////////////
 	//////////////////////////////////////////////////						//////////////////////////////////////////////////
-	if (load == 0){
-		ThetaArray[index] = Theta;
-		DThetaArray[index] = DTheta;
-		IaArray[index] = Ia;
-		IbArray[index] = Ib;
-		VaArray[index] = Va;
-		VbArray[index++] = Vb;
-		load++;
-	}
-	else {load = 0;}
+	LogSample();
 	GpioDataRegs.GPATOGGLE.bit.GPIO13 = 1;
+	PROFILE_END();
 	PieCtrlRegs.PIEACK.all = PIEACK_GROUP1;
 }
 
-float CalcSpeed(float T){
-	static float Theta_1=0, Theta_2=0, DTheta_1=0, DTheta_2=0;
-	float DTheta=0;
-	DTheta = 10*T-20*Theta_1+10*Theta_2+1.99*DTheta_1-0.99*DTheta_2;
-	Theta_2 = Theta_1;
-	Theta_1 = T;
-	DTheta_2 = DTheta_1;
-	DTheta_1 = DTheta;
-	return DTheta;
-}
-
-float CalcPosition(void){
-	long Counts=0;
-	float T=0;
-	Counts = -EQep1Regs.QPOSCNT; // Position in Counts 40000(counts)=2pi(rad)
-	T = Counts*0.0001570796327L; // Position in Rad
-	return T;
-}
-
-float CalcPosDesired(float t){
-	float foo=0, trajectory=0;
-	foo = t*t*t;
-	//trajectory = foo*((0.00037699L*t*t)-(0.0094248L*t)+0.062832L); //Desired Position (trajectory)
-	//trajectory = foo*((0.00075398223686L*t*t)-(0.018849555921539L*t)+0.125663706143592L);
-	trajectory = foo*((0.001884955592154L*t*t)-(0.047123889803847L*t)+0.314159265358979L);
-	return trajectory;
-}
-
-float CalcSpeedDesired(float trajectory){
-	static float pastTrajectory=0;
-	float DTrajectory=0;
-	DTrajectory = (trajectory-pastTrajectory)*iTs; //Speed in rad/s
-	pastTrajectory = trajectory;
-	return DTrajectory;
-}
-
-float CalcAcelDesired(float Speed){
-	static float Speed_1=0, Speed_2=0, DSpeed_1=0, DSpeed_2=0;
-	float DSpeed=0;
-	DSpeed = 10*Speed-20*Speed_1+10*Speed_2+1.99*DSpeed_1-0.99*DSpeed_2;
-	Speed_2 = Speed_1;
-	Speed_1 = Speed;
-	DSpeed_2 = DSpeed_1;
-	DSpeed_1 = DSpeed;
-	return DSpeed;
-}
-
-float CalcDAcelDesired(float Acel){
-	static float Acel_1=0, Acel_2=0, DAcel_1=0, DAcel_2=0;
-	float DAcel=0;
-	DAcel = 10*Acel-20*Acel_1+10*Acel_2+1.99*DAcel_1-0.99*DAcel_2;
-	Acel_2 = Acel_1;
-	Acel_1 = Acel;
-	DAcel_2 = DAcel_1;
-	DAcel_1 = DAcel;
-	return DAcel;
-}
-
-float CalcIntSigma2(float SigmaD){
-	static float Sigma=0; //SigmaD_1=0;
-	Sigma = Sigma+(SigmaD)*Ts;//*0.5L (SigmaD+SigmaD_1)
-	//SigmaD_1 = SigmaD;
-	return Sigma;
+#if CONTROL_MATH == CONTROL_CLA
+// Runs once Task1 has written the PWMs: logs that tick and hands the CLA the
+// trajectory of the next one, which it needs within Ts
+__interrupt void cla1_task1_isr(void){
+	PROFILE_START();
+	Isr.Theta = ClaState.Theta;
+	Isr.Ia = ClaState.Ia;
+	Isr.Ib = ClaState.Ib;
+	Isr.Va = ClaState.Va;
+	Isr.Vb = ClaState.Vb;
+	if (ControllerTime()>=CTRL_TF){
+		PieCtrlRegs.PIEIER11.bit.INTx1 = 0;
+		ClaInputs.Stop = 1;
+		Cla1ForceTask1andWait(); // Both phases to 0 V
+		EALLOW;
+		EPwm1Regs.ETSEL.bit.SOCAEN = 0;
+		EDIS;
+		asm(" ESTOP0");
+	}
+	else{
+		PublishTrajectory(&Isr.Controller);
+	}
+	PROFILE_MARK(PROFILE_SENSING);
+	LogSample();
+	GpioDataRegs.GPATOGGLE.bit.GPIO13 = 1;
+	PROFILE_END();
+	PieCtrlRegs.PIEACK.all = PIEACK_GROUP11;
 }
+#endif
 
-float CalcIntSigma5(float SigmaD){
-	static float Sigma=0; //SigmaD_1=0;
-	Sigma = Sigma+(SigmaD)*Ts;//*0.5L
-	// SigmaD_1 = SigmaD;
-	return Sigma;
+// One SVArray sample every RESULTS_DECIMATION ticks, from the globals of the tick
+void LogSample(void){
+	if (Isr.load == 0 && Isr.index < RESULTS_BUFFER_SIZE){
+		ThetaArray[Isr.index] = Isr.Theta;
+		DThetaArray[Isr.index] = ControllerDTheta();
+		IaArray[Isr.index] = Isr.Ia;
+		IbArray[Isr.index] = Isr.Ib;
+		VaArray[Isr.index] = Isr.Va;
+		VbArray[Isr.index++] = Isr.Vb;
+	}
+	if (++Isr.load >= RESULTS_DECIMATION) {Isr.load = 0;}
 }
@@ -0,0 +1,73 @@
+//###########################################################################
+// FILE:   pm_stepper_profile.c
+// TITLE:  Section cycle profiler of cpu_timer0_isr
+//###########################################################################
+
+#include "F28x_Project.h"     // Device Headerfile and Examples Include File
+#include <string.h>
+#include "pm_stepper_profile.h"
+
+// Flash build: the boundaries run from RAM with the ISR (28377S_FLASH_lnk.cmd)
+#ifdef _FLASH
+#pragma CODE_SECTION(ProfileStart, "ramfuncs")
+#pragma CODE_SECTION(ProfileMark, "ramfuncs")
+#pragma CODE_SECTION(AddSample, "ramfuncs")
+#pragma CODE_SECTION(ProfileEnd, "ramfuncs")
+#endif
+
+struct PROFILE Profile;
+static Uint32 Stamp[PROFILE_ISR];	// Timer1 at ISR entry [0] and at the end of each section
+static Uint32 Latency;
+
+// Call after ConfigCpuTimer(&CpuTimer0, ...): Timer1 keeps the PRD/TPR of InitCpuTimers
+void InitProfile(void){
+	int i;
+	memset(&Profile, 0, sizeof(Profile));
+	for (i=0; i<PROFILE_SECTIONS; i++) Profile.Section[i].Min = 0xFFFFFFFF;
+	Profile.TimerHz = (Uint32)(CpuTimer0.CPUFreqInMHz*1000000L);
+	Profile.PeriodCycles = (CpuTimer0Regs.PRD.all+1)*(CpuTimer0Regs.TPR.bit.TDDR+1);
+	CpuTimer1Regs.TCR.bit.TRB = 1;
+	CpuTimer1Regs.TCR.bit.TSS = 0;
+	// Two back-to-back boundaries cost what one adds to a section
+	ProfileMark(PROFILE_SENSING);
+	ProfileMark(PROFILE_TRIG);
+	Profile.Overhead = Stamp[PROFILE_SENSING]-Stamp[PROFILE_TRIG];
+	Profile.Magic = PROFILE_MAGIC;
+}
+
+void ProfileStart(void){
+	Stamp[0] = CpuTimer1Regs.TIM.all;
+	// Timer0 reloaded from PRD when it raised the interrupt
+	Latency = (CpuTimer0Regs.PRD.all-CpuTimer0Regs.TIM.all)*(CpuTimer0Regs.TPR.bit.TDDR+1);
+}
+
+void ProfileMark(int Section){
+	Stamp[Section] = CpuTimer1Regs.TIM.all;
+}
+
+static void AddSample(struct PROFILE_SECTION *s, Uint32 Cycles){
+	int k;
+	s->Count++;
+	s->Sum += Cycles;
+	if (Cycles < s->Min) s->Min = Cycles;
+	if (Cycles > s->Max) s->Max = Cycles;
+	// Double the bin width until the sample fits, merging bins pairwise
+	while ((Cycles >> s->BinShift) >= PROFILE_BINS){
+		for (k=0; k<PROFILE_BINS/2; k++) s->Hist[k] = s->Hist[2*k]+s->Hist[2*k+1];
+		for (; k<PROFILE_BINS; k++) s->Hist[k] = 0;
+		s->BinShift++;
+	}
+	s->Hist[Cycles >> s->BinShift]++;
+}
+
+// Timer1 counts down, so each section is the earlier stamp minus the later one
+void ProfileEnd(void){
+	int i;
+	Stamp[PROFILE_LOGGING] = CpuTimer1Regs.TIM.all;
+	if (Profile.Magic != PROFILE_MAGIC) return;
+	AddSample(&Profile.Section[PROFILE_LATENCY], Latency);
+	for (i=PROFILE_SENSING; i<=PROFILE_LOGGING; i++){
+		AddSample(&Profile.Section[i], Stamp[i-1]-Stamp[i]);
+	}
+	AddSample(&Profile.Section[PROFILE_ISR], Stamp[0]-Stamp[PROFILE_LOGGING]);
+}
@@ -0,0 +1,83 @@
+//###########################################################################
+// FILE:   pm_stepper_profile.h
+// TITLE:  Section cycle profiler of cpu_timer0_isr
+//###########################################################################
+// CPU Timer1 runs free at SYSCLK and is stamped at every section boundary
+// of the control tick; CPU Timer2 stays free. The ISR entry latency is read
+// from Timer0 itself. Per section the firmware keeps count, min, max, sum
+// and a 16-bin histogram that widens itself (bins of 2^BinShift cycles) in
+// the global Profile, all 32/64-bit words so a Memory Browser save of it
+// can be read on the host by pm_stepper_profile.
+// The bookkeeping of ProfileEnd() runs after the last stamp and is not in
+// any section; each boundary adds Overhead cycles to the section it ends.
+// Off by default, leaving Timer1 and the ISR untouched; the Profile build
+// configuration (Debug with -DPROFILE_ENABLE=1) turns it on.
+//###########################################################################
+
+#ifndef PM_STEPPER_PROFILE_H
+#define PM_STEPPER_PROFILE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE 0
+#endif
+
+#define PROFILE_MAGIC 0x50524F46UL	// "PROF", set once ProfileInit has run
+#define PROFILE_BINS 16
+
+// Sections, in the order they run
+#define PROFILE_LATENCY 0			// Timer0 interrupt to ISR entry
+#define PROFILE_SENSING 1			// Current signs, position, speed and reference trajectory
+#define PROFILE_TRIG 2				// sin/cos of the Nr and k*np harmonics
+#define PROFILE_CONTROLLER 3		// Torque, currents and Va/Vb
+#define PROFILE_ADAPTATION 4		// Torque ripple estimator update
+#define PROFILE_PWM 5				// Saturation, direction GPIOs and CMPA
+#define PROFILE_LOGGING 6			// SVArray logging and the GPIO13 toggle
+#define PROFILE_ISR 7				// ISR entry to the end of logging
+#define PROFILE_SECTIONS 8
+
+struct PROFILE_SECTION {
+	uint32_t Count;						// Samples
+	uint32_t Min, Max;					// Cycles
+	uint32_t BinShift;					// Hist[k] counts cycles in [k, k+1)*2^BinShift
+	uint64_t Sum;						// Cycles, for the mean
+	uint32_t Hist[PROFILE_BINS];
+};
+
+struct PROFILE {
+	uint32_t Magic;
+	uint32_t TimerHz;					// Timer1 counts per second (SYSCLK)
+	uint32_t PeriodCycles;				// Timer1 counts per control tick
+	uint32_t Overhead;					// Counts a boundary adds to its section
+	struct PROFILE_SECTION Section[PROFILE_SECTIONS];
+};
+
+#define PROFILE_WORDS (sizeof(struct PROFILE)/sizeof(uint32_t))	// 32-bit words in Profile
+
+#if PROFILE_ENABLE
+#define PROFILE_START() ProfileStart()
+#define PROFILE_MARK(Section) ProfileMark(Section)
+#define PROFILE_END() ProfileEnd()
+#else
+#define PROFILE_START()
+#define PROFILE_MARK(Section)
+#define PROFILE_END()
+#endif
+
+extern struct PROFILE Profile;
+
+void InitProfile(void);
+void ProfileStart(void);
+void ProfileMark(int Section);
+void ProfileEnd(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end of PM_STEPPER_PROFILE_H definition
@@ -0,0 +1,174 @@
+//###########################################################################
+// FILE:   pm_stepper_trig.c
+// TITLE:  Compile-time selectable sin/cos for the control law
+//###########################################################################
+
+#include "pm_stepper_trig.h"
+
+// Flash build: the control tick's sin/cos run from RAM (28377S_FLASH_lnk.cmd)
+#ifdef _FLASH
+#pragma CODE_SECTION(Frac, "ramfuncs")
+#pragma CODE_SECTION(PolySinPu, "ramfuncs")
+#pragma CODE_SECTION(PolySin, "ramfuncs")
+#pragma CODE_SECTION(PolyCos, "ramfuncs")
+#pragma CODE_SECTION(CalcHarmonics, "ramfuncs")
+#endif
+
+// Position within the turn, in [0, 1)
+static float Frac(float u){
+	long k = (long)u;
+	u = u-k;
+	if (u < 0) u = u+1;
+	return u;
+}
+
+#ifndef __TMS320C28XX_TMU__
+// SINPUF32/COSPUF32 only see the fractional part of the per-unit angle
+float TmuSinPu(float u){
+	return (float)sin(6.283185307179586*Frac(u));
+}
+
+float TmuCosPu(float u){
+	return (float)cos(6.283185307179586*Frac(u));
+}
+#endif
+
+// sin(2*pi*r) for r in [-0.5, 0.5]: fold to [-0.25, 0.25], then odd minimax
+static float PolySinPu(float r){
+	float r2;
+	if (r > 0.25f) r = 0.5f-r;
+	else if (r < -0.25f) r = -0.5f-r;
+	r2 = r*r;
+	return ((((39.53670502f*r2-76.54978180f)*r2+81.60100555f)*r2-41.34165573f)*r2+6.283185005f)*r;
+}
+
+float PolySin(float x){
+	float u = x*TRIG_INV_2PI;
+	return PolySinPu(u-(long)(u+((u >= 0) ? 0.5f : -0.5f)));
+}
+
+float PolyCos(float x){
+	float u = x*TRIG_INV_2PI+0.25f;
+	return PolySinPu(u-(long)(u+((u >= 0) ? 0.5f : -0.5f)));
+}
+
+// S[k-1] = sin(k*x), C[k-1] = cos(k*x): (C+jS) is rotated by (c1+j*s1) per
+// harmonic. Rounding grows the magnitude linearly with k, so every
+// TRIG_RENORM harmonics one Newton step of 1/sqrt pulls it back to 1.
+void CalcHarmonics(float x, float *S, float *C, int Count){
+	float s1 = TrigSin(x), c1 = TrigCos(x), g;
+	int k;
+	if (Count <= 0) return;
+	S[0] = s1;
+	C[0] = c1;
+	for (k=1; k<Count; k++){
+		S[k] = S[k-1]*c1+C[k-1]*s1;
+		C[k] = C[k-1]*c1-S[k-1]*s1;
+		if ((k & (TRIG_RENORM-1)) == 0){
+			g = 1.5f-0.5f*(S[k]*S[k]+C[k]*C[k]);
+			S[k] = S[k]*g;
+			C[k] = C[k]*g;
+		}
+	}
+}
+
+// The tables cost RAM, so the target only has those of the selected backend
+#if TRIG_BACKEND == TRIG_TABLE || !defined(__TMS320C28XX__)
+#define TRIG_HAVE_TABLE
+static float SinTable[TRIG_TABLE_SIZE+1];
+#endif
+#if TRIG_BACKEND == TRIG_COUNTS || !defined(__TMS320C28XX__)
+#define TRIG_HAVE_COUNTS
+#ifdef __TMS320C28XX__
+#pragma DATA_SECTION(ToothTable, "TrigTables")
+#pragma DATA_SECTION(PoleTable, "TrigTables")
+#endif
+static float ToothTable[TRIG_TOOTH_COUNTS/4+1];	// sin over the first quarter of a tooth pitch
+static float PoleTable[TRIG_POLE_COUNTS/4+1];	// ... and of a pole pitch
+#endif
+
+static void FillQuarter(float *Table, long Period){
+	long k;
+	for (k=0; k<=Period/4; k++){
+		Table[k] = (float)sin(k*(6.283185307179586/Period));
+	}
+}
+
+void InitTrigTable(void){
+#ifdef TRIG_HAVE_TABLE
+	int k;
+	for (k=0; k<=TRIG_TABLE_SIZE; k++){
+		SinTable[k] = (float)sin(k*(6.283185307179586/TRIG_TABLE_SIZE));
+	}
+#endif
+#ifdef TRIG_HAVE_COUNTS
+	FillQuarter(ToothTable, TRIG_TOOTH_COUNTS);
+	FillQuarter(PoleTable, TRIG_POLE_COUNTS);
+#endif
+}
+
+#ifdef TRIG_HAVE_TABLE
+#ifdef _FLASH
+#pragma CODE_SECTION(TableSinPu, "ramfuncs")
+#pragma CODE_SECTION(TableSin, "ramfuncs")
+#pragma CODE_SECTION(TableCos, "ramfuncs")
+#endif
+
+static float TableSinPu(float u){
+	float p = Frac(u)*TRIG_TABLE_SIZE, f;
+	int i = (int)p;
+	f = p-i;
+	if (i >= TRIG_TABLE_SIZE) i = 0, f = 0;	// Frac(u) rounds to 1.0f for tiny u < 0
+	return SinTable[i]+f*(SinTable[i+1]-SinTable[i]);
+}
+
+float TableSin(float x){
+	return TableSinPu(x*TRIG_INV_2PI);
+}
+
+float TableCos(float x){
+	return TableSinPu(x*TRIG_INV_2PI+0.25f);
+}
+#endif
+
+#ifdef TRIG_HAVE_COUNTS
+#ifdef _FLASH
+#pragma CODE_SECTION(QuarterSin, "ramfuncs")
+#pragma CODE_SECTION(CalcToothSinCos, "ramfuncs")
+#pragma CODE_SECTION(CalcPoleHarmonics, "ramfuncs")
+#endif
+
+// sin(2*pi*k/Period) for k in [0, Period) from the first quarter wave
+static float QuarterSin(const float *Table, long Period, long k){
+	float v;
+	int Negative = 0;
+	if (k >= Period/2){
+		k = k-Period/2;
+		Negative = 1;
+	}
+	if (k > Period/4) k = Period/2-k;
+	v = Table[k];
+	return Negative ? -v : v;
+}
+
+// sin/cos(Nr*Theta) for Tooth = Theta*Nenc/(2*pi) modulo TRIG_TOOTH_COUNTS
+void CalcToothSinCos(int Tooth, float *Sin, float *Cos){
+	long k = Tooth;
+	long q = k+TRIG_TOOTH_COUNTS/4;
+	*Sin = QuarterSin(ToothTable, TRIG_TOOTH_COUNTS, k);
+	*Cos = QuarterSin(ToothTable, TRIG_TOOTH_COUNTS, (q >= TRIG_TOOTH_COUNTS) ? q-TRIG_TOOTH_COUNTS : q);
+}
+
+// S[i] = sin((i+1)*np*Theta), C[i] = cos(...): the index steps by the phase within the pole pitch
+void CalcPoleHarmonics(int Pole, float *S, float *C, int Count){
+	long Step = Pole, k = 0, q;
+	int i;
+	for (i=0; i<Count; i++){
+		k = k+Step;
+		if (k >= TRIG_POLE_COUNTS) k = k-TRIG_POLE_COUNTS;
+		q = k+TRIG_POLE_COUNTS/4;
+		S[i] = QuarterSin(PoleTable, TRIG_POLE_COUNTS, k);
+		C[i] = QuarterSin(PoleTable, TRIG_POLE_COUNTS, (q >= TRIG_POLE_COUNTS) ? q-TRIG_POLE_COUNTS : q);
+	}
+}
+#endif
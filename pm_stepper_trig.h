@@ -0,0 +1,93 @@
+//###########################################################################
+// FILE:   pm_stepper_trig.h
+// TITLE:  Compile-time selectable sin/cos for the control law
+//###########################################################################
+// Each tick StepController() needs the sin/cos of the tooth angle Nr*Theta
+// and of the first HARMONIC_COUNT harmonics of the pole angle np*Theta.
+// Build with -DTRIG_BACKEND=<n> to choose where they come from:
+//   TRIG_RTS    sin()/cos() of the run-time library (rts2800_fpu32)
+//   TRIG_TMU    TMU SINPUF32/COSPUF32 (needs --tmu_support=tmu0); on the
+//               host a model with the same per-unit argument
+//   TRIG_POLY   degree 9 minimax polynomial after per-unit reduction
+//   TRIG_TABLE  TRIG_TABLE_SIZE-point table with linear interpolation,
+//               filled by InitTrigTable() (called once at start-up)
+//   TRIG_COUNTS no trig in the tick: CalcToothSinCos and CalcPoleHarmonics
+//               look the tooth and pole phases, in counts, up in
+//               quarter-wave tables of one tooth and one pole pitch, filled
+//               by InitTrigTable(). Elsewhere TrigSin()/TrigCos() are those
+//               of TRIG_RTS. On the target the tables (2904 words) go to
+//               section TrigTables, placed in RAMD0_1 by the Flash link
+//               and in RAMGS0_GS15 by the Debug (RAM) link.
+// All but TRIG_RTS scale the angle to turns in float first, so their
+// error grows with |x|; StepController only passes angles in [0, 2*pi)
+// (TRIG_TOOTH_RAD, TRIG_POLE_RAD times the phase). See
+// pm_stepper_trig_bench for cost and error over the encoder range.
+// CalcHarmonics() builds the sin/cos of k*x, k = 1..Count, from a single
+// TrigSin/TrigCos pair by angle addition, so each further harmonic costs
+// four multiplies and two adds instead of two trig calls.
+//###########################################################################
+
+#ifndef PM_STEPPER_TRIG_H
+#define PM_STEPPER_TRIG_H
+
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRIG_RTS 0
+#define TRIG_TMU 1
+#define TRIG_POLY 2
+#define TRIG_TABLE 3
+#define TRIG_COUNTS 4
+
+#ifndef TRIG_BACKEND
+#define TRIG_BACKEND TRIG_RTS
+#endif
+
+#define TRIG_TABLE_SIZE 512			// Points per turn, a power of 2
+#define TRIG_INV_2PI 0.159154943f	// Turns per radian
+#define TRIG_RENORM 8				// Harmonics between renormalizations of CalcHarmonics, a power of 2
+#define TRIG_TOOTH_COUNTS 800		// Encoder counts per period of Nr*Theta
+#define TRIG_POLE_COUNTS 5000		// Encoder counts per period of np*Theta
+#define TRIG_TOOTH_RAD 0.00785398163f	// Radians of Nr*Theta per count
+#define TRIG_POLE_RAD 0.00125663706f	// Radians of np*Theta per count
+
+// TMU per-unit intrinsics on the C28x, a host model elsewhere
+#ifdef __TMS320C28XX_TMU__
+#define TmuSinPu(u) __sinpuf32(u)
+#define TmuCosPu(u) __cospuf32(u)
+#else
+float TmuSinPu(float u);
+float TmuCosPu(float u);
+#endif
+
+float PolySin(float x);
+float PolyCos(float x);
+float TableSin(float x);
+float TableCos(float x);
+void InitTrigTable(void);
+void CalcHarmonics(float x, float *S, float *C, int Count);
+void CalcToothSinCos(int Tooth, float *Sin, float *Cos);
+void CalcPoleHarmonics(int Pole, float *S, float *C, int Count);
+
+#if TRIG_BACKEND == TRIG_TMU
+#define TrigSin(x) TmuSinPu((x)*TRIG_INV_2PI)
+#define TrigCos(x) TmuCosPu((x)*TRIG_INV_2PI)
+#elif TRIG_BACKEND == TRIG_POLY
+#define TrigSin(x) PolySin(x)
+#define TrigCos(x) PolyCos(x)
+#elif TRIG_BACKEND == TRIG_TABLE
+#define TrigSin(x) TableSin(x)
+#define TrigCos(x) TableCos(x)
+#else
+#define TrigSin(x) sin(x)
+#define TrigCos(x) cos(x)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // end of PM_STEPPER_TRIG_H definition